@@ -4,6 +4,15 @@
 
 const int toon_color_lvls = 5;
 const float toon_scale_factor = 1.0 / toon_color_lvls;
+
+/*
+*	The lighting models are specialization constants, which are fixed when the pipeline is created, so the driver compiles out the models which
+*	aren't used: there is a pipeline for each combination of models, and the application switches between them.
+*	DIFFUSE_MODEL : 0 is used for Lambert diffuse, 1 is used for Toon diffuse
+*	SPECULAR_MODEL : 0 is used for Blinn specular, 1 is used for Toon specular, 2 is used for Phong specular
+*/
+layout (constant_id = 0) const int DIFFUSE_MODEL = 0;
+layout (constant_id = 1) const int SPECULAR_MODEL = 0;
 /*
 *	First implementation of the fragment shader, the idea is to start from something simple and update it as i progress.
 *	For now the idea I have for the illumination of the pinball's table is to implement 6 to 8 point lights at the border of the table.
@@ -68,13 +77,6 @@ layout (set = 0, binding = 1) uniform GlobalUniformBufferObject {
 	vec3 definingDirection; //Direction accounted for the computation of the ambient color
 
 	vec3 eyePosition; // vector of the coordinates of the point from which we are seeing the scene
-
-	 /*
-	 *	This vector is used to decide which light functions to use:
-	 *	functionDecider.x : 0.0 is used for Lambert diffuse, 1.0 is used for Toon diffuse
-	 *	functionDecider.y : 0.0 is used for Blinn specular, 1.0 is used for Toon specular, 2.0 is used for Phong specular
-	 */
-	vec2 functionDecider;
 } gubo;
 
 // Function to create the lambert diffuse vector
@@ -385,10 +387,10 @@ void main() {
 	mat3 lightDecay3to5 = create_lights_decay_colors(1);
 	mat3 auxLightDecay = create_lights_decay_colors(2);
 
-	if (gubo.functionDecider.x == 0.0) {
+	if (DIFFUSE_MODEL == 0) {
 		//	Lambert diffuse
 		diffuseBRDF = create_Lambert_diffuse(normal, diffuseColor, lightDecay0to2, lightDecay3to5, auxLightDecay);
-	} else if (gubo.functionDecider.x == 1.0) {
+	} else if (DIFFUSE_MODEL == 1) {
 		//  Toon diffuse (thr to define!)
 		diffuseBRDF = create_Toon_diffuse(normal, diffuseColor, 0.5f, lightDecay0to2, lightDecay3to5, auxLightDecay);
 	}
@@ -413,14 +415,14 @@ void main() {
 	mat3 specularColors3to5 = create_specular_colors(1);
 	mat3 auxSpecularColors = create_specular_colors(2);
 	
-	if (gubo.functionDecider.y == 0.0) {
+	if (SPECULAR_MODEL == 0) {
 		//	Blinn specular
 		float blinnExponent = 100.0f; // exponent decided
 		specularBRDF = create_Blinn_specular(viewDirection, normal, directSpecularColor, specularColors0to2, specularColors3to5, auxSpecularColors, blinnExponent);
-	} else if (gubo.functionDecider.y == 1.0) {
+	} else if (SPECULAR_MODEL == 1) {
 		//	Toon specular 
 		specularBRDF = create_Toon_specular(normal, viewDirection, directSpecularColor, specularColors0to2, specularColors3to5, auxSpecularColors, 0.98f);
-	} else if (gubo.functionDecider.y == 2.0) {
+	} else if (SPECULAR_MODEL == 2) {
 		//	Phong specular
 		float phongExponent = 100.0f;
 		specularBRDF = create_Phong_specular(normal, viewDirection, specularColors0to2, specularColors3to5, directSpecularColor, auxSpecularColors, phongExponent);
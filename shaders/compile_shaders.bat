@@ -1,8 +1,14 @@
-%VULKAN_SDK%\Bin\glslc.exe .\TestFrag.frag -o .\TestFrag.spv
-%VULKAN_SDK%\Bin\glslc.exe .\TestVert.vert -o .\TestVert.spv
+%VULKAN_SDK%\Bin\glslc.exe .\TestFrag.frag -o .\TestFrag.spv || exit /b 1
+%VULKAN_SDK%\Bin\spirv-val.exe .\TestFrag.spv || exit /b 1
+%VULKAN_SDK%\Bin\glslc.exe .\TestVert.vert -o .\TestVert.spv || exit /b 1
+%VULKAN_SDK%\Bin\spirv-val.exe .\TestVert.spv || exit /b 1
 
-%VULKAN_SDK%\Bin\glslc.exe .\VertexShader.vert -o .\VertexShaderVert.spv
-%VULKAN_SDK%\Bin\glslc.exe .\FragmentShader.frag -o .\FragmentShaderFrag.spv
+%VULKAN_SDK%\Bin\glslc.exe .\VertexShader.vert -o .\VertexShaderVert.spv || exit /b 1
+%VULKAN_SDK%\Bin\spirv-val.exe .\VertexShaderVert.spv || exit /b 1
+%VULKAN_SDK%\Bin\glslc.exe .\FragmentShader.frag -o .\FragmentShaderFrag.spv || exit /b 1
+%VULKAN_SDK%\Bin\spirv-val.exe .\FragmentShaderFrag.spv || exit /b 1
 
-%VULKAN_SDK%\Bin\glslc.exe .\BackgroundBoxShader.vert -o .\BackgroundBoxShaderVert.spv
-%VULKAN_SDK%\Bin\glslc.exe .\BackgroundBoxShader.frag -o .\BackgroundBoxShaderFrag.spv
\ No newline at end of file
+%VULKAN_SDK%\Bin\glslc.exe .\BackgroundBoxShader.vert -o .\BackgroundBoxShaderVert.spv || exit /b 1
+%VULKAN_SDK%\Bin\spirv-val.exe .\BackgroundBoxShaderVert.spv || exit /b 1
+%VULKAN_SDK%\Bin\glslc.exe .\BackgroundBoxShader.frag -o .\BackgroundBoxShaderFrag.spv || exit /b 1
+%VULKAN_SDK%\Bin\spirv-val.exe .\BackgroundBoxShaderFrag.spv || exit /b 1
\ No newline at end of file
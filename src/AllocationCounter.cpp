@@ -0,0 +1,74 @@
+#include "AllocationCounter.h"
+
+#ifdef VULKAN_COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+
+//the global operator new and delete are replaced so that each allocation is counted; the aligned versions are needed because std::malloc doesn't support extended alignments
+
+namespace {
+
+	void* allocate(std::size_t size) {
+		Vulkan::Utilities::AllocationCounter::count();
+		if (void* memory = std::malloc(size != 0 ? size : 1)) {
+			return memory;
+		}
+		throw std::bad_alloc{};
+	}
+
+
+	void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+		Vulkan::Utilities::AllocationCounter::count();
+		const auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+		void* memory = _aligned_malloc(size != 0 ? size : 1, align);
+#else
+		void* memory = std::aligned_alloc(align, (size + align - 1) / align * align); //the size must be a multiple of the alignment
+#endif
+		if (memory == nullptr) {
+			throw std::bad_alloc{};
+		}
+		return memory;
+	}
+
+
+	void deallocateAligned(void* memory) noexcept {
+#ifdef _WIN32
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+}
+
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { try { return allocate(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { try { return allocate(size); } catch (...) { return nullptr; } }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { try { return allocateAligned(size, alignment); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { try { return allocateAligned(size, alignment); } catch (...) { return nullptr; } }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(memory); }
+
+#endif
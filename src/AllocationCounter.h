@@ -0,0 +1,46 @@
+#ifndef VULKAN_ALLOCATIONCOUNTER
+#define VULKAN_ALLOCATIONCOUNTER
+
+#include <cstdint>
+
+
+namespace Vulkan::Utilities {
+
+	/**
+	 * @brief Counts the heap allocations (calls of operator new) of each thread, to check that a loop doesn't allocate once it is warmed up.
+	 * @details The allocations are counted only if VULKAN_COUNT_ALLOCATIONS is defined (the Debug configurations), in which case AllocationCounter.cpp replaces the global operator new; otherwise the count is always 0.
+	 *			Allocations made with malloc (e.g. by GLFW or by the Vulkan driver) are not counted.
+	 */
+	class AllocationCounter {
+	public:
+
+		static constexpr bool ENABLED =
+#ifdef VULKAN_COUNT_ALLOCATIONS
+			true;
+#else
+			false;
+#endif
+
+
+		/**
+		 * @brief Returns how many times the calling thread has called operator new since it started.
+		 */
+		static uint64_t getThreadAllocations() {
+			return threadAllocations;
+		}
+
+
+		//called by the replaced operator new
+		static void count() {
+			threadAllocations++;
+		}
+
+
+	private:
+		static inline thread_local uint64_t threadAllocations = 0;
+	};
+
+}
+
+
+#endif
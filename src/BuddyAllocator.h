@@ -0,0 +1,144 @@
+#ifndef VULKAN_BUDDYALLOCATOR
+#define VULKAN_BUDDYALLOCATOR
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+
+namespace Vulkan::Utilities {
+
+	/**
+	 * @brief A buddy allocator: it hands out ranges (nodes) of a memory it doesn't own, by splitting the memory in halves till a half is just large enough.
+	 * @details A node has a power of 2 size and starts at an offset multiple of its size, so any alignment up to the size of the node comes for free.
+	 *			When a node is freed and its buddy (the other half of the same parent) is free too, they are merged back into the parent, so the memory doesn't fragment.
+	 *			The price is that a request is rounded up to a power of 2.
+	 */
+	class BuddyAllocator {
+	public:
+
+		struct Node {
+			uint64_t offset;
+			uint64_t size;
+		};
+
+
+		/**
+		 * @param size The size of the memory, a power of 2.
+		 * @param minNodeSize The size of the smallest node, a power of 2: smaller requests are rounded up to it.
+		 */
+		BuddyAllocator(uint64_t size, uint64_t minNodeSize = 256) : size{ size }, minNodeSize{ std::min(minNodeSize, size) } {
+			if (!std::has_single_bit(size) || !std::has_single_bit(minNodeSize)) {
+				throw std::invalid_argument{ "The size and the minimum node size of a buddy allocator must be powers of 2" };
+			}
+			freeNodes.resize(std::countr_zero(size / this->minNodeSize) + 1);
+			freeNodes.back().insert(0);
+		}
+
+
+
+		/**
+		 * @brief Returns a node of at least size bytes, whose offset is a multiple of alignment (a power of 2), or nothing if there is no such free node.
+		 */
+		std::optional<Node> allocate(uint64_t size, uint64_t alignment = 1) {
+			const uint64_t nodeSize = std::max(minNodeSize, std::bit_ceil(std::max({ size, alignment, uint64_t{ 1 } })));
+			if (nodeSize > this->size) {
+				return std::nullopt;
+			}
+
+			//find the smallest free node which is large enough
+			const size_t order = getOrder(nodeSize);
+			size_t current = order;
+			while (current < freeNodes.size() && freeNodes[current].empty()) {
+				current++;
+			}
+			if (current == freeNodes.size()) {
+				return std::nullopt;
+			}
+
+			//split it till it is as small as the request, keeping the lower half and freeing the upper one
+			const uint64_t offset = *freeNodes[current].begin();
+			freeNodes[current].erase(freeNodes[current].begin());
+			while (current > order) {
+				current--;
+				freeNodes[current].insert(offset + (minNodeSize << current));
+			}
+
+			used += nodeSize;
+			return Node{ offset, nodeSize };
+		}
+
+
+		/**
+		 * @brief Gives back a node returned by allocate, merging it with its buddy as long as the buddy is free.
+		 */
+		void free(Node node) {
+			used -= node.size;
+			size_t order = getOrder(node.size);
+			uint64_t offset = node.offset;
+			while (order + 1 < freeNodes.size()) {
+				auto buddy = freeNodes[order].find(offset ^ (minNodeSize << order));
+				if (buddy == freeNodes[order].end()) {
+					break;
+				}
+				offset = std::min(offset, *buddy);
+				freeNodes[order].erase(buddy);
+				order++;
+			}
+			freeNodes[order].insert(offset);
+		}
+
+
+
+		uint64_t getSize() const {
+			return size;
+		}
+
+
+		/**
+		 * @brief Returns the bytes of the nodes in use (the requests rounded up to a power of 2).
+		 */
+		uint64_t getUsed() const {
+			return used;
+		}
+
+
+		bool isEmpty() const {
+			return used == 0;
+		}
+
+
+		/**
+		 * @brief Returns the size of the largest free node, which is the largest request allocate can satisfy.
+		 */
+		uint64_t getLargestFree() const {
+			for (size_t order = freeNodes.size(); order > 0; --order) {
+				if (!freeNodes[order - 1].empty()) {
+					return minNodeSize << (order - 1);
+				}
+			}
+			return 0;
+		}
+
+
+	private:
+
+		size_t getOrder(uint64_t nodeSize) const {
+			return std::countr_zero(nodeSize / minNodeSize);
+		}
+
+
+		const uint64_t size;
+		const uint64_t minNodeSize;
+		std::vector<std::set<uint64_t>> freeNodes; //the offsets of the free nodes of each order (the size of a node of order i is minNodeSize << i)
+		uint64_t used = 0;
+	};
+
+}
+
+
+#endif
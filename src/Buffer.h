@@ -3,10 +3,16 @@
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstring>
+#include <vector>
 
 #include "LogicalDevice.h"
 #include "PhysicalDevice.h"
 #include "VulkanException.h"
+#include "DirtyRanges.h"
+#include "MemoryAllocator.h"
+#include "Tracer.h"
 
 
 namespace Vulkan::Buffers { class Buffer; }
@@ -15,22 +21,25 @@ class Vulkan::Buffers::Buffer {
 public:
 
     template<std::same_as<VkMemoryPropertyFlagBits>... P>
-    Buffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size, int usage, P... requiredMemoryProperties) : virtualGpu{ virtualGpu }, size{ size } {
-        //create the buffer
-        createBuffer(virtualGpu, size, usage);
-
-        //find out the constraints about the real GPU memory to use for this buffer
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(+virtualGpu, buffer, &memRequirements);
+    Buffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size, int usage, P... requiredMemoryProperties) : Buffer(virtualGpu, realGpu, size, usage, static_cast<VkMemoryPropertyFlags>((0 | ... | requiredMemoryProperties)), 0) {}
 
-        //find which GPU memory to use
-        auto memIndex = findSuitableMemoryIndex(realGpu, memRequirements.memoryTypeBits, requiredMemoryProperties...);
 
-        //allocate the choosen memory
-        allocateMemory(memIndex, memRequirements.size);
+    /**
+     * @brief Creates a buffer in a memory which has all the required properties and, if the GPU has such a memory, all the preferred properties too.
+     */
+    Buffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size, int usage, VkMemoryPropertyFlags requiredMemoryProperties, VkMemoryPropertyFlags preferredMemoryProperties) : virtualGpu{ virtualGpu }, size{ size }, nonCoherentAtomSize{ realGpu.getProperties().limits.nonCoherentAtomSize } {
+        //create the buffer
+        createBuffer(virtualGpu, size, usage);
 
-        //associate the allocated memory with the created buffer
-        vkBindBufferMemory(+virtualGpu, buffer, bufferMemory, 0);
+        //get a range of a memory block from the allocator of the device, and associate it with the created buffer
+        try {
+            allocation = virtualGpu.getMemoryAllocator().allocateForBuffer(buffer, requiredMemoryProperties, preferredMemoryProperties);
+        }
+        catch (...) {
+            vkDestroyBuffer(+virtualGpu, buffer, nullptr);
+            throw;
+        }
+        memoryProperties = virtualGpu.getMemoryAllocator().getMemoryProperties(allocation);
     }
 
 
@@ -42,7 +51,7 @@ public:
 
     ~Buffer() {
         vkDestroyBuffer(+virtualGpu, buffer, nullptr);
-        vkFreeMemory(+virtualGpu, bufferMemory, nullptr);
+        virtualGpu.getMemoryAllocator().free(allocation);
     }
 
 
@@ -51,27 +60,63 @@ public:
     }
 
 
-    VkDeviceMemory& getBufferMemory() {
-        return bufferMemory;
+    const MemoryAllocator::Allocation& getAllocation() const {
+        return allocation;
     }
 
 
-    //Return the first index of a memory type on the GPU which is suitable for the resource we want to load onto the GPU. 
-    template<std::same_as< VkMemoryPropertyFlagBits>... P>
-    static uint32_t findSuitableMemoryIndex(const PhysicalDevice& realGpu, uint32_t suitableTypesBitmask, P... requiredMemoryProperties) {
-        //get the properties of the memory of the GPU
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(+realGpu, &memProperties);
-        auto requiredMemoryPropertiesMask = (requiredMemoryProperties | ...);
+    size_t getSize() const {
+        return size;
+    }
+
 
-        //for each memory type, check if it is suitable for what we want to do (i.e. this type is 1 in the suitableTypesBitmask and the properties of this type are a superset of requiredMemoryProperties)
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-            if ((suitableTypesBitmask & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & requiredMemoryPropertiesMask) == requiredMemoryPropertiesMask) {
-                return i;
-            }
+    /**
+     * @brief Copies size bytes to the buffer, at offset, through the persistent mapping (see mapPersistently), so without calling the driver.
+     * @details If the memory isn't coherent, the written range is remembered and made visible to the GPU by the next flush.
+     */
+    void write(const void* data, size_t size, size_t offset) {
+        if (mapped == nullptr || offset + size > this->size) {
+            throw VulkanException{ "Failed to write to the buffer", mapped == nullptr ? "The buffer isn't mapped" : "The data goes past the end of the buffer" };
         }
+        memcpy(mapped + offset, data, size);
+        if (!isCoherent()) {
+            dirtyRanges.add(offset, size);
+        }
+    }
+
 
-        throw VulkanException{ "No suitable memory for the buffer" };
+    /**
+     * @brief Makes the writes since the last flush visible to the GPU, with a single vkFlushMappedMemoryRanges of the written ranges (merged, and aligned to nonCoherentAtomSize).
+     * @details If the memory is coherent there is nothing to flush.
+     */
+    void flush() {
+        if (dirtyRanges.empty()) {
+            return;
+        }
+        VULKAN_TRACE_ZONE("Buffer::flush");
+
+        flushRanges.clear(); //the vector keeps its capacity, so flushing every frame doesn't allocate
+        for (auto range : dirtyRanges.coalesce(nonCoherentAtomSize, allocation.size, FLUSH_MAX_GAP)) {
+            VkMappedMemoryRange flushRange{};
+            flushRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            flushRange.memory = allocation.memory;
+            flushRange.offset = allocation.offset + range.begin; //the allocator aligns the allocations of non coherent memory to nonCoherentAtomSize
+            flushRange.size = range.end - range.begin;
+            flushRanges.push_back(flushRange);
+        }
+        dirtyRanges.clear();
+
+        if (VkResult result = vkFlushMappedMemoryRanges(+virtualGpu, static_cast<uint32_t>(flushRanges.size()), flushRanges.data()); result != VK_SUCCESS) {
+            throw VulkanException{ "Failed to flush the buffer memory", result };
+        }
+    }
+
+
+    /**
+     * @brief Returns whether the writes of the CPU are visible to the GPU without flushing them.
+     */
+    bool isCoherent() const {
+        return (memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
     }
 
 
@@ -93,23 +138,24 @@ protected:
     }
 
 
-    //Allocate the required space on the GPU
-    void allocateMemory(uint32_t memoryIndex, VkDeviceSize sizeToAllocate) {
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = sizeToAllocate;
-        allocInfo.memoryTypeIndex = memoryIndex;
-
-        if (VkResult result = vkAllocateMemory(+virtualGpu, &allocInfo, nullptr, &bufferMemory); result != VK_SUCCESS) {
-            throw VulkanException{ "Failed to allocate buffer memory!", result };
-        }
+    //Map the memory for the lifetime of the buffer, so that write doesn't need to map and unmap it each time. The memory must be host visible.
+    void mapPersistently() {
+        mapped = virtualGpu.getMemoryAllocator().map(allocation);
     }
 
 
+    static constexpr size_t FLUSH_MAX_GAP = 256; //written ranges closer than this are flushed as one (e.g. the uniforms of consecutive objects, separated by their padding)
+
     VkBuffer buffer;
-    VkDeviceMemory bufferMemory;
+    MemoryAllocator::Allocation allocation;
     const LogicalDevice& virtualGpu;
     const size_t size;
+
+    VkMemoryPropertyFlags memoryProperties; //of the memory type the buffer has been allocated in
+    const VkDeviceSize nonCoherentAtomSize;
+    std::byte* mapped = nullptr; //if the buffer is persistently mapped
+    DirtyRanges dirtyRanges; //written since the last flush, if the memory isn't coherent
+    std::vector<VkMappedMemoryRange> flushRanges; //reused by each flush
 };
 
 
@@ -0,0 +1,135 @@
+#ifndef VULKAN_COLLISIONFILE
+#define VULKAN_COLLISIONFILE
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "CollisionFormat.h"
+
+
+namespace Vulkan::Physics {
+
+	/**
+	 * @brief A collision asset (.col) read in memory.
+	 * @details Collision assets are small, so the constructor reads the whole file, validates it and keeps a copy of the records. The vertices of an outline can be passed as they are to FrameHitbox (getFrameVertices) or to ConvexPolygonHitbox (getVertices of a convex outline), or embedded in a table with the outline option of TableCompiler.
+	 */
+	class CollisionFile {
+	public:
+
+		/**
+		 * @brief Reads and validates a collision asset. Throws std::runtime_error if the file cannot be read or it is not a valid collision asset.
+		 */
+		CollisionFile(const std::string& path) : path{ path } {
+			std::ifstream in{ path, std::ios::binary };
+			if (!in) {
+				throw std::runtime_error{ "Failed to open collision asset " + path };
+			}
+			std::vector<char> data{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+
+			if (data.size() < sizeof(CollisionFormat::Header)) {
+				fail("too small");
+			}
+			std::memcpy(&header, data.data(), sizeof(header));
+			if (std::memcmp(header.magic, CollisionFormat::MAGIC, sizeof(CollisionFormat::MAGIC)) != 0) {
+				fail("not a collision asset");
+			}
+			if (header.version != CollisionFormat::VERSION) {
+				fail("unsupported version " + std::to_string(header.version));
+			}
+			if (header.fileSize != data.size()) {
+				fail("truncated");
+			}
+
+			outlines = section<CollisionFormat::OutlineRecord>(data, header.outlines);
+			vertices = section<TableFormat::Vec3>(data, header.vertices);
+			for (const auto& outline : outlines) {
+				if (outline.vertices.first > vertices.size() || outline.vertices.count > vertices.size() - outline.vertices.first) {
+					fail("outline vertices out of range");
+				}
+				if (outline.vertices.count < ((outline.flags & CollisionFormat::CLOSED) ? 3 : 2)) {
+					fail("outline with too few vertices");
+				}
+			}
+		}
+
+
+		size_t getOutlinesCount() const {
+			return outlines.size();
+		}
+
+		const CollisionFormat::OutlineRecord& getOutline(size_t i) const {
+			return outlines.at(i);
+		}
+
+		bool isClosed(size_t i) const {
+			return getOutline(i).flags & CollisionFormat::CLOSED;
+		}
+
+		bool isConvex(size_t i) const {
+			return getOutline(i).flags & CollisionFormat::CONVEX;
+		}
+
+		float getTolerance() const {
+			return header.tolerance;
+		}
+
+		const std::string& getPath() const {
+			return path;
+		}
+
+
+		/**
+		 * @brief Returns the vertices of an outline. A closed outline doesn't repeat its first vertex.
+		 */
+		std::span<const TableFormat::Vec3> getVertices(size_t i) const {
+			const auto& range = getOutline(i).vertices;
+			return std::span<const TableFormat::Vec3>{ vertices }.subspan(range.first, range.count);
+		}
+
+
+		/**
+		 * @brief Returns the vertices of an outline as the vertices of a FrameHitbox: the first vertex of a closed outline is repeated at the end.
+		 */
+		std::vector<TableFormat::Vec3> getFrameVertices(size_t i) const {
+			auto outline = getVertices(i);
+			std::vector<TableFormat::Vec3> res{ outline.begin(), outline.end() };
+			if (isClosed(i)) {
+				res.push_back(outline.front());
+			}
+			return res;
+		}
+
+
+	private:
+
+		[[noreturn]] void fail(const std::string& message) const {
+			throw std::runtime_error{ "Collision asset " + path + " is corrupted: " + message };
+		}
+
+		//copies the records, so that they are aligned whatever the alignment of the buffer
+		template<typename T>
+		std::vector<T> section(const std::vector<char>& data, const TableFormat::Section& section) const {
+			if (section.offset > data.size() || section.count > (data.size() - section.offset) / sizeof(T)) {
+				fail("section out of range");
+			}
+			std::vector<T> res(section.count);
+			std::memcpy(res.data(), data.data() + section.offset, section.count * sizeof(T));
+			return res;
+		}
+
+
+		std::string path;
+		CollisionFormat::Header header{};
+		std::vector<CollisionFormat::OutlineRecord> outlines;
+		std::vector<TableFormat::Vec3> vertices;
+	};
+
+}
+
+
+#endif
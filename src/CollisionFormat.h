@@ -0,0 +1,50 @@
+#ifndef VULKAN_COLLISIONFORMAT
+#define VULKAN_COLLISIONFORMAT
+
+#include <cstdint>
+#include <type_traits>
+
+#include "TableFormat.h"
+
+
+/**
+ * @brief Layout of the binary collision assets (.col): the outlines of a mesh sliced at the height of the playfield, cooked by the CollisionCooker tool.
+ * @details A collision asset is a Header followed by 2 sections of fixed size records, addressed as the sections of a table file (see TableFormat).
+ *			Outlines are sorted by area, largest first. The vertices are in the reference system of the hitbox the mesh is the model of (model rotation and scale already applied), with z = 0, so they can be used as the vertices of a FrameHitbox or of a ConvexPolygonHitbox.
+ */
+namespace Vulkan::Physics::CollisionFormat {
+
+	constexpr char MAGIC[4] = { 'P', 'C', 'O', 'L' };
+	constexpr uint32_t VERSION = 1;
+
+
+	enum OutlineFlags : uint32_t {
+		CLOSED = 1, //the last vertex is connected to the first one (not repeated)
+		CONVEX = 2 //closed, counterclockwise and convex
+	};
+
+
+	struct OutlineRecord {
+		uint32_t flags; //OutlineFlags
+		float area; //0 for open outlines
+		TableFormat::Range vertices; //in the vertices section
+	};
+
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t fileSize;
+		float tolerance; //maximum distance of the simplified outlines from the slice of the mesh
+
+		TableFormat::Section outlines; //OutlineRecord
+		TableFormat::Section vertices; //TableFormat::Vec3
+	};
+
+
+	static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) % 4 == 0);
+	static_assert(std::is_trivially_copyable_v<OutlineRecord> && sizeof(OutlineRecord) % 4 == 0);
+}
+
+
+#endif
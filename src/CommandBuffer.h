@@ -4,6 +4,7 @@
 #include <vulkan/vulkan.h>
 
 #include <functional>
+#include <span>
 #include <utility>
 #include <concepts>
 
@@ -15,6 +16,7 @@
 #include "VulkanException.h"
 #include "Fence.h"
 #include "Queue.h"
+#include "Tracer.h"
 
 
 namespace Vulkan { class CommandBuffer; }
@@ -205,26 +207,21 @@ public:
 	}
 
 
-	CommandBuffer& sendCommand(Queue queue, const std::vector<VkSemaphore>& waitSemaphores, const std::vector<VkSemaphore>& signalSemaphores, const std::vector<VkPipelineStageFlags>& waitStages, const SynchronizationPrimitives::Fence& fence) {
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.waitSemaphoreCount = waitSemaphores.size();
-		submitInfo.pWaitSemaphores = waitSemaphores.size() != 0 ? waitSemaphores.data() : nullptr;
-		submitInfo.pWaitDstStageMask = waitStages.size() != 0 ? waitStages.data() : nullptr;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-		submitInfo.signalSemaphoreCount = signalSemaphores.size();
-		submitInfo.pSignalSemaphores = signalSemaphores.size() != 0 ? signalSemaphores.data() : nullptr;
+	CommandBuffer& sendCommand(Queue queue, std::span<const VkSemaphore> waitSemaphores, std::span<const VkSemaphore> signalSemaphores, std::span<const VkPipelineStageFlags> waitStages, const SynchronizationPrimitives::Fence& fence) {
+		return submit(queue, waitSemaphores, signalSemaphores, waitStages, +fence);
+	}
 
-		if (VkResult result = vkQueueSubmit(+queue, 1, &submitInfo, +fence); result != VK_SUCCESS) {
-			throw VulkanException{ "Failed to submit the command buffer for the current frame", result };
-		}
 
-		return *this;
+	/**
+	 * @brief Submits the command buffer without a fence, e.g. when its end is tracked by a later submission which waits for it on a semaphore.
+	 */
+	CommandBuffer& sendCommand(Queue queue, std::span<const VkSemaphore> waitSemaphores, std::span<const VkSemaphore> signalSemaphores, std::span<const VkPipelineStageFlags> waitStages) {
+		return submit(queue, waitSemaphores, signalSemaphores, waitStages, VK_NULL_HANDLE);
 	}
 
 
 	CommandBuffer& sendCommand(Queue queue) {
+		VULKAN_TRACE_ZONE("CommandBuffer::sendCommand");
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		submitInfo.waitSemaphoreCount = 0;
@@ -245,6 +242,26 @@ public:
 
 private:
 
+	CommandBuffer& submit(Queue queue, std::span<const VkSemaphore> waitSemaphores, std::span<const VkSemaphore> signalSemaphores, std::span<const VkPipelineStageFlags> waitStages, VkFence fence) {
+		VULKAN_TRACE_ZONE("CommandBuffer::sendCommand");
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = waitSemaphores.size();
+		submitInfo.pWaitSemaphores = waitSemaphores.size() != 0 ? waitSemaphores.data() : nullptr;
+		submitInfo.pWaitDstStageMask = waitStages.size() != 0 ? waitStages.data() : nullptr;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		submitInfo.signalSemaphoreCount = signalSemaphores.size();
+		submitInfo.pSignalSemaphores = signalSemaphores.size() != 0 ? signalSemaphores.data() : nullptr;
+
+		if (VkResult result = vkQueueSubmit(+queue, 1, &submitInfo, fence); result != VK_SUCCESS) {
+			throw VulkanException{ "Failed to submit the command buffer for the current frame", result };
+		}
+
+		return *this;
+	}
+
+
 	//Used only for move ctor
 	CommandBuffer() : commandBuffer{ VK_NULL_HANDLE }, commandBufferPool{ nullptr }, virtualGpu{ nullptr }{}
 
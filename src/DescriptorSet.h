@@ -46,7 +46,14 @@ namespace Vulkan {
 				throw VulkanException("Failed to allocate descriptor sets!", result);
 			}
 
+			update(virtualGpu);
+		}
+
 
+		/**
+		 * @brief Writes the bindings of the set into the descriptor set (e.g. after a texture of a StaticSet has been changed). The GPU must not be using the descriptor set.
+		 */
+		void update(const LogicalDevice& virtualGpu) {
 			//fill the descriptor set's bindings
 			std::vector<DescriptorSetBindingCreationInfo> descriptorsInfo;
 			for (int i = 0; i < set.getAmountOfBindings(); ++i) {
@@ -0,0 +1,95 @@
+#ifndef VULKAN_DIRTYRANGES
+#define VULKAN_DIRTYRANGES
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+
+namespace Vulkan::Buffers {
+
+	/**
+	 * @brief The ranges of a mapped memory written since the last flush, merged into as few ranges as possible, so that a non-coherent memory is flushed with few ranges.
+	 * @details Consecutive writes (e.g. the bindings of an object, then the bindings of the next object) extend the last range, so the ranges are usually merged while they are added.
+	 *			The vector of the ranges keeps its capacity when cleared, so a steady flow of writes doesn't allocate.
+	 */
+	class DirtyRanges {
+	public:
+
+		struct Range {
+			size_t begin;
+			size_t end; //excluded
+		};
+
+
+		/**
+		 * @brief Marks size bytes starting from offset as written.
+		 */
+		void add(size_t offset, size_t size) {
+			if (size == 0) {
+				return;
+			}
+			const size_t end = offset + size;
+			if (!ranges.empty() && offset <= ranges.back().end && end >= ranges.back().begin) {
+				ranges.back().begin = std::min(ranges.back().begin, offset);
+				ranges.back().end = std::max(ranges.back().end, end);
+			}
+			else {
+				ranges.push_back(Range{ offset, end });
+			}
+		}
+
+
+		/**
+		 * @brief Aligns the ranges to atomSize (the granularity of a flush), then sorts and merges the ranges at most maxGap bytes apart.
+		 * @details Merging ranges separated by a gap flushes the gap too, which is harmless as long as the GPU doesn't write to the memory, and is cheaper than many small ranges (e.g. the padding between the uniforms of 2 objects).
+		 *
+		 * @param atomSize The alignment of the ranges (VkPhysicalDeviceLimits::nonCoherentAtomSize), a power of 2.
+		 * @param limit The size of the memory: an aligned range doesn't go past it.
+		 * @param maxGap Ranges which are at most maxGap bytes apart are merged.
+		 * @return The merged ranges, valid till the next call of add or clear.
+		 */
+		std::span<const Range> coalesce(size_t atomSize, size_t limit, size_t maxGap = 0) {
+			for (auto& range : ranges) {
+				range.begin = range.begin / atomSize * atomSize;
+				range.end = std::min((range.end + atomSize - 1) / atomSize * atomSize, limit);
+			}
+
+			auto byBegin = [](const Range& r1, const Range& r2) { return r1.begin < r2.begin; };
+			if (!std::is_sorted(ranges.begin(), ranges.end(), byBegin)) {
+				std::sort(ranges.begin(), ranges.end(), byBegin);
+			}
+
+			size_t merged = 0;
+			for (size_t i = 1; i < ranges.size(); ++i) {
+				if (ranges[i].begin <= ranges[merged].end + maxGap) {
+					ranges[merged].end = std::max(ranges[merged].end, ranges[i].end);
+				}
+				else {
+					ranges[++merged] = ranges[i];
+				}
+			}
+			ranges.resize(ranges.empty() ? 0 : merged + 1);
+			return ranges;
+		}
+
+
+		void clear() {
+			ranges.clear();
+		}
+
+
+		bool empty() const {
+			return ranges.empty();
+		}
+
+
+	private:
+		std::vector<Range> ranges;
+	};
+
+}
+
+
+#endif
@@ -2,6 +2,7 @@
 #define VULKAN_DRAWER
 
 #include <vulkan/vulkan.h>
+#include <array>
 #include <vector>
 
 #include "LogicalDevice.h"
@@ -23,6 +24,8 @@
 #include "Set.h"
 #include "DynamicSet.h"
 #include "StaticSet.h"
+#include "Tracer.h"
+#include "FrameAllocator.h"
 
 
 namespace Vulkan { class Drawer; }
@@ -44,7 +47,7 @@ public:
 	 * @param window The Window ehre to draw.
 	 * @param windowSurface The WindowSurface of the window (also serves to poll for window resizes and such).
 	 * @param renderPass How to draw a frame.
-	 * @param pipeline The stages to draw a frame.
+	 * @param pipeline The stages to draw a frame, one per group of buffers passed to draw. They can still be compiling (see Pipeline::isReady): the group isn't drawn till its pipeline is ready.
 	 * @param framesInFlight How many frames can be rendered concurrently.
 	 */
 	Drawer(const LogicalDevice& virtualGpu,
@@ -69,6 +72,7 @@ public:
 		depthBuffer{ depthBuffer },
 		renderPass{ renderPass },
 		pipelines{ pipelines },
+		drawnPipelines(pipelines.size(), nullptr),
 		globalDescriptorSets{},
 		perObjectDescriptorSets{},
 		swapchain{ swapchain },
@@ -168,68 +172,147 @@ public:
 	 * @brief Draws the vertexBuffer.
 	 * @details This function will simply bind the vertex buffer (vertexBuffer) and then draw it.
 	 *
+	 *			Once the swapchain is stable, drawing a frame doesn't allocate: the scratch arrays are taken from frameAllocator, which the caller resets once per frame.
+	 *
+	 * @param frameAllocator The allocator of the scratch memory of the frame.
 	 * @param vertexBuffer Vertices to draw.
 	 * @param indexBuffer Indeces of the vertices to draw (for indexed drawing).
 	 */
 	template<template<typename, typename>class... P> requires (std::same_as<P<int, int>, std::pair<int, int>> && ...)
-		void draw(const P<std::reference_wrapper<Buffers::VertexBuffer>, std::reference_wrapper<Buffers::IndexBuffer>>&... buffers) {
+		void draw(Utilities::FrameAllocator& frameAllocator, const P<std::reference_wrapper<Buffers::VertexBuffer>, std::reference_wrapper<Buffers::IndexBuffer>>&... buffers) {
+		VULKAN_TRACE_ZONE("Drawer::draw");
 		uint32_t obtainedSwapchainImageIndex{}; //the index of the image of the swapchain we'll draw to
-		vkWaitForFences(+virtualGpu, 1, &+fences[currentFrame], VK_TRUE, UINT64_MAX); //wait until a swapchain image is free
+		waitForFrame(); //usually already done by the caller, before filling the uniforms of the frame
 		//get an image from the swapchain
-		if (VkResult result = vkAcquireNextImageKHR(+virtualGpu, +swapchain, UINT64_MAX, +imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &obtainedSwapchainImageIndex); result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+		VkResult acquired;
+		{
+			VULKAN_TRACE_ZONE("vkAcquireNextImageKHR");
+			acquired = vkAcquireNextImageKHR(+virtualGpu, +swapchain, UINT64_MAX, +imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &obtainedSwapchainImageIndex);
+		}
+		if (acquired == VK_ERROR_OUT_OF_DATE_KHR || acquired == VK_SUBOPTIMAL_KHR) {
 			recreateSwapchain();
 			return;
 		}
-		else if (result != VK_SUCCESS) {
-			throw VulkanException{ "Failed to acquire swapchain image", result };
+		else if (acquired != VK_SUCCESS) {
+			throw VulkanException{ "Failed to acquire swapchain image", acquired };
 		}
 		vkResetFences(+virtualGpu, 1, &+fences[currentFrame]); //reset the just signaled fence to an unsignalled state
 
-		commandBuffers[currentFrame].reset(renderPass, framebuffers[obtainedSwapchainImageIndex]);
-		//fill the command buffer (for each pipeline)
-		unsigned int counter = 0;
-		([&](const Buffers::VertexBuffer& vertexBuffer, const Buffers::IndexBuffer& indexBuffer) {
-			VkDeviceSize offsets[] = { 0 };
-			commandBuffers[currentFrame].addCommand(vkCmdBindPipeline, VK_PIPELINE_BIND_POINT_GRAPHICS, +*pipelines[counter]);
-			commandBuffers[currentFrame].addCommand(vkCmdBindVertexBuffers, 0, 1, &+vertexBuffer, offsets);
-			commandBuffers[currentFrame].addCommand(vkCmdBindIndexBuffer, +indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-			commandBuffers[currentFrame].addCommand(vkCmdBindDescriptorSets, VK_PIPELINE_BIND_POINT_GRAPHICS, +pipelines[counter]->getLayout(), 0, 1, &+globalDescriptorSets[currentFrame][counter], 0, nullptr); //TODO at the moment the binding of the global descriptors is dynamic, but it should be static (not a big deal really)
-			for (int i = 0; i < indexBuffer.getModelsCount(); ++i) {
-				commandBuffers[currentFrame].addCommand(vkCmdBindDescriptorSets, VK_PIPELINE_BIND_POINT_GRAPHICS, +pipelines[counter]->getLayout(), 1, 1, &+perObjectDescriptorSets[currentFrame][counter], perObjectDescriptorSets[currentFrame][counter].getSet().getAmountOfBindings(), perObjectDescriptorSets[currentFrame][counter].getSet().getDynamicDistances(i).data());
-				commandBuffers[currentFrame].addCommand(vkCmdDrawIndexed, indexBuffer.getModelIndexesCount(i), 1, indexBuffer.getModelOffset(i), 0, 0);
-			}
-			counter++;
-			}(buffers.first, buffers.second), ...);
-
-		commandBuffers[currentFrame].addCommand(vkCmdEndRenderPass);
-		commandBuffers[currentFrame].endCommand();
+		{
+			VULKAN_TRACE_ZONE("Drawer::record");
+			commandBuffers[currentFrame].reset(renderPass, framebuffers[obtainedSwapchainImageIndex]);
+			//fill the command buffer (for each pipeline)
+			unsigned int counter = 0;
+			([&](const Buffers::VertexBuffer& vertexBuffer, const Buffers::IndexBuffer& indexBuffer) {
+				//till its pipeline is ready, a group is drawn with the pipeline it was drawn with before, or not at all
+				if (pipelines[counter]->isReady()) {
+					drawnPipelines[counter] = pipelines[counter];
+				}
+				Pipeline* pipeline = drawnPipelines[counter];
+				if (pipeline == nullptr) {
+					counter++;
+					return;
+				}
+
+				VkDeviceSize offsets[] = { vertexBuffer.getRegionOffset() }; //the region of the current frame, if the vertices are streamed
+				commandBuffers[currentFrame].addCommand(vkCmdBindPipeline, VK_PIPELINE_BIND_POINT_GRAPHICS, +*pipeline);
+				commandBuffers[currentFrame].addCommand(vkCmdBindVertexBuffers, 0, 1, &+vertexBuffer, offsets);
+				commandBuffers[currentFrame].addCommand(vkCmdBindIndexBuffer, +indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+				const auto& globalSet = globalDescriptorSets[currentFrame][counter].getSet();
+				auto globalOffsets = frameAllocator.allocate<uint32_t>(globalSet.getAmountOfDynamicBindings()); //the regions of the current frame
+				globalSet.getDynamicOffsets(globalOffsets);
+				commandBuffers[currentFrame].addCommand(vkCmdBindDescriptorSets, VK_PIPELINE_BIND_POINT_GRAPHICS, +pipeline->getLayout(), 0, 1, &+globalDescriptorSets[currentFrame][counter], static_cast<uint32_t>(globalOffsets.size()), globalOffsets.data());
+				const auto& perObjectSet = perObjectDescriptorSets[currentFrame][counter].getSet();
+				auto dynamicDistances = frameAllocator.allocate<uint32_t>(perObjectSet.getAmountOfBindings()); //vkCmdBindDescriptorSets copies them, so the same array serves every model
+				for (int i = 0; i < indexBuffer.getModelsCount(); ++i) {
+					perObjectSet.getDynamicDistances(i, dynamicDistances);
+					commandBuffers[currentFrame].addCommand(vkCmdBindDescriptorSets, VK_PIPELINE_BIND_POINT_GRAPHICS, +pipeline->getLayout(), 1, 1, &+perObjectDescriptorSets[currentFrame][counter], static_cast<uint32_t>(dynamicDistances.size()), dynamicDistances.data());
+					commandBuffers[currentFrame].addCommand(vkCmdDrawIndexed, indexBuffer.getModelIndexesCount(i), 1, indexBuffer.getModelOffset(i), 0, 0);
+				}
+				counter++;
+				}(buffers.first, buffers.second), ...);
+
+			commandBuffers[currentFrame].addCommand(vkCmdEndRenderPass);
+			commandBuffers[currentFrame].endCommand();
+		}
 
 		//submit the command buffer to a queue
-		std::vector<VkSemaphore> waitSemaphores = { +imageAvailableSemaphores[currentFrame] }; //semaphore used to signal that an image is available to render to
-		std::vector<VkSemaphore> signalSemaphores = { +renderFinishedSemaphores[currentFrame] }; //semaphore used to signal that the render finished
-		std::vector<VkPipelineStageFlags> waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT }; //where to wait for an image (first semaphore). You can still run the vertex shader without an image, but you have to wait for an image for the fragment shader
+		const std::array<VkSemaphore, 1> waitSemaphores = { +imageAvailableSemaphores[currentFrame] }; //semaphore used to signal that an image is available to render to
+		const std::array<VkSemaphore, 1> signalSemaphores = { +renderFinishedSemaphores[currentFrame] }; //semaphore used to signal that the render finished
+		const std::array<VkPipelineStageFlags, 1> waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT }; //where to wait for an image (first semaphore). You can still run the vertex shader without an image, but you have to wait for an image for the fragment shader
 		commandBuffers[currentFrame].sendCommand(virtualGpu[QueueFamily::GRAPHICS], waitSemaphores, signalSemaphores, waitStages, fences[currentFrame]);
 
 		//submit the rendered image back to the swapchain for presentation
-		std::vector<VkSwapchainKHR> swapchains = { +swapchain };
+		const std::array<VkSwapchainKHR, 1> swapchains = { +swapchain };
 		VkPresentInfoKHR presentInfo{};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-		presentInfo.waitSemaphoreCount = signalSemaphores.size();
+		presentInfo.waitSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
 		presentInfo.pWaitSemaphores = signalSemaphores.data();
-		presentInfo.swapchainCount = swapchains.size();
+		presentInfo.swapchainCount = static_cast<uint32_t>(swapchains.size());
 		presentInfo.pSwapchains = swapchains.data();
 		presentInfo.pImageIndices = &obtainedSwapchainImageIndex;
 
-		if (VkResult result = vkQueuePresentKHR(+virtualGpu[QueueFamily::PRESENTATION], &presentInfo); result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+		VkResult presented;
+		{
+			VULKAN_TRACE_ZONE("vkQueuePresentKHR");
+			presented = vkQueuePresentKHR(+virtualGpu[QueueFamily::PRESENTATION], &presentInfo);
+		}
+		if (presented == VK_ERROR_OUT_OF_DATE_KHR || presented == VK_SUBOPTIMAL_KHR) {
 			recreateSwapchain();
 		}
-		else if (result != VK_SUCCESS) {
-			throw VulkanException{ "Failed to present image", result };
+		else if (presented != VK_SUCCESS) {
+			throw VulkanException{ "Failed to present image", presented };
 		}
 
 		increaseCurrentFrame();
 	}
 
+
+	/**
+	 * @brief Waits until the GPU has finished the last frame which used the resources of the next frame, and returns the index of the next frame (from 0 to getFramesInFlight() - 1).
+	 * @details Once it returns, the region of the next frame of a FrameRingBuffer can be filled (see FrameRingBuffer::setFrame) while the GPU still reads the regions of the other frames.
+	 */
+	unsigned int waitForFrame() {
+		VULKAN_TRACE_ZONE("vkWaitForFences");
+		vkWaitForFences(+virtualGpu, 1, &+fences[currentFrame], VK_TRUE, UINT64_MAX); //wait until the resources of the frame are free
+		return currentFrame;
+	}
+
+
+	/**
+	 * @brief Changes the pipeline a group of buffers is drawn with (e.g. another variant of its shaders). Till the new pipeline is ready, the group is drawn with the old one.
+	 * @details The pipeline must use the same sets as the old one, since the descriptor sets of the group don't change.
+	 */
+	void setPipeline(unsigned int group, Pipeline& pipeline) {
+		pipelines.at(group) = &pipeline;
+	}
+
+
+	unsigned int getFramesInFlight() const {
+		return framesInFlight;
+	}
+
+
+	/**
+	 * @brief Rewrites the descriptor sets of a frame which are created from a global set, e.g. after one of its textures has been changed (see StaticSet::setTexture).
+	 * @details The GPU must have finished the previous use of the frame (see waitForFrame).
+	 */
+	void updateGlobalSet(unsigned int frame, const StaticSet& set) {
+		for (auto& descriptorSet : globalDescriptorSets[frame]) {
+			if (&descriptorSet.getSet() == &set) {
+				descriptorSet.update(virtualGpu);
+			}
+		}
+	}
+
+
+	/**
+	 * @brief Returns how many times the swapchain has been recreated (e.g. because the window has been resized). A frame which recreates the swapchain allocates.
+	 */
+	uint64_t getSwapchainRecreations() const {
+		return swapchainRecreations;
+	}
+
 	
 	
 
@@ -241,6 +324,8 @@ private:
 
 
 	void recreateSwapchain() {
+		VULKAN_TRACE_ZONE("Drawer::recreateSwapchain");
+		swapchainRecreations++;
 		//if window is minimized, pause application
 		int width = 0, height = 0;
 		do {
@@ -268,6 +353,7 @@ private:
 
 	unsigned int currentFrame; //indicates which set of resources to use for the current frame (0 < x < maxFramesInFlight)
 	unsigned int framesInFlight; //maximum number of frames that can be rendered at the same time(of course no more than the number of swap chain images)
+	uint64_t swapchainRecreations = 0;
 
 	const LogicalDevice& virtualGpu;
 	const PhysicalDevice& realGpu;
@@ -275,6 +361,7 @@ private:
 	const WindowSurface& windowSurface;
 	const PipelineOptions::RenderPass& renderPass;
 	std::vector<Pipeline*> pipelines;
+	std::vector<Pipeline*> drawnPipelines; //the pipeline each group has been drawn with last, which it is drawn with till its pipeline is ready
 	const CommandBufferPool& commandBufferPool; 
 
 	Swapchain& swapchain;
@@ -2,7 +2,10 @@
 #define VULKAN_DYNAMICSET
 
 #include <glm/glm.hpp>
+#include <map>
+#include <span>
 #include <tuple>
+#include <vector>
 #include <concepts>
 #include <type_traits>
 
@@ -93,6 +96,7 @@ namespace Vulkan {
 				static_cast<DynamicSetBindingInfo*>(bindingsInfo[i].get())->dynamicDistance = currentOffset;
 				bindingsInfo[i].get()->binding = i; //also set the binding index
 			}
+			storeDynamicDistances();
 
 			//create the Vulkan layout struct used during pipeline creation
 			createDescriptorSetLayout(std::pair{ bindings.first, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC }...);
@@ -122,6 +126,7 @@ namespace Vulkan {
 				tmp->binding = bindingsInfo.size(); //set the index of this binding
 				this->bindingsInfo.push_back(std::move(tmp)); //add the pointer to the vector of binding info
 				}(bindingsInfo), ...);
+			storeDynamicDistances();
 		
 			//create the Vulkan layout struct used during pipeline creation
 			createDescriptorSetLayout(std::pair{ std::get<0>(bindingsInfo), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC }...);
@@ -138,15 +143,25 @@ namespace Vulkan {
 		 *					  buffer objects: 111222333...111111222222333333...
 		 *			Then getDynamicDistance(2) = {6, 12} beacause the bindings 'a' of 2 consecutive objects are distant 3 bytes, and 'b' 6 bytes.
 		 *			The key point is that getDynamicDistance(x) + offset(binding) always points to the first byte of the specified binding.
+		 *			If the buffer of a binding is a FrameRingBuffer, the offset of its current region is added too, so that the descriptors point at the region of the current frame.
 		 */
 		std::vector<uint32_t> getDynamicDistances(int i = 0) const {
-			std::vector<uint32_t> res;
+			std::vector<uint32_t> res(dynamicDistances.size());
+			getDynamicDistances(i, res);
+			return res;
+		}
 
-			for (const auto& binding : bindingsInfo) {
-				res.push_back(static_cast<DynamicSetBindingInfo*>(binding.get())->dynamicDistance * i);
-			}
 
-			return res;
+		/**
+		 * @brief Writes the offsets in the buffer of each binding of the i-th object (see the other overload) to distances, without allocating.
+		 * 
+		 * @param i The object.
+		 * @param distances Where to write the offsets, at least getAmountOfBindings() elements.
+		 */
+		void getDynamicDistances(int i, std::span<uint32_t> distances) const {
+			for (size_t binding = 0; binding < dynamicDistances.size(); ++binding) {
+				distances[binding] = bindingBuffers[binding]->getRegionOffset() + dynamicDistances[binding] * i;
+			}
 		}
 
 
@@ -159,6 +174,7 @@ namespace Vulkan {
 		 *			Then fillBuffer(A, {xxx, yyyy}, {zzz, tttt}) will fill the buffer like this: xxx-yyyy--zzz-tttt----------
 		 *			Basically the n-th element of the m-th tuple will be inserted in position: offset[n] + dynamicDistance[n] * m
 		 *			No checks on the types in the tuple are performed (for now), so it is responsibility of the user to pass the right data to the function.
+		 *			The buffer is flushed once all the data is written.
 		 * 
 		 * @param buffer Where to store the data.
 		 * @param ...tuplesOfData Data to store.
@@ -169,19 +185,34 @@ namespace Vulkan {
 		}
 
 
+		/**
+		 * @brief Fills the buffer with the data in the tuples, like the variadic version, when the number of objects is known only at run-time.
+		 * 
+		 * @param buffer Where to store the data.
+		 * @param tuplesOfData Data to store, the m-th tuple is the data of the m-th object.
+		 */
+		template<typename... Bindings>
+		void fillBuffer(Buffers::UniformBuffer& buffer, const std::vector<std::tuple<Bindings...>>& tuplesOfData) const {
+			fillBuffer(buffer, std::span<const std::tuple<Bindings...>>{ tuplesOfData });
+		}
+
+
+		/**
+		 * @brief Fills the buffer with the data in the tuples, like the vector version, e.g. when the tuples are allocated by a FrameAllocator.
+		 */
+		template<typename... Bindings>
+		void fillBuffer(Buffers::UniformBuffer& buffer, std::span<const std::tuple<Bindings...>> tuplesOfData) const {
+			fillBufferHelper(buffer, std::make_integer_sequence<int, sizeof...(Bindings)>{}, tuplesOfData);
+		}
+
+
 
 	private:
 
 		//This function is used to perform a sort of constexpr for each loop on the tuple
 		template<int... TI, typename... T>
 		void fillBufferHelper(Buffers::UniformBuffer& buffer, std::integer_sequence<int, TI...>, const T&... tuplesOfData) const {
-			std::vector<DynamicSetBindingInfo*> bindingsInfo;
-			try {
-				bindingsInfo = bindingsPerBuffer.at(&buffer); //get the info of the bindings of the buffer
-			}
-			catch (const std::out_of_range&) {
-				throw VulkanException{ "Failed to fill the uniform buffer", "The buffer to be filled isn't used in this set" };
-			}
+			const auto& bindingsInfo = getBindingsOfBuffer(buffer);
 			int counter = 0; //how many tuple we've already traversed
 
 			//Basically the n - th element of the m - th tuple will be inserted in position : offset[n] + dynamicDistance[n] * m
@@ -189,10 +220,42 @@ namespace Vulkan {
 				(buffer.fillBuffer(std::get<TI>(tuple), bindingsInfo[TI]->offset + bindingsInfo[TI]->dynamicDistance * counter), ...);
 				counter++;
 			}(tuplesOfData), ...);
+			buffer.flush();
+		}
+
+
+		template<int... TI, typename... Bindings>
+		void fillBufferHelper(Buffers::UniformBuffer& buffer, std::integer_sequence<int, TI...>, std::span<const std::tuple<Bindings...>> tuplesOfData) const {
+			const auto& bindingsInfo = getBindingsOfBuffer(buffer);
+
+			for (int counter = 0; counter < tuplesOfData.size(); ++counter) {
+				(buffer.fillBuffer(std::get<TI>(tuplesOfData[counter]), bindingsInfo[TI]->offset + bindingsInfo[TI]->dynamicDistance * counter), ...);
+			}
+			buffer.flush(); //a single flush for all the objects
+		}
+
+
+		//returns the info of the bindings of the buffer (a reference, since it is called every frame)
+		const std::vector<DynamicSetBindingInfo*>& getBindingsOfBuffer(const Buffers::UniformBuffer& buffer) const {
+			auto bindings = bindingsPerBuffer.find(&buffer);
+			if (bindings == bindingsPerBuffer.end()) {
+				throw VulkanException{ "Failed to fill the uniform buffer", "The buffer to be filled isn't used in this set" };
+			}
+			return bindings->second;
+		}
+
+
+		void storeDynamicDistances() {
+			for (const auto& binding : bindingsInfo) {
+				dynamicDistances.push_back(static_cast<DynamicSetBindingInfo*>(binding.get())->dynamicDistance);
+				bindingBuffers.push_back(&static_cast<DynamicSetBindingInfo*>(binding.get())->buffer);
+			}
 		}
 
 
 		std::map<const Buffers::UniformBuffer*, std::vector<DynamicSetBindingInfo*>> bindingsPerBuffer; //this map holds the bindings relative to each buffer used in the Set
+		std::vector<uint32_t> dynamicDistances; //the dynamic distance of each binding, in order
+		std::vector<const Buffers::UniformBuffer*> bindingBuffers; //the buffer of each binding, in order
 
 	};
 
@@ -1,6 +1,8 @@
 #ifndef VULKAN_FIELD
 #define VULKAN_FIELD
 
+#include <functional>
+
 #include "Foundations.h"
 
 
@@ -19,7 +21,30 @@ namespace Vulkan::Physics {
 		 * @param position The position of che "center" of the field.
 		 * @param calculateForce A function which returns the force applied by the field to the object. Such force can be based on all of the characteristics of the object inside the field, such as its position, mass or speed. Therefore a field can also be used to compute forces like friction.
 		 */
-		Field(Position position, Force(*calculateForce)(const Position&, const Cinematicable&)) : position{ position }, calculateForce{ calculateForce } {
+		Field(Position position, Force(*calculateForce)(const Position&, const Cinematicable&)) : position{ position }, calculateForce{ calculateForce }, calculateParametricForce{ nullptr }, parameter{ 0.0f } {
+
+		}
+
+
+		/**
+		 * @brief Builds a Field whose function depends on run-time parameters (e.g. a friction coefficient read from the command line).
+		 *
+		 * @param position The position of che "center" of the field.
+		 * @param calculateForce A callable which returns the force applied by the field to the object.
+		 */
+		Field(Position position, std::function<Force(const Position&, const Cinematicable&)> calculateForce) : position{ position }, calculateForce{ std::move(calculateForce) }, calculateParametricForce{ nullptr }, parameter{ 0.0f } {
+
+		}
+
+
+		/**
+		 * @brief Builds a Field whose function has a run-time parameter (e.g. the intensity of the gravity read from a table file), without wrapping it in a std::function.
+		 *
+		 * @param position The position of che "center" of the field.
+		 * @param calculateForce A function which returns the force applied by the field to the object, given the parameter.
+		 * @param parameter The last argument passed to calculateForce.
+		 */
+		Field(Position position, Force(*calculateForce)(const Position&, const Cinematicable&, float), float parameter) : position{ position }, calculateForce{}, calculateParametricForce{ calculateForce }, parameter{ parameter } {
 
 		}
 
@@ -41,6 +66,9 @@ namespace Vulkan::Physics {
 		 * @return The Force applied by the force field to the body.
 		 */
 		Force calculateAppliedForce(const Cinematicable& body) {
+			if (calculateParametricForce != nullptr) {
+				return calculateParametricForce(position, body, parameter);
+			}
 			return calculateForce(position, body);
 		}
 
@@ -48,6 +76,8 @@ namespace Vulkan::Physics {
 	private:
 		Position position;
 		std::function<Force(const Position&, const Cinematicable&)> calculateForce;
+		Force(*calculateParametricForce)(const Position&, const Cinematicable&, float);
+		float parameter;
 	};
 
 }
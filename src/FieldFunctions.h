@@ -12,8 +12,7 @@ namespace Vulkan::Physics::FieldFunctions {
 	}
 
 
-	template<float intensity>
-	Force centralField(const Position& fieldCenter, const Cinematicable& body) {
+	inline Force centralField(const Position& fieldCenter, const Cinematicable& body, float intensity) {
 		if (fieldCenter == body.getPosition()) {
 			return {0.0f, 0.0f, 0.0f };
 		}
@@ -22,16 +21,32 @@ namespace Vulkan::Physics::FieldFunctions {
 	}
 
 
-	template<float mu>
-	Force friction(const Position& fieldCenter, const Cinematicable& body) {
+	template<float intensity>
+	Force centralField(const Position& fieldCenter, const Cinematicable& body) {
+		return centralField(fieldCenter, body, intensity);
+	}
+
+
+	inline Force friction(const Position& fieldCenter, const Cinematicable& body, float mu) {
 		auto dir = glm::vec3(-body.getSpeed());
 		return dir * mu;
 	}
 
 
+	template<float mu>
+	Force friction(const Position& fieldCenter, const Cinematicable& body) {
+		return friction(fieldCenter, body, mu);
+	}
+
+
+	inline Force gravity(const Position& fieldCenter, const Cinematicable& body, float g) {
+		return glm::vec3{0.0f, -1.0f, 0.0f} * g;
+	}
+
+
 	template<float g>
 	Force gravity(const Position& fieldCenter, const Cinematicable& body) {
-		return glm::vec3{0.0f, -1.0f, 0.0f} * g;
+		return gravity(fieldCenter, body, g);
 	}
 
 
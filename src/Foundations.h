@@ -3,356 +3,425 @@
 
 
 #include <glm/glm.hpp>
+#include <cmath>
+#include <concepts>
 #include <functional>
+#include <type_traits>
 
 
-namespace Vulkan::Physics { class Vectorial; class Scalar; class Position; class DeltaSpace; class Speed; class Acceleration; class Force; class Impulse; class Mass; class Time; }
+/**
+ * @brief The physical quantities are templates on the scalar type (T), the number of dimensions (D) and the glm qualifier (Q, e.g. to use SIMD aligned vectors).
+ * @details The names without the Basic prefix (Position, Speed, ...) are the 3D float instantiations used by the table. Planar, Precise and Aligned contain the other common instantiations.
+ *			All the quantities are trivially copyable and their arithmetic is constexpr, so that they can be kept in registers like the glm vectors they wrap.
+ */
+namespace Vulkan::Physics {
+	template<typename T = float, glm::length_t D = 3, glm::qualifier Q = glm::defaultp> class BasicVectorial;
+	template<typename T = float> class BasicScalar;
+	template<typename T = float, glm::length_t D = 3, glm::qualifier Q = glm::defaultp> class BasicPosition;
+	template<typename T = float, glm::length_t D = 3, glm::qualifier Q = glm::defaultp> class BasicDeltaSpace;
+	template<typename T = float, glm::length_t D = 3, glm::qualifier Q = glm::defaultp> class BasicSpeed;
+	template<typename T = float, glm::length_t D = 3, glm::qualifier Q = glm::defaultp> class BasicAcceleration;
+	template<typename T = float, glm::length_t D = 3, glm::qualifier Q = glm::defaultp> class BasicForce;
+	template<typename T = float, glm::length_t D = 3, glm::qualifier Q = glm::defaultp> class BasicImpulse;
+	template<typename T = float> class BasicMass;
+	template<typename T = float> class BasicTime;
+}
+
 
 
-class Vulkan::Physics::Vectorial {
+template<typename T, glm::length_t D, glm::qualifier Q>
+class Vulkan::Physics::BasicVectorial {
 public:
-	Vectorial(glm::vec3 vector = { 0.0f, 0.0f, 0.0f }) : vector{ vector } {}
+	using Vector = glm::vec<D, T, Q>;
 
-	Vectorial(float x, float y, float z) : vector{ x,y,z } {}
+	constexpr BasicVectorial(Vector vector = Vector{ static_cast<T>(0) }) : vector{ vector } {}
 
+	constexpr BasicVectorial(T x, T y) requires (D == 2) : vector{ x,y } {}
 
+	constexpr BasicVectorial(T x, T y, T z) requires (D == 3) : vector{ x,y,z } {}
 
-	float x() const{
+
+
+	constexpr T x() const{
 		return vector.x;
 	}
 
-	float y() const {
+	constexpr T y() const {
 		return vector.y;
 	}
 
-	float z() const {
+	constexpr T z() const requires (D >= 3) {
 		return vector.z;
 	}
 
 
 
-	operator glm::vec3() const {
+	constexpr operator Vector() const {
 		return vector;
 	}
 
 
 
-	template<std::derived_from<Vectorial> V>
-	friend V operator+(V v1, V v2) {
+	/**
+	 * @brief Returns the squared length of the vector: comparing squared lengths avoids a square root.
+	 */
+	constexpr T squaredLength() const {
+		return dot(vector, vector);
+	}
+
+	T length() const {
+		return std::sqrt(squaredLength());
+	}
+
+
+
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr V operator+(V v1, V v2) {
 		return V{ v1.vector + v2.vector };
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend V operator-(V v1, V v2) {
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr V operator-(V v1, V v2) {
 		return V{ v1.vector - v2.vector };
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend V operator-(V v) {
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr V operator-(V v) {
 		return V{ -v.vector };
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend V& operator+=(V& v1, V v2) {
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr V& operator+=(V& v1, V v2) {
 		v1.vector += v2.vector;
 		return v1;
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend V& operator-=(V& v1, V v2) {
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr V& operator-=(V& v1, V v2) {
 		v1.vector -= v2.vector;
 		return v1;
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend V operator*(V v, float x) {
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr V operator*(V v, T x) {
 		return V{ v.vector * x };
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend V operator/(V v, float x) {
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr V operator/(V v, T x) {
 		return V{ v.vector / x };
 	}
 
 
-	friend float operator*(Vectorial v1, Vectorial v2) {
-		return glm::dot(v1.vector, v2.vector);
+	friend constexpr T operator*(BasicVectorial v1, BasicVectorial v2) {
+		return dot(v1.vector, v2.vector);
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend auto operator<=>(const V& v1, float v2) {
-		if (glm::length(v1.vector) < v2) {
-			return -1;
-		}
-		else if (glm::length(v1.vector) > v2) {
-			return 1;
-		}
-		else {
-			return 0;
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr auto operator<=>(const V& v1, T v2) {
+		if (v2 < static_cast<T>(0)) {
+			return 1; //a length is never negative
 		}
+		return compare(v1.squaredLength(), v2 * v2);
 	}
 
 
-	template<std::derived_from<Vectorial> V>
-	friend auto operator<=>(const V& v1, const V& v2) {
-		if (glm::length(v1.vector) < glm::length(v2.vector)) {
+	template<std::derived_from<BasicVectorial> V>
+	friend constexpr auto operator<=>(const V& v1, const V& v2) {
+		return compare(v1.squaredLength(), v2.squaredLength());
+	}
+
+
+
+
+protected:
+	Vector vector;
+
+
+private:
+	static constexpr T dot(const Vector& v1, const Vector& v2) {
+		T res = static_cast<T>(0);
+		for (glm::length_t i = 0; i < D; ++i) {
+			res += v1[i] * v2[i];
+		}
+		return res;
+	}
+
+	static constexpr int compare(T l1, T l2) {
+		if (l1 < l2) {
 			return -1;
 		}
-		else if (glm::length(v1.vector) > glm::length(v2.vector)) {
+		else if (l1 > l2) {
 			return 1;
 		}
 		else {
 			return 0;
 		}
 	}
-
-	
-
-
-protected:
-	glm::vec3 vector;
 };
 
 
-class Vulkan::Physics::Scalar {
+template<typename T>
+class Vulkan::Physics::BasicScalar {
 public:
-	Scalar(float value = 0) : value{ value } {}
+	constexpr BasicScalar(T value = 0) : value{ value } {}
 
-	template<std::derived_from<Scalar> S>
-	friend S operator+(S s1, S s2) {
+	template<std::derived_from<BasicScalar> S>
+	friend constexpr S operator+(S s1, S s2) {
 		return S{ s1.value + s2.value };
 	}
 
-	template<std::derived_from<Scalar> S>
-	friend S operator-(S s1, S s2) {
+	template<std::derived_from<BasicScalar> S>
+	friend constexpr S operator-(S s1, S s2) {
 		return S{ s1.value - s2.value };
 	}
 
-	template<std::derived_from<Scalar> S>
-	friend S& operator+=(S& s1, S s2) {
+	template<std::derived_from<BasicScalar> S>
+	friend constexpr S& operator+=(S& s1, S s2) {
 		s1.value += s2.value;
 		return s1;
 	}
 
-	template<std::derived_from<Scalar> S>
-	friend S& operator-=(S& s1, S s2) {
+	template<std::derived_from<BasicScalar> S>
+	friend constexpr S& operator-=(S& s1, S s2) {
 		s1.value -= s2.value;
 		return s1;
 	}
 
 
-	explicit operator float() const {
+	explicit constexpr operator T() const {
 		return value;
 	}
 
 
 protected:
-	float value;
+	T value;
 };
 
 
-class Vulkan::Physics::Mass : public Vulkan::Physics::Scalar {
+template<typename T>
+class Vulkan::Physics::BasicMass : public Vulkan::Physics::BasicScalar<T> {
 public:
-	Mass(float mass = 0) : Scalar{ mass }{}
+	constexpr BasicMass(T mass = 0) : BasicScalar<T>{ mass }{}
+
+	friend constexpr BasicMass operator*(BasicMass m1, BasicMass m2) { //not correct but it works for now
+		return BasicMass{ m1.value * m2.value };
+	}
 
-	friend Mass operator*(Mass m1, Mass m2); //not correct but it works for now
-	friend Mass operator/(Mass m1, Mass m2); //not correct but it works for now
-	friend Impulse operator*(Speed speed, Mass mass);
-	friend Speed operator/(Impulse impulse, Mass mass);
-	friend Acceleration operator/(Force force, Mass mass);
+	friend constexpr BasicMass operator/(BasicMass m1, BasicMass m2) { //not correct but it works for now
+		return BasicMass{ m1.value / m2.value };
+	}
 };
 
 
 
 
-class Vulkan::Physics::Time : public Vulkan::Physics::Scalar {
+template<typename T>
+class Vulkan::Physics::BasicTime : public Vulkan::Physics::BasicScalar<T> {
 public:
-	Time(float time) : Scalar{ time } {}
-
-	friend DeltaSpace operator*(Speed speed, Time time);
-	friend Speed operator*(Acceleration speed, Time time);
-	friend Force operator/(Impulse impulse, Time time);
+	constexpr BasicTime(T time) : BasicScalar<T>{ time } {}
 };
 
 
 
 
-class Vulkan::Physics::Position {
+template<typename T, glm::length_t D, glm::qualifier Q>
+class Vulkan::Physics::BasicPosition {
 public:
-	Position(glm::vec3 position = { 0.0f, 0.0f, 0.0f }) : position{ position } {}
+	using Vector = glm::vec<D, T, Q>;
+
+	constexpr BasicPosition(Vector position = Vector{ static_cast<T>(0) }) : position{ position } {}
 
-	Position(float x, float y, float z) : Position{ glm::vec3{x, y, z} } {}
+	constexpr BasicPosition(T x, T y) requires (D == 2) : BasicPosition{ Vector{x, y} } {}
 
+	constexpr BasicPosition(T x, T y, T z) requires (D == 3) : BasicPosition{ Vector{x, y, z} } {}
 
-	const float& x() const {
+
+	constexpr const T& x() const {
 		return position.x;
 	}
 
-	const float& y() const {
+	constexpr const T& y() const {
 		return position.y;
 	}
 
-	const float& z() const {
+	constexpr const T& z() const requires (D >= 3) {
 		return position.z;
 	}
 
 
-	operator glm::vec3() const {
+	constexpr operator Vector() const {
 		return position;
 	}
-		
-	friend DeltaSpace operator-(Position p1, Position p2);
-	friend Position operator+(Position origin, DeltaSpace spaceCovered);
-	friend Position& operator+=(Position& origin, DeltaSpace spaceCovered);
 
-	Position operator-() const {
-		return Position{ -position };
+	friend constexpr BasicDeltaSpace<T, D, Q> operator-(BasicPosition p1, BasicPosition p2) {
+		return BasicDeltaSpace<T, D, Q>{ p1.position - p2.position };
 	}
 
-	friend auto operator==(const Position& p1, const Position& p2) {
-		return p1.position == p2.position;
+	friend constexpr BasicPosition operator+(BasicPosition origin, BasicDeltaSpace<T, D, Q> spaceCovered) {
+		return BasicPosition{ origin.position + Vector(spaceCovered) };
 	}
 
-private:
-	glm::vec3 position;
-};
-
-
+	friend constexpr BasicPosition& operator+=(BasicPosition& origin, BasicDeltaSpace<T, D, Q> spaceCovered) {
+		origin.position += Vector(spaceCovered);
+		return origin;
+	}
 
+	constexpr BasicPosition operator-() const {
+		return BasicPosition{ -position };
+	}
 
-class Vulkan::Physics::DeltaSpace : public Vulkan::Physics::Vectorial {
-public:
-	DeltaSpace(glm::vec3 vector = { 0.0f, 0.0f, 0.0f }) : Vectorial{ vector } {}
-	DeltaSpace(float x, float y, float z) : Vectorial{ x,y,z } {}
+	friend constexpr auto operator==(const BasicPosition& p1, const BasicPosition& p2) {
+		return p1.position == p2.position;
+	}
 
-	friend Position operator+(Position origin, DeltaSpace spaceCovered);
-	friend Position& operator+=(Position& origin, DeltaSpace spaceCovered);
+private:
+	Vector position;
 };
 
 
 
 
-class Vulkan::Physics::Speed : public Vulkan::Physics::Vectorial {
+template<typename T, glm::length_t D, glm::qualifier Q>
+class Vulkan::Physics::BasicDeltaSpace : public Vulkan::Physics::BasicVectorial<T, D, Q> {
 public:
-	Speed(glm::vec3 vector = { 0.0f, 0.0f, 0.0f }) : Vectorial{ vector } {}
-	Speed(float x, float y, float z) : Vectorial{ x,y,z } {}
-
-	friend DeltaSpace operator*(Speed speed, Time time);
-	friend Impulse operator*(Speed speed, Mass mass);
+	using BasicVectorial<T, D, Q>::BasicVectorial;
 };
 
 
 
 
-class Vulkan::Physics::Acceleration : public Vulkan::Physics::Vectorial {
+template<typename T, glm::length_t D, glm::qualifier Q>
+class Vulkan::Physics::BasicSpeed : public Vulkan::Physics::BasicVectorial<T, D, Q> {
 public:
-	Acceleration(glm::vec3 vector = { 0.0f, 0.0f, 0.0f }) : Vectorial{ vector } {}
-	Acceleration(float x, float y, float z) : Vectorial{ x,y,z } {}
+	using BasicVectorial<T, D, Q>::BasicVectorial;
 
-	friend Speed operator*(Acceleration speed, Time time);
-};
-
-
-
-
-class Vulkan::Physics::Force : public Vulkan::Physics::Vectorial {
-public:
-	Force(glm::vec3 vector = { 0.0f, 0.0f, 0.0f }) : Vectorial{ vector } {}
-	Force(float x, float y, float z) : Vectorial{ x,y,z } {}
+	friend constexpr BasicDeltaSpace<T, D, Q> operator*(BasicSpeed speed, BasicTime<T> time) {
+		return BasicDeltaSpace<T, D, Q>{ speed.vector * static_cast<T>(time) };
+	}
 
-	friend Acceleration operator/(Force force, Mass mass);
+	friend constexpr BasicImpulse<T, D, Q> operator*(BasicSpeed speed, BasicMass<T> mass) {
+		return BasicImpulse<T, D, Q>{ speed.vector * static_cast<T>(mass) };
+	}
 };
 
 
 
 
-class Vulkan::Physics::Impulse : public Vulkan::Physics::Vectorial {
+template<typename T, glm::length_t D, glm::qualifier Q>
+class Vulkan::Physics::BasicAcceleration : public Vulkan::Physics::BasicVectorial<T, D, Q> {
 public:
-	Impulse(glm::vec3 vector = { 0.0f, 0.0f, 0.0f }) : Vectorial{ vector } {}
-	Impulse(float x, float y, float z) : Vectorial{ x,y,z } {}
-
-	friend Speed operator/(Impulse impulse, Mass mass);
-	friend Force operator/(Impulse impulse, Time time);
-};
-
-
-
-
-
-//operations
-namespace Vulkan::Physics {
-
-	Mass operator*(Mass m1, Mass m2) {
-		return Mass{ m1.value * m2.value };
-	}
+	using BasicVectorial<T, D, Q>::BasicVectorial;
 
-	Mass operator/(Mass m1, Mass m2) {
-		return Mass{ m1.value / m2.value };
+	friend constexpr BasicSpeed<T, D, Q> operator*(BasicAcceleration acceleration, BasicTime<T> time) {
+		return BasicSpeed<T, D, Q>{ acceleration.vector * static_cast<T>(time) };
 	}
+};
 
 
-	
-	DeltaSpace operator-(Position p1, Position p2) {
-		return DeltaSpace{ p1.position - p2.position };
-	}
-
 
-	Position operator+(Position origin, DeltaSpace spaceCovered) {
-		return Position{ origin.position + spaceCovered.vector };
-	}
 
+template<typename T, glm::length_t D, glm::qualifier Q>
+class Vulkan::Physics::BasicForce : public Vulkan::Physics::BasicVectorial<T, D, Q> {
+public:
+	using BasicVectorial<T, D, Q>::BasicVectorial;
 
-	Position& operator+=(Position& origin, DeltaSpace spaceCovered) {
-		origin.position += spaceCovered.vector;
-		return origin;
+	friend constexpr BasicAcceleration<T, D, Q> operator/(BasicForce force, BasicMass<T> mass) {
+		return BasicAcceleration<T, D, Q>{ force.vector / static_cast<T>(mass) };
 	}
+};
 
 
 
 
-	DeltaSpace operator*(Speed speed, Time time) {
-		return DeltaSpace{ speed.vector * time.value };
-	}
-
+template<typename T, glm::length_t D, glm::qualifier Q>
+class Vulkan::Physics::BasicImpulse : public Vulkan::Physics::BasicVectorial<T, D, Q> {
+public:
+	using BasicVectorial<T, D, Q>::BasicVectorial;
 
-	Impulse operator*(Speed speed, Mass mass) {
-		return Impulse{ speed.vector * mass.value };
+	friend constexpr BasicSpeed<T, D, Q> operator/(BasicImpulse impulse, BasicMass<T> mass) {
+		return BasicSpeed<T, D, Q>{ impulse.vector / static_cast<T>(mass) };
 	}
 
-
-
-
-	Speed operator*(Acceleration acceleration, Time time) {
-		return Speed{ acceleration.vector * time.value };
+	friend constexpr BasicForce<T, D, Q> operator/(BasicImpulse impulse, BasicTime<T> time) {
+		return BasicForce<T, D, Q>{ impulse.vector / static_cast<T>(time) };
 	}
+};
 
 
 
 
-	Acceleration operator/(Force force, Mass mass) {
-		return Acceleration{ force.vector / mass.value };
-	}
-
-
-
-	Speed operator/(Impulse impulse, Mass mass) {
-		return Speed{ impulse.vector / mass.value };
-	}
 
+//instantiations
+namespace Vulkan::Physics {
 
-	Force operator/(Impulse impulse, Time time) {
-		return Force{ impulse.vector / time.value };
+	//3D float, used by the table
+	using Vectorial = BasicVectorial<>;
+	using Scalar = BasicScalar<>;
+	using Position = BasicPosition<>;
+	using DeltaSpace = BasicDeltaSpace<>;
+	using Speed = BasicSpeed<>;
+	using Acceleration = BasicAcceleration<>;
+	using Force = BasicForce<>;
+	using Impulse = BasicImpulse<>;
+	using Mass = BasicMass<>;
+	using Time = BasicTime<>;
+
+
+	//2D float, for the physics on the plane of the table
+	namespace Planar {
+		using Vectorial = BasicVectorial<float, 2>;
+		using Position = BasicPosition<float, 2>;
+		using DeltaSpace = BasicDeltaSpace<float, 2>;
+		using Speed = BasicSpeed<float, 2>;
+		using Acceleration = BasicAcceleration<float, 2>;
+		using Force = BasicForce<float, 2>;
+		using Impulse = BasicImpulse<float, 2>;
+		using Mass = BasicMass<float>;
+		using Time = BasicTime<float>;
+	}
+
+
+	//3D double, for offline simulations which need a long simulated time
+	namespace Precise {
+		using Vectorial = BasicVectorial<double, 3>;
+		using Position = BasicPosition<double, 3>;
+		using DeltaSpace = BasicDeltaSpace<double, 3>;
+		using Speed = BasicSpeed<double, 3>;
+		using Acceleration = BasicAcceleration<double, 3>;
+		using Force = BasicForce<double, 3>;
+		using Impulse = BasicImpulse<double, 3>;
+		using Mass = BasicMass<double>;
+		using Time = BasicTime<double>;
+	}
+
+
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	//3D float on SIMD aligned glm vectors (requires GLM_FORCE_DEFAULT_ALIGNED_GENTYPES or GLM_FORCE_ALIGNED_GENTYPES)
+	namespace Aligned {
+		using Vectorial = BasicVectorial<float, 3, glm::aligned_highp>;
+		using Position = BasicPosition<float, 3, glm::aligned_highp>;
+		using DeltaSpace = BasicDeltaSpace<float, 3, glm::aligned_highp>;
+		using Speed = BasicSpeed<float, 3, glm::aligned_highp>;
+		using Acceleration = BasicAcceleration<float, 3, glm::aligned_highp>;
+		using Force = BasicForce<float, 3, glm::aligned_highp>;
+		using Impulse = BasicImpulse<float, 3, glm::aligned_highp>;
+		using Mass = BasicMass<float>;
+		using Time = BasicTime<float>;
 	}
+#endif
 
 
-
+	static_assert(std::is_trivially_copyable_v<Position> && std::is_trivially_copyable_v<Force> && std::is_trivially_copyable_v<Mass>);
+	static_assert(std::is_trivially_copyable_v<Planar::Position> && std::is_trivially_copyable_v<Planar::Force>);
+	static_assert(sizeof(Planar::Position) == 2 * sizeof(float) && sizeof(Planar::Speed) == 2 * sizeof(float));
 }
 
 #endif
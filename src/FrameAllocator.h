@@ -0,0 +1,119 @@
+#ifndef VULKAN_FRAMEALLOCATOR
+#define VULKAN_FRAMEALLOCATOR
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+
+namespace Vulkan::Utilities {
+
+	/**
+	 * @brief A linear allocator for the scratch memory of a frame: an allocation moves a pointer forward in a block, and reset frees everything at once.
+	 * @details Nothing is freed (nor destroyed) before reset, so only trivially destructible objects can be allocated.
+	 *			If a frame needs more than the capacity, the allocator takes a new block from the heap, and the next reset replaces all the blocks with a single block as large as the whole frame needed.
+	 *			Therefore the allocator touches the heap only during the first frames (the warm-up), and then every frame reuses the same block.
+	 *			It is meant to be used by a single thread (e.g. the draw cycle).
+	 */
+	class FrameAllocator {
+	public:
+
+		/**
+		 * @param capacity Size in bytes of the initial block.
+		 */
+		FrameAllocator(size_t capacity = 1 << 16) {
+			blocks.push_back(Block{ std::make_unique<std::byte[]>(std::max<size_t>(capacity, 1)), std::max<size_t>(capacity, 1) });
+		}
+
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+
+
+		/**
+		 * @brief Returns an array of count value-initialized objects, valid till the next reset.
+		 */
+		template<typename T> requires std::is_trivially_destructible_v<T>
+		std::span<T> allocate(size_t count) {
+			auto memory = static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+			for (size_t i = 0; i < count; ++i) {
+				new (memory + i) T{};
+			}
+			return { memory, count };
+		}
+
+
+		/**
+		 * @brief Returns bytes bytes aligned to alignment (a power of 2), valid till the next reset.
+		 */
+		void* allocateBytes(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+			auto& block = blocks.back();
+			const auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+			const size_t offset = ((base + used + alignment - 1) & ~(uintptr_t{ alignment } - 1)) - base;
+			if (offset + bytes <= block.size) {
+				used = offset + bytes;
+				return block.memory.get() + offset;
+			}
+
+			//the frame needs more memory than the current block: add a new block, large enough for this allocation
+			previousBlocksUsed += used;
+			const size_t size = std::max(block.size * 2, bytes + alignment);
+			blocks.push_back(Block{ std::make_unique<std::byte[]>(size), size });
+			used = 0;
+			return allocateBytes(bytes, alignment);
+		}
+
+
+		/**
+		 * @brief Frees all the allocations. If the frame needed more than one block, the blocks are replaced by a single one, large enough for the whole frame.
+		 */
+		void reset() {
+			if (blocks.size() > 1) {
+				const size_t size = blocks.front().size + previousBlocksUsed + used; //the alignment padding is overestimated, not lost
+				blocks.clear();
+				blocks.push_back(Block{ std::make_unique<std::byte[]>(size), size });
+			}
+			highWater = std::max(highWater, previousBlocksUsed + used);
+			previousBlocksUsed = 0;
+			used = 0;
+		}
+
+
+		/**
+		 * @brief Returns the size in bytes of the current block.
+		 */
+		size_t getCapacity() const {
+			return blocks.back().size;
+		}
+
+
+		/**
+		 * @brief Returns the most bytes allocated in a single frame (till the last reset).
+		 */
+		size_t getHighWater() const {
+			return highWater;
+		}
+
+
+	private:
+
+		struct Block {
+			std::unique_ptr<std::byte[]> memory;
+			size_t size;
+		};
+
+		std::vector<Block> blocks; //the last one is the one allocations are taken from
+		size_t used = 0; //bytes of the last block already allocated
+		size_t previousBlocksUsed = 0; //bytes allocated in the other blocks during the current frame
+		size_t highWater = 0;
+	};
+
+}
+
+
+#endif
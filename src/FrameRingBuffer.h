@@ -0,0 +1,67 @@
+#ifndef VULKAN_FRAMERINGBUFFER
+#define VULKAN_FRAMERINGBUFFER
+
+#include <vulkan/vulkan.h>
+#include <string>
+
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "UniformBuffer.h"
+#include "VulkanException.h"
+
+
+namespace Vulkan::Buffers { class FrameRingBuffer; }
+
+
+/**
+ * @brief A UniformBuffer with a region for each frame in flight, so that the CPU fills the region of a frame while the GPU still reads the regions of the previous frames.
+ * @details The regions are used in turn, following the frames of the Drawer (see Drawer::waitForFrame): fillBuffer writes to the current region, and the sets point their descriptors at it through the dynamic offsets.
+ *			The layout of a region is the layout of the whole buffer of a set (the offsets of the bindings are relative to the region).
+ */
+class Vulkan::Buffers::FrameRingBuffer : public UniformBuffer {
+public:
+
+	/**
+	 * @param regionSize The size of a region, rounded up to minUniformBufferOffsetAlignment (the alignment of the dynamic offsets).
+	 * @param framesInFlight The number of regions, as the frames in flight of the Drawer.
+	 */
+	FrameRingBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t regionSize, unsigned int framesInFlight) : UniformBuffer{ virtualGpu, realGpu, alignRegion(realGpu, regionSize) * framesInFlight }, regionSize{ alignRegion(realGpu, regionSize) }, framesInFlight{ framesInFlight } {}
+
+
+
+	/**
+	 * @brief Selects the region of a frame in flight: the next fillBuffer(s), and the next bindings of the descriptors which use this buffer, use it.
+	 * @details To be called when the GPU has finished the last frame which used the region, i.e. after Drawer::waitForFrame.
+	 */
+	void setFrame(unsigned int frame) {
+		if (frame >= framesInFlight) {
+			throw VulkanException{ "Failed to select the region of the frame", "The buffer has " + std::to_string(framesInFlight) + " regions" };
+		}
+		regionOffset = static_cast<uint32_t>(frame * regionSize);
+	}
+
+
+	size_t getRegionSize() const {
+		return regionSize;
+	}
+
+
+	unsigned int getFramesInFlight() const {
+		return framesInFlight;
+	}
+
+
+private:
+
+	static size_t alignRegion(const PhysicalDevice& realGpu, size_t regionSize) {
+		const size_t alignment = realGpu.getProperties().limits.minUniformBufferOffsetAlignment;
+		return (regionSize + alignment - 1) / alignment * alignment;
+	}
+
+
+	const size_t regionSize;
+	const unsigned int framesInFlight;
+};
+
+
+#endif
@@ -2,6 +2,7 @@
 #define VULKAN_GAMESTATUS
 
 #include <vector>
+#include <stdexcept>
 
 #include "Hitbox.h"
 #include "Universe.h"
@@ -43,10 +44,28 @@ using Lights = struct {
 	alignas(16) glm::vec3 dzColor;
 
 	alignas(16) glm::vec3 eyePosition;
-
-	alignas(16) glm::vec2 shadersToUse;
 };
 
+
+/**
+ * @brief Returns the position of the i-th point light (the ones with a position, from position0 to position8).
+ */
+inline glm::vec3& getPointLightPosition(Lights& lights, int slot) {
+	switch (slot) {
+	case 0: return lights.position0;
+	case 1: return lights.position1;
+	case 2: return lights.position2;
+	case 3: return lights.position3;
+	case 4: return lights.position4;
+	case 5: return lights.position5;
+	case 6: return lights.position6;
+	case 7: return lights.position7;
+	case 8: return lights.position8;
+	default: throw std::out_of_range{ "There are only 9 point lights" };
+	}
+}
+
+
 class GameStatus {
 public:
 
@@ -216,7 +235,7 @@ private:
 
 	void deactivateAllBumpers() {
 		for (int i = 0; i < bumpers.size(); ++i) {
-			pointLightsInfo[i].first = { 0.0f, 0.0f, 0.0f };
+			setPointLight(i, false);
 			activeBumpers[i] = false;
 		}
 		checkLight();
@@ -225,6 +244,9 @@ private:
 
 
 	void invertLight(int i) {
+		if (static_cast<size_t>(i) >= pointLightsInfo.size()) {
+			return;
+		}
 		if (pointLightsInfo[i].first == glm::vec3{0.0f, 0.0f, 0.0f}) {
 			setPointLight(i, true);
 		}
@@ -235,6 +257,9 @@ private:
 
 
 	void setPointLight(int i, bool isOn, glm::vec3 color = {1.0f, 0.0f, 0.0f}) {
+		if (static_cast<size_t>(i) >= pointLightsInfo.size()) {
+			return; //there are more objects than point lights (e.g. in a stress table): only the first ones have a light
+		}
 		if (isOn) {
 			pointLightsInfo[i].first = color;
 		}
@@ -1,10 +1,16 @@
 #ifndef VULKAN_HITBOX
 #define VULKAN_HITBOX
 
+#include <algorithm>
 #include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
 
 #include "Cinematicable.h"
 #include "Segment.h"
+#include "PlanarRotation.h"
 
 
 namespace Vulkan::Physics::FieldFunctions {
@@ -15,11 +21,12 @@ namespace Vulkan::Physics {
 
 	/**
 	 * @brief A Hitbox is a Cinematicable object which can directly interact with other objects upon collision.
+	 * @details Hitboxes live on the xy plane, so they can only rotate around the z axis. Their rotation is a PlanarRotation, and the quaternion of Moveable is built only when getRotation is called (by the graphics).
 	 */
 	class Hitbox : public Cinematicable {
 	public:
 		Hitbox(Position position = {0.0f, 0.0f, 0.0f}, float scaleFactor = 1.0f, Mass mass = 1.0f, Speed initialSpeed = {0.0f, 0.0f, 0.0f}, Acceleration initialAcceleration = {0.0f, 0.0f, 0.0f}, Force internalForce = {0.0f, 0.0f, 0.0f}, Field emittedField = Field{ {0.0f, 0.0f, 0.0f}, FieldFunctions::emptyField }) :
-			Cinematicable{ position, { 0.0f, 0.0f, 0.0f }, mass, initialSpeed, initialAcceleration, internalForce, 0.0f, emittedField }, scaleFactor{ scaleFactor }, onCollisionAction{ [](Hitbox&) {} }
+			Cinematicable{ position, { 0.0f, 0.0f, 0.0f }, mass, initialSpeed, initialAcceleration, internalForce, 0.0f, emittedField }, scaleFactor{ scaleFactor }
 		{}
 
 		virtual float getScaleFactor() const {
@@ -33,16 +40,62 @@ namespace Vulkan::Physics {
 		}
 
 		virtual void onCollision(Hitbox& collidingObject) {
-			onCollisionAction(collidingObject);
+			if (onCollisionAction) {
+				onCollisionAction(collidingObject);
+			}
 		}
 
 		virtual void setCollisionAction(const std::function<void(Hitbox&)>& action) {
 			onCollisionAction = action;
 		}
 
+		//whether onCollision calls an action
+		bool hasCollisionAction() const {
+			return static_cast<bool>(onCollisionAction);
+		}
+
+
+		/**
+		 * @brief Rotates the hitbox. Throws std::invalid_argument if the axis is not the z axis.
+		 */
+		virtual Moveable& rotate(float angle, glm::vec3 axis) override {
+			if (axis.x != 0.0f || axis.y != 0.0f || axis.z == 0.0f) {
+				throw std::invalid_argument{ "A Hitbox can only rotate around the z axis" };
+			}
+			std::scoped_lock lock{ mutex };
+			planarRotation.rotate(axis.z > 0.0f ? angle : -angle);
+			return *this;
+		}
+
+		virtual PlanarRotation getPlanarRotation() const {
+			std::scoped_lock lock{ mutex };
+			return planarRotation;
+		}
+
+		virtual glm::quat getRotation() const override {
+			std::scoped_lock lock{ mutex };
+			return planarRotation.toQuaternion();
+		}
+
+		virtual glm::vec3 getRotationEuler() const override {
+			auto rotation = getRotation();
+			return { glm::yaw(rotation), glm::pitch(rotation), glm::roll(rotation) };
+		}
+
+		using Moveable::setRotation;
+
+		/**
+		 * @brief Sets the rotation of the hitbox. Only the rotation around z is kept.
+		 */
+		virtual void setRotation(glm::quat rotation) override {
+			std::scoped_lock lock{ mutex };
+			planarRotation.setAngle(PlanarRotation::angleAroundZ(rotation));
+		}
+
 	protected:
 		float scaleFactor;
-		std::function<void(Hitbox&)> onCollisionAction;
+		std::function<void(Hitbox&)> onCollisionAction; //empty if the hitbox has no action
+		PlanarRotation planarRotation;
 
 	};
 
@@ -97,10 +150,17 @@ namespace Vulkan::Physics {
 		}
 
 
-		const Segment& operator[](int i) const {
-			auto v1 = Moveable::getRotation() * glm::vec3(vertices[i]);
-			auto v2 = Moveable::getRotation() * glm::vec3(vertices[i + 1]);
-			return Segment{ v1 + (getPosition() - Position{}), v2 + (getPosition() - Position{})}; //returns the i-th segment in the "real" reference system
+		FrameHitbox(Position position, float scaleFactor, std::vector<Position> frameVertices) : Hitbox{ position, scaleFactor, std::numeric_limits<float>::max() / 10.0f }, vertices{ std::move(frameVertices) } {}
+
+
+		FrameHitbox(Position position, float scaleFactor, Mass mass, std::vector<Position> frameVertices) : Hitbox{ position, scaleFactor, mass }, vertices{ std::move(frameVertices) } {}
+
+
+		Segment operator[](int i) const {
+			auto rotation = getPlanarRotation();
+			auto v1 = rotation.apply(vertices[i]);
+			auto v2 = rotation.apply(vertices[i + 1]);
+			return Segment{ getPosition() + DeltaSpace{ v1 }, getPosition() + DeltaSpace{ v2 } }; //returns the i-th segment in the "real" reference system
 		}
 
 
@@ -113,6 +173,235 @@ namespace Vulkan::Physics {
 		std::vector<Position> vertices; //these vertices are considered in a reference system with origin in the center of this hitbox
 	};
 
+
+
+	/**
+	 * @brief Where a circle touches a closed shape.
+	 */
+	struct Contact {
+		DeltaSpace normal; //versor from the center of the circle towards the shape (the same convention of Segment::normal(p))
+		Position point; //the point of the surface of the shape touched by the circle
+		float depth; //how much the circle went inside the shape
+	};
+
+
+
+	/**
+	 * @brief A CapsuleHitbox is a segment with a thickness: all the points closer than its radius to the segment. It is the shape of the flippers.
+	 * @details As for FrameHitbox, the ends of the segment are in the reference system of the hitbox and are not scaled, while the radius is scaled as the one of a CircleHitbox.
+	 */
+	class CapsuleHitbox : public Hitbox {
+	public:
+
+		CapsuleHitbox(Position position, float scaleFactor, Position from, Position to, float radius) : CapsuleHitbox{ position, scaleFactor, std::numeric_limits<float>::max() / 10.0f, from, to, radius } {}
+
+
+		CapsuleHitbox(Position position, float scaleFactor, Mass mass, Position from, Position to, float radius) : Hitbox{ position, scaleFactor, mass }, from{ from }, to{ to }, radius{ radius } {}
+
+
+		/**
+		 * @brief Returns the segment at the core of the capsule, in the "real" reference system.
+		 */
+		Segment getSegment() const {
+			auto rotation = getPlanarRotation();
+			return Segment{ getPosition() + DeltaSpace{ rotation.apply(from) }, getPosition() + DeltaSpace{ rotation.apply(to) } };
+		}
+
+
+		/**
+		 * @brief Returns the radius, scaled.
+		 */
+		float getRadius() const {
+			return radius * scaleFactor;
+		}
+
+		/**
+		 * @brief Sets the radius before the scale is applied.
+		 */
+		void setRadius(float radius) {
+			this->radius = radius;
+		}
+
+
+		/**
+		 * @brief Returns the point of the capsule farthest along a direction (the support point of separating axis tests).
+		 */
+		Position support(const DeltaSpace& direction) const {
+			auto segment = getSegment();
+			glm::vec3 d = glm::normalize(glm::vec3(direction));
+			Position end = glm::dot(glm::vec3(segment.getDirection()), d) > 0.0f ? segment.getEnd() : segment.getOrigin();
+			return end + DeltaSpace{ d * getRadius() };
+		}
+
+
+		/**
+		 * @brief Returns where a circle touches the capsule, if it does.
+		 */
+		std::optional<Contact> contact(const Position& center, float circleRadius) const {
+			auto segment = getSegment();
+			glm::vec3 origin = segment.getOrigin();
+			glm::vec3 direction = segment.getDirection();
+			glm::vec3 c = center;
+
+			//closest point of the segment to the center of the circle
+			float squaredLength = glm::dot(direction, direction);
+			float t = squaredLength > 0.0f ? std::clamp(glm::dot(c - origin, direction) / squaredLength, 0.0f, 1.0f) : 0.0f;
+			glm::vec3 closest = origin + direction * t;
+
+			const float scaledRadius = getRadius();
+			glm::vec3 toCenter = c - closest;
+			float distance = glm::length(toCenter);
+			if (distance > scaledRadius + circleRadius) {
+				return std::nullopt;
+			}
+			glm::vec3 outward = distance > 0.0f ? toCenter / distance : glm::normalize(glm::vec3{ direction.y, -direction.x, 0.0f }); //the center is on the segment: any normal works
+			return Contact{ DeltaSpace{ -outward }, Position{ closest + outward * scaledRadius }, scaledRadius + circleRadius - distance };
+		}
+
+
+	private:
+		Position from; //in the reference system of the hitbox
+		Position to;
+		float radius; //not scaled
+	};
+
+
+
+	/**
+	 * @brief A ConvexPolygonHitbox is a closed convex obstacle.
+	 * @details The normals of the edges are computed once, in the reference system of the hitbox, and are the axes of the separating axis tests: touching a circle costs a single test, instead of a distance test for each segment of an equivalent FrameHitbox.
+	 *			As for FrameHitbox, the vertices are in the reference system of the hitbox and are not scaled.
+	 */
+	class ConvexPolygonHitbox : public Hitbox {
+	public:
+
+		/**
+		 * @brief Builds the polygon. Throws std::invalid_argument if there are less than 3 vertices or the polygon is not convex.
+		 *
+		 * @param vertices The vertices, either clockwise or counterclockwise. The last one is connected to the first one.
+		 */
+		ConvexPolygonHitbox(Position position, float scaleFactor, std::vector<Position> vertices) : ConvexPolygonHitbox{ position, scaleFactor, std::numeric_limits<float>::max() / 10.0f, std::move(vertices) } {}
+
+
+		ConvexPolygonHitbox(Position position, float scaleFactor, Mass mass, std::vector<Position> vertices) : Hitbox{ position, scaleFactor, mass }, vertices{ std::move(vertices) } {
+			if (this->vertices.size() < 3) {
+				throw std::invalid_argument{ "A ConvexPolygonHitbox needs at least 3 vertices" };
+			}
+
+			//counterclockwise, so that the normals (y, -x) of the edges point outside
+			float doubleArea = 0.0f;
+			for (size_t i = 0; i < this->vertices.size(); ++i) {
+				glm::vec3 v1 = this->vertices[i], v2 = this->vertices[(i + 1) % this->vertices.size()];
+				doubleArea += v1.x * v2.y - v2.x * v1.y;
+			}
+			if (doubleArea < 0.0f) {
+				std::reverse(this->vertices.begin(), this->vertices.end());
+			}
+
+			for (size_t i = 0; i < this->vertices.size(); ++i) {
+				glm::vec3 edge = glm::vec3(this->vertices[(i + 1) % this->vertices.size()]) - glm::vec3(this->vertices[i]);
+				glm::vec3 next = glm::vec3(this->vertices[(i + 2) % this->vertices.size()]) - glm::vec3(this->vertices[(i + 1) % this->vertices.size()]);
+				if (edge.x * next.y - next.x * edge.y < 0.0f || glm::dot(edge, edge) == 0.0f) {
+					throw std::invalid_argument{ "The vertices of a ConvexPolygonHitbox must describe a convex polygon" };
+				}
+				normals.push_back(glm::normalize(glm::vec3{ edge.y, -edge.x, 0.0f }));
+			}
+		}
+
+
+		size_t getNumberOfVertices() const {
+			return vertices.size();
+		}
+
+		/**
+		 * @brief Returns the i-th vertex (counterclockwise) in the "real" reference system.
+		 */
+		Position getVertex(size_t i) const {
+			return getPosition() + DeltaSpace{ getPlanarRotation().apply(vertices[i]) };
+		}
+
+		/**
+		 * @brief Returns the outward normal of the edge from the i-th vertex to the next one, in the "real" reference system.
+		 */
+		DeltaSpace getNormal(size_t i) const {
+			return getPlanarRotation().apply(normals[i]);
+		}
+
+
+		/**
+		 * @brief Returns the vertex of the polygon farthest along a direction (the support point of separating axis tests).
+		 */
+		Position support(const DeltaSpace& direction) const {
+			glm::vec3 d = getPlanarRotation().applyInverse(direction);
+			size_t best = 0;
+			for (size_t i = 1; i < vertices.size(); ++i) {
+				if (glm::dot(glm::vec3(vertices[i]), d) > glm::dot(glm::vec3(vertices[best]), d)) {
+					best = i;
+				}
+			}
+			return getVertex(best);
+		}
+
+
+		/**
+		 * @brief Returns where a circle touches the polygon, if it does.
+		 * @details The test happens in the reference system of the polygon, so that the precomputed normals are used as they are. The edge normal with the largest separation is either a separating axis (no contact) or, depending on where the center projects on its edge, the normal of the contact or the hint that the closest feature is a vertex.
+		 */
+		std::optional<Contact> contact(const Position& center, float circleRadius) const {
+			auto rotation = getPlanarRotation();
+			glm::vec3 c = rotation.applyInverse(center - getPosition());
+
+			//separating axis test on the normals of the edges
+			size_t edge = 0;
+			float separation = std::numeric_limits<float>::lowest();
+			for (size_t i = 0; i < normals.size(); ++i) {
+				float s = glm::dot(normals[i], c - glm::vec3(vertices[i]));
+				if (s > circleRadius) {
+					return std::nullopt;
+				}
+				if (s > separation) {
+					separation = s;
+					edge = i;
+				}
+			}
+
+			glm::vec3 v1 = vertices[edge];
+			glm::vec3 v2 = vertices[(edge + 1) % vertices.size()];
+			glm::vec3 outward = normals[edge];
+			glm::vec3 point = c - outward * separation;
+			float distance = separation;
+
+			//the center is outside, next to a vertex rather than to the edge
+			if (separation > 0.0f) {
+				glm::vec3 vertex{};
+				if (glm::dot(c - v1, v2 - v1) <= 0.0f) {
+					vertex = v1;
+				}
+				else if (glm::dot(c - v2, v1 - v2) <= 0.0f) {
+					vertex = v2;
+				}
+				else {
+					vertex = point;
+				}
+				distance = glm::length(c - vertex);
+				if (distance > circleRadius) {
+					return std::nullopt;
+				}
+				if (distance > 0.0f) {
+					outward = (c - vertex) / distance;
+				}
+				point = vertex;
+			}
+
+			return Contact{ DeltaSpace{ rotation.apply(-outward) }, getPosition() + DeltaSpace{ rotation.apply(point) }, circleRadius - distance };
+		}
+
+
+	private:
+		std::vector<Position> vertices; //counterclockwise, in the reference system of the hitbox
+		std::vector<glm::vec3> normals; //outward normals of the edges, in the reference system of the hitbox
+	};
+
 }
 
 
@@ -4,19 +4,19 @@
 #include "LogicalDevice.h"
 #include "PhysicalDevice.h"
 #include "VulkanException.h"
-#include "Buffer.h" //for the findSuitableMemoryType function
+#include "MemoryAllocator.h"
 
 #include <iostream>
 
 
-Vulkan::Image::Image(const VkImage& image, const LogicalDevice& virtualGpu, VkFormat format, std::pair<unsigned int, unsigned int> resolution) : image{ image }, format{ format }, virtualGpu{ &virtualGpu }, isSwapchainImage{ true }, allocatedMemory{ VK_NULL_HANDLE }, layout{ VK_IMAGE_LAYOUT_UNDEFINED }, resolution{ resolution } {
+Vulkan::Image::Image(const VkImage& image, const LogicalDevice& virtualGpu, VkFormat format, std::pair<unsigned int, unsigned int> resolution) : image{ image }, format{ format }, virtualGpu{ &virtualGpu }, isSwapchainImage{ true }, layout{ VK_IMAGE_LAYOUT_UNDEFINED }, resolution{ resolution } {
 	generateImageView("base", virtualGpu);
 	std::cout << "\n+ Image created";
 }
 
 
 
-Vulkan::Image::Image() : image{ VK_NULL_HANDLE }, allocatedMemory{ VK_NULL_HANDLE }, format{ VK_FORMAT_UNDEFINED }, virtualGpu{ nullptr }, isSwapchainImage{ false }, layout{ VK_IMAGE_LAYOUT_UNDEFINED }, resolution{ 0,0 }{}
+Vulkan::Image::Image() : image{ VK_NULL_HANDLE }, format{ VK_FORMAT_UNDEFINED }, virtualGpu{ nullptr }, isSwapchainImage{ false }, layout{ VK_IMAGE_LAYOUT_UNDEFINED }, resolution{ 0,0 }{}
 
 
 
@@ -42,8 +42,8 @@ Vulkan::Image::~Image() {
 	if (image != VK_NULL_HANDLE && !isSwapchainImage) {
 		vkDestroyImage(+*virtualGpu, image, nullptr);
 	}
-	if (allocatedMemory != VK_NULL_HANDLE && !isSwapchainImage) {
-		vkFreeMemory(+*virtualGpu, allocatedMemory, nullptr);
+	if (allocation.memory != VK_NULL_HANDLE && !isSwapchainImage) {
+		virtualGpu->getMemoryAllocator().free(allocation);
 	}
 	std::cout << "\n- Image destroyed";
 }
@@ -59,6 +59,11 @@ VkFormat Vulkan::Image::getFormat() const {
 }
 
 
+uint32_t Vulkan::Image::getMipLevels() const {
+	return mipLevels;
+}
+
+
 
 const Vulkan::ImageView& Vulkan::Image::generateImageView(std::string tag, const LogicalDevice& virtualGpu, VkImageAspectFlags type) {
 	auto res = views.emplace(std::piecewise_construct,
@@ -99,8 +104,9 @@ void Vulkan::swap(Image& lhs, Image& rhs) {
 	swap(lhs.image, rhs.image);
 	swap(lhs.format, rhs.format);
 	swap(lhs.views, rhs.views);
-	swap(lhs.allocatedMemory, rhs.allocatedMemory);
+	swap(lhs.allocation, rhs.allocation);
 	swap(lhs.virtualGpu, rhs.virtualGpu);
 	swap(lhs.isSwapchainImage, rhs.isSwapchainImage);
 	swap(lhs.resolution, rhs.resolution);
+	swap(lhs.mipLevels, rhs.mipLevels);
 }
\ No newline at end of file
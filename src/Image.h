@@ -8,7 +8,7 @@
 #include "ImageView.h"
 #include "LogicalDevice.h"
 #include "VulkanException.h"
-#include "Buffer.h"
+#include "MemoryAllocator.h"
 
 namespace Vulkan { class Image; class LogicalDevice; class PhysicalDevice; class ImageView; namespace SwapchainOptions { class SurfaceFormat; } }
 
@@ -38,6 +38,12 @@ class Vulkan::Image {
 		VkFormat getFormat() const;
 
 
+		/**
+		 * @brief Returns the number of mip levels of the image; the image views include all of them.
+		 */
+		uint32_t getMipLevels() const;
+
+
 		/**
 		 * @brief Creates a new image view for this image, and adds it to the array of image views of this image, on last position.
 		 * 
@@ -84,14 +90,18 @@ class Vulkan::Image {
 
 		//Used by child classes only
 		template<std::same_as<VkMemoryPropertyFlagBits>... P>
-		Image(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, VkFormat format, std::pair<unsigned int, unsigned int> resolution, VkImageTiling tiling, VkImageUsageFlags usage, P... memoryProperties) : virtualGpu{ &virtualGpu }, format{ format }, isSwapchainImage{ false }, layout{ VK_IMAGE_LAYOUT_UNDEFINED }, resolution{ resolution }{
+		Image(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, VkFormat format, std::pair<unsigned int, unsigned int> resolution, VkImageTiling tiling, VkImageUsageFlags usage, P... memoryProperties) : Image{ virtualGpu, realGpu, format, resolution, 1, tiling, usage, memoryProperties... } {}
+
+		//Used by child classes only, for images with mip levels (e.g. textures)
+		template<std::same_as<VkMemoryPropertyFlagBits>... P>
+		Image(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, VkFormat format, std::pair<unsigned int, unsigned int> resolution, uint32_t mipLevels, VkImageTiling tiling, VkImageUsageFlags usage, P... memoryProperties) : virtualGpu{ &virtualGpu }, format{ format }, isSwapchainImage{ false }, layout{ VK_IMAGE_LAYOUT_UNDEFINED }, resolution{ resolution }, mipLevels{ mipLevels }{
 			VkImageCreateInfo imageInfo{};
 			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			imageInfo.imageType = VK_IMAGE_TYPE_2D;
 			imageInfo.extent.width = resolution.first;
 			imageInfo.extent.height = resolution.second;
 			imageInfo.extent.depth = 1;
-			imageInfo.mipLevels = 1;
+			imageInfo.mipLevels = mipLevels;
 			imageInfo.arrayLayers = 1;
 			imageInfo.format = format;
 			imageInfo.tiling = tiling;
@@ -104,19 +114,14 @@ class Vulkan::Image {
 				throw VulkanException("Failed to create image!", result);
 			}
 
-			VkMemoryRequirements memRequirements;
-			vkGetImageMemoryRequirements(+virtualGpu, image, &memRequirements);
-
-			VkMemoryAllocateInfo allocInfo{};
-			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			allocInfo.allocationSize = memRequirements.size;
-			allocInfo.memoryTypeIndex = Buffers::Buffer::findSuitableMemoryIndex(realGpu, memRequirements.memoryTypeBits, memoryProperties...);
-
-			if (VkResult result = vkAllocateMemory(+virtualGpu, &allocInfo, nullptr, &allocatedMemory); result != VK_SUCCESS) {
-				throw VulkanException("Failed to allocate image memory!", result);
+			//get the memory from the allocator of the device (large images get a dedicated allocation) and associate it with the image
+			try {
+				allocation = virtualGpu.getMemoryAllocator().allocateForImage(image, tiling, (0 | ... | memoryProperties));
+			}
+			catch (...) {
+				vkDestroyImage(+virtualGpu, image, nullptr);
+				throw;
 			}
-
-			vkBindImageMemory(+virtualGpu, image, allocatedMemory, 0);
 		}
 		
 		
@@ -124,8 +129,9 @@ class Vulkan::Image {
 		VkFormat format;
 		VkImageLayout layout;
 		std::pair<unsigned int, unsigned int> resolution;
+		uint32_t mipLevels = 1;
 		std::map<std::string, ImageView> views;
-		VkDeviceMemory allocatedMemory;
+		MemoryAllocator::Allocation allocation;
 		LogicalDevice const* virtualGpu;
 		bool isSwapchainImage; //if an image is created automatically by the swapchain, it doesn't have to be explicitly destroyed
 };
@@ -2,11 +2,14 @@
 #define VULKAN_INDEXBUFFER
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
 
 #include "LogicalDevice.h"
 #include "PhysicalDevice.h"
 #include "VulkanException.h"
 #include "Buffer.h"
+#include "UploadContext.h"
 #include "Model.h"
 
 
@@ -15,37 +18,54 @@ namespace Vulkan::Buffers { class IndexBuffer; }
 class Vulkan::Buffers::IndexBuffer : public Buffer {
 public:
 
-    IndexBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+    /**
+     * @brief Creates a streaming index buffer, in host visible memory mapped for the whole lifetime of the buffer, for indexes which change at run-time.
+     */
+    IndexBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT }, VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_COHERENT_BIT }) {
+        mapPersistently();
+    }
+
+
+    /**
+     * @brief Creates an index buffer in device local memory, for static geometry.
+     * @details fillBuffer stages the indexes in uploadContext, so they reach the buffer when the context is submitted.
+     */
+    IndexBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size, UploadContext& uploadContext) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT), uploadContext{ &uploadContext } {
 
     }
 
 
     template<typename... C, template<typename...> class... M> requires (std::same_as<M<C...>, Objects::Model<C...>> && ...)
         void fillBuffer(const M<C...>&... models) {
-        std::vector<uint32_t> data{};
-        
-        unsigned int currentOffset = 0;
-        unsigned int totalVertices = 0; //how many vertices (NOT indexes) are there in the models from 0 to current
-        ([this, &currentOffset, &totalVertices, &data](const M<C...>& model) {
-            //copy all the vertices to one vector
-            for (auto index : model.getIndexes()) {
-                data.push_back(index + totalVertices);
+        modelOffsets.clear();
+        unsigned int count = 0;
+        ((modelOffsets.push_back(count), count += models.getIndexes().size()), ...); //save the offset of each model
+
+        upload(count, [&models...](uint32_t* destination) {
+            unsigned int totalVertices = 0; //how many vertices (NOT indexes) are there in the models from 0 to current
+            ((destination = appendModel(models, destination, totalVertices)), ...);
+            });
+    }
+
+
+    /**
+     * @brief Fills the buffer with the indexes of models whose number is known only at run-time (e.g. the models of a table file).
+     */
+    template<typename V, typename... S>
+    void fillBuffer(const std::vector<Objects::Model<V, S...>*>& models) {
+        modelOffsets.clear();
+        unsigned int count = 0;
+        for (auto model : models) {
+            modelOffsets.push_back(count); //save the offset of each model
+            count += model->getIndexes().size();
+        }
+
+        upload(count, [&models](uint32_t* destination) {
+            unsigned int totalVertices = 0; //how many vertices (NOT indexes) are there in the models from 0 to current
+            for (auto model : models) {
+                destination = appendModel(*model, destination, totalVertices);
             }
-            
-            modelOffsets.push_back(currentOffset); //save the offset for this model
-            currentOffset += model.getIndexes().size(); //increase next offset
-            totalVertices += model.getVertices().size(); //increas the total number of vertices present in the models so far
-        }(models), ...);
-        modelOffsets.push_back(currentOffset); //save the last offset (= indexesCount) in order to speed up the getModelIndexesCount function
-        indexesCount = data.size();
-
-        //TODO staging buffer
-
-        //copy data to vertex buffer
-        void* rawData;
-        vkMapMemory(+virtualGpu, bufferMemory, 0, data.size() * sizeof(data[0]), 0, &rawData);
-        memcpy(rawData, data.data(), data.size() * sizeof(data[0]));
-        vkUnmapMemory(+virtualGpu, bufferMemory);
+            });
     }
 
 
@@ -71,6 +91,40 @@ public:
 
 private:
 
+    //copies the indexes of model to destination, shifted by the vertices of the previous models, and returns where the next model begins
+    template<typename V, typename... S>
+    static uint32_t* appendModel(const Objects::Model<V, S...>& model, uint32_t* destination, unsigned int& totalVertices) {
+        for (auto index : model.getIndexes()) {
+            *destination++ = index + totalVertices;
+        }
+        totalVertices += model.getVertices().size(); //increas the total number of vertices present in the models so far
+        return destination;
+    }
+
+
+    //lets write copy count indexes straight into the memory the GPU reads (streaming buffer) or into the staging memory (device local buffer)
+    template<typename F>
+    void upload(unsigned int count, F&& write) {
+        modelOffsets.push_back(count); //save the last offset (= indexesCount) in order to speed up the getModelIndexesCount function
+        indexesCount = count;
+
+        if (uploadContext != nullptr) {
+            write(reinterpret_cast<uint32_t*>(uploadContext->stage(*this, count * sizeof(uint32_t)).data()));
+            return;
+        }
+
+        if (count * sizeof(uint32_t) > size) {
+            throw VulkanException{ "Failed to fill the index buffer", "The indexes don't fit in the buffer" };
+        }
+        write(reinterpret_cast<uint32_t*>(mapped));
+        if (!isCoherent()) {
+            dirtyRanges.add(0, count * sizeof(uint32_t));
+            flush();
+        }
+    }
+
+
+    UploadContext* uploadContext = nullptr; //if the buffer is device local
     unsigned int indexesCount;
     std::vector<unsigned int> modelOffsets;
 };
@@ -0,0 +1,471 @@
+#ifndef VULKAN_JOBSYSTEM
+#define VULKAN_JOBSYSTEM
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace Vulkan::Utilities {
+
+	/**
+	 * @brief Notified by the JobSystem when a job starts and ends, e.g. to trace the jobs on a timeline.
+	 * @details The methods are called by the thread which runs the job, so they must be thread safe. thread is the index of that thread (see JobSystem::getThreadIndex).
+	 */
+	class JobObserver {
+	public:
+		virtual void onJobBegin(const char* name, unsigned int thread) = 0;
+		virtual void onJobEnd(const char* name, unsigned int thread) = 0;
+	};
+
+
+
+	/**
+	 * @brief Counts the jobs submitted with it which have not finished yet, so that JobSystem::wait can wait for them.
+	 * @details If a job throws, the jobs of the same counter which have not started yet are skipped, and JobSystem::wait rethrows the first exception. The counter can be used again after the wait.
+	 */
+	class JobCounter {
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+
+		bool isDone() const {
+			return pending.load(std::memory_order_acquire) == 0;
+		}
+
+
+	private:
+		friend class JobSystem;
+
+		void fail(std::exception_ptr exception) {
+			std::lock_guard lock{ errorMutex };
+			if (!error) {
+				error = exception;
+			}
+			failed.store(true, std::memory_order_relaxed);
+		}
+
+
+		std::atomic<uint32_t> pending{ 0 };
+		std::atomic<bool> failed{ false };
+		std::mutex errorMutex;
+		std::exception_ptr error;
+	};
+
+
+
+	/**
+	 * @brief A set of tasks and of the dependencies among them, run by JobSystem::run.
+	 * @details A task starts only when all the tasks it depends on are finished; tasks without a dependency between them can run at the same time. A task can depend only on tasks added before it, so the graph has no cycles.
+	 *			The graph can be run many times (e.g. once per frame), but not by 2 threads at the same time.
+	 */
+	class TaskGraph {
+	public:
+
+		using TaskId = size_t;
+
+
+		/**
+		 * @brief Adds a task.
+		 *
+		 * @param work The work of the task.
+		 * @param dependencies The tasks which must be finished before this task starts.
+		 * @param name The name of the task for the JobObserver. It must outlive the graph (e.g. a string literal).
+		 * @return The id of the task, to be used as a dependency of the tasks added later.
+		 */
+		TaskId add(std::function<void()> work, const std::vector<TaskId>& dependencies = {}, const char* name = "task") {
+			const TaskId id = tasks.size();
+			for (auto dependency : dependencies) {
+				if (dependency >= id) {
+					throw std::out_of_range{ "A task can depend only on the tasks added before it" };
+				}
+			}
+
+			auto& task = tasks.emplace_back();
+			task.work = std::move(work);
+			task.name = name;
+			task.dependencies = static_cast<uint32_t>(dependencies.size());
+			for (auto dependency : dependencies) {
+				tasks[dependency].dependents.push_back(id);
+			}
+			return id;
+		}
+
+
+		size_t size() const {
+			return tasks.size();
+		}
+
+
+	private:
+		friend class JobSystem;
+
+		struct Task {
+			std::function<void()> work;
+			const char* name = nullptr;
+			std::vector<TaskId> dependents;
+			uint32_t dependencies = 0;
+			std::atomic<uint32_t> remaining{ 0 }; //dependencies not finished yet in the current run
+		};
+
+		std::deque<Task> tasks; //a deque, because a task (with its atomic) cannot be moved
+	};
+
+
+
+	/**
+	 * @brief A pool of worker threads which run jobs submitted by any thread.
+	 * @details Each worker has its own queue of jobs: a worker takes the newest job of its own queue (the one whose data is most likely still in its cache) and, when its queue is empty, steals the oldest job of another queue.
+	 *			Threads which don't belong to the system (e.g. the main thread) share a queue.
+	 *			A thread which waits for some jobs (wait, parallelFor, run) runs the jobs it waits for in the meantime, so jobs can wait for other jobs, and a system without workers runs every job on the thread which waits for it.
+	 *			It never runs the jobs of other counters: a frame which waits for its parallelFor doesn't pick up a long job (e.g. a texture load or a pipeline compilation) submitted by someone else.
+	 *			Idle workers sleep, and are woken up when a job is submitted.
+	 */
+	class JobSystem {
+	public:
+
+		/**
+		 * @param workers Number of worker threads. By default, one less than the cores, since the thread which submits the jobs runs them too while it waits.
+		 */
+		JobSystem(unsigned int workers = std::max(1u, std::thread::hardware_concurrency()) - 1) : queues(workers + 1) {
+			for (unsigned int i = 1; i <= workers; ++i) {
+				threads.emplace_back([this, i]() { work(i); });
+			}
+		}
+
+		/**
+		 * @brief Runs the jobs still queued, then stops the workers.
+		 */
+		~JobSystem() {
+			{
+				std::lock_guard lock{ sleepMutex };
+				stopping = true;
+			}
+			wakeUp.notify_all();
+			for (auto& thread : threads) {
+				thread.join();
+			}
+		}
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+
+
+		/**
+		 * @brief Queues a job. The counter must outlive the job (i.e. wait for it before destroying it).
+		 *
+		 * @param counter The counter the job is added to.
+		 * @param work The job, a callable without parameters.
+		 * @param name The name of the job for the JobObserver. It must outlive the job (e.g. a string literal).
+		 */
+		template<typename F>
+		void submit(JobCounter& counter, F&& work, const char* name = "job") {
+			counter.pending.fetch_add(1, std::memory_order_relaxed);
+			push(Job{ std::forward<F>(work), &counter, name });
+		}
+
+
+		/**
+		 * @brief Returns when all the jobs of the counter are finished, running the jobs of the counter in the meantime. Rethrows the first exception thrown by a job of the counter.
+		 */
+		void wait(JobCounter& counter) {
+			const auto thread = getThreadIndex();
+			while (!counter.isDone()) {
+				if (!runOne(thread, &counter)) {
+					std::this_thread::yield();
+				}
+			}
+
+			if (counter.failed.load(std::memory_order_relaxed)) {
+				std::exception_ptr error;
+				{
+					std::lock_guard lock{ counter.errorMutex };
+					error = std::exchange(counter.error, nullptr);
+				}
+				counter.failed.store(false, std::memory_order_relaxed);
+				std::rethrow_exception(error);
+			}
+		}
+
+
+		/**
+		 * @brief Calls body(i) for each i in [begin, end), in parallel, and returns when all the calls are finished.
+		 *
+		 * @param grain Number of consecutive indices processed by a single job. It should be large enough for a job to last some microseconds, or the cost of the scheduling prevails.
+		 * @param body The callable, thread safe, which processes an index.
+		 * @param name The name of the jobs for the JobObserver.
+		 */
+		template<typename F>
+		void parallelFor(size_t begin, size_t end, size_t grain, F&& body, const char* name = "parallelFor") {
+			grain = std::max<size_t>(grain, 1);
+			const auto chunk = [&body, end, grain](size_t first) {
+				const size_t last = end - first > grain ? first + grain : end;
+				for (size_t i = first; i < last; ++i) {
+					body(i);
+				}
+			};
+
+			//each job captures only 2 words, so that std::function keeps it in place instead of allocating it
+			JobCounter counter;
+			for (size_t first = begin; first < end; first = end - first > grain ? first + grain : end) {
+				submit(counter, [&chunk, first]() { chunk(first); }, name);
+			}
+			wait(counter);
+		}
+
+
+		/**
+		 * @brief Runs all the tasks of a graph, each one after its dependencies, and returns when they are all finished. Rethrows the first exception thrown by a task; the tasks not started yet are skipped.
+		 */
+		void run(TaskGraph& graph) {
+			JobCounter counter;
+			counter.pending.store(static_cast<uint32_t>(graph.tasks.size()), std::memory_order_relaxed);
+			for (auto& task : graph.tasks) {
+				task.remaining.store(task.dependencies, std::memory_order_relaxed);
+			}
+			for (auto& task : graph.tasks) {
+				if (task.dependencies == 0) {
+					push(Job{ {}, &counter, task.name, &graph, &task });
+				}
+			}
+			wait(counter);
+		}
+
+
+
+		/**
+		 * @brief Returns the index of the calling thread: from 1 to getWorkersCount for the workers of this system, 0 for any other thread.
+		 */
+		unsigned int getThreadIndex() const {
+			return currentSystem == this ? currentIndex : 0;
+		}
+
+		unsigned int getWorkersCount() const {
+			return static_cast<unsigned int>(threads.size());
+		}
+
+
+		/**
+		 * @brief Starts (or, with nullptr, stops) notifying an observer of the start and of the end of each job.
+		 * @details The observer must outlive the system, or be detached when no job is running.
+		 */
+		void setObserver(JobObserver* observer) {
+			this->observer.store(observer, std::memory_order_release);
+		}
+
+
+
+	private:
+
+		struct Job {
+			std::function<void()> work;
+			JobCounter* counter;
+			const char* name;
+			TaskGraph* graph = nullptr; //if the job is a task of a graph, its work is in the task
+			TaskGraph::Task* task = nullptr;
+		};
+
+
+		//a double-ended queue of jobs in a ring buffer, which grows when full and never shrinks, so that a steady flow of jobs doesn't allocate
+		class JobRing {
+		public:
+			bool empty() const {
+				return count == 0;
+			}
+
+			void pushBack(Job&& job) {
+				if (count == ring.size()) {
+					grow();
+				}
+				ring[(first + count) % ring.size()] = std::move(job);
+				count++;
+			}
+
+			Job popFront() {
+				Job job = std::move(ring[first]);
+				first = (first + 1) % ring.size();
+				count--;
+				return job;
+			}
+
+			Job popBack() {
+				count--;
+				return std::move(ring[(first + count) % ring.size()]);
+			}
+
+			//removes the newest job of a counter, moving the newer jobs back, returns nullopt if the counter has no jobs in the ring
+			std::optional<Job> popNewest(const JobCounter* counter) {
+				for (size_t i = count; i-- > 0;) {
+					if (ring[(first + i) % ring.size()].counter == counter) {
+						Job job = std::move(ring[(first + i) % ring.size()]);
+						for (; i + 1 < count; ++i) {
+							ring[(first + i) % ring.size()] = std::move(ring[(first + i + 1) % ring.size()]);
+						}
+						count--;
+						return job;
+					}
+				}
+				return std::nullopt;
+			}
+
+		private:
+			void grow() {
+				std::vector<Job> larger(std::max<size_t>(ring.size() * 2, 64));
+				for (size_t i = 0; i < count; ++i) {
+					larger[i] = std::move(ring[(first + i) % ring.size()]);
+				}
+				ring = std::move(larger);
+				first = 0;
+			}
+
+			std::vector<Job> ring;
+			size_t first = 0; //the oldest job
+			size_t count = 0;
+		};
+
+
+		struct alignas(64) Queue {
+			std::mutex mutex;
+			JobRing jobs;
+		};
+
+
+
+		//adds a job to the queue of the calling thread, and wakes up a worker if any is sleeping
+		void push(Job&& job) {
+			auto& queue = queues[getThreadIndex()];
+			{
+				std::lock_guard lock{ queue.mutex };
+				queue.jobs.pushBack(std::move(job));
+			}
+			queued.fetch_add(1);
+			if (sleeping.load() > 0) {
+				std::lock_guard lock{ sleepMutex };
+				wakeUp.notify_one();
+			}
+		}
+
+
+		//runs the newest job of the queue of the thread, or else steals the oldest one of another queue, returns false if there were no jobs; if counter isn't null, only its jobs are run
+		bool runOne(unsigned int thread, const JobCounter* counter = nullptr) {
+			if (queued.load(std::memory_order_relaxed) == 0) {
+				return false;
+			}
+
+			auto job = take(queues[thread], false, counter);
+			for (size_t i = 1; !job && i < queues.size(); ++i) {
+				job = take(queues[(thread + i) % queues.size()], true, counter);
+			}
+			if (!job) {
+				return false;
+			}
+			execute(*job, thread);
+			return true;
+		}
+
+
+		std::optional<Job> take(Queue& queue, bool oldest, const JobCounter* counter) {
+			std::lock_guard lock{ queue.mutex };
+			if (queue.jobs.empty()) {
+				return std::nullopt;
+			}
+			std::optional<Job> job = counter != nullptr ? queue.jobs.popNewest(counter) : std::optional<Job>{ oldest ? queue.jobs.popFront() : queue.jobs.popBack() };
+			if (job) {
+				queued.fetch_sub(1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+
+		void execute(Job& job, unsigned int thread) {
+			auto& counter = *job.counter;
+			if (!counter.failed.load(std::memory_order_relaxed)) {
+				auto observer = this->observer.load(std::memory_order_acquire);
+				if (observer != nullptr) {
+					observer->onJobBegin(job.name, thread);
+				}
+				try {
+					job.task != nullptr ? job.task->work() : job.work();
+				} catch (...) {
+					counter.fail(std::current_exception());
+				}
+				if (observer != nullptr) {
+					observer->onJobEnd(job.name, thread);
+				}
+			}
+
+			//the dependents are queued before the job is counted as finished, since the graph can be destroyed as soon as the last job is finished
+			if (job.task != nullptr) {
+				for (auto dependent : job.task->dependents) {
+					auto& next = job.graph->tasks[dependent];
+					if (next.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+						push(Job{ {}, &counter, next.name, job.graph, &next });
+					}
+				}
+			}
+			counter.pending.fetch_sub(1, std::memory_order_release);
+		}
+
+
+		void work(unsigned int index) {
+			currentSystem = this;
+			currentIndex = index;
+
+			while (true) {
+				//jobs often come in bursts (e.g. once per frame), so the worker looks for a while before sleeping
+				bool found = false;
+				for (int i = 0; i < SPINS && !found; ++i) {
+					found = runOne(index);
+					if (!found) {
+						std::this_thread::yield();
+					}
+				}
+				if (found) {
+					continue;
+				}
+
+				std::unique_lock lock{ sleepMutex };
+				sleeping.fetch_add(1);
+				wakeUp.wait(lock, [this]() { return stopping || queued.load() > 0; });
+				sleeping.fetch_sub(1);
+				if (stopping && queued.load() == 0) {
+					return;
+				}
+			}
+		}
+
+
+
+		static constexpr int SPINS = 64;
+
+		static inline thread_local const JobSystem* currentSystem = nullptr;
+		static inline thread_local unsigned int currentIndex = 0;
+
+		std::vector<Queue> queues; //the queue 0 is shared by the threads which don't belong to the system
+		std::vector<std::thread> threads;
+		std::atomic<size_t> queued{ 0 }; //jobs in all the queues
+		std::atomic<JobObserver*> observer{ nullptr };
+
+		std::mutex sleepMutex;
+		std::condition_variable wakeUp;
+		std::atomic<unsigned int> sleeping{ 0 };
+		bool stopping = false; //protected by sleepMutex
+	};
+
+}
+
+
+#endif
@@ -1,11 +1,17 @@
 #ifndef VULKAN_KEYBOARDLISTENER
 #define VULKAN_KEYBOARDLISTENER
 
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <initializer_list>
+#include <stdexcept>
 #include <vector>
 #include <string>
 #include <functional>
 
 #include "Window.h"
+#include "SpscQueue.h"
 
 
 namespace Vulkan::Utilities {
@@ -29,39 +35,147 @@ namespace Vulkan::Utilities {
 	};
 
 
+
+	/**
+	 * @brief A key which has been pressed or released.
+	 */
+	struct KeyEvent {
+		int key;
+		bool pressed; //false if released
+		std::chrono::steady_clock::time_point time; //when GLFW reported the event
+	};
+
+
+
+	/**
+	 * @brief Notifies the observers of the keys held down, from the thread which calls checkKeyPressed (the physics).
+	 * @details GLFW reports the key events to the thread which polls the events (the main thread), and the listener moves them to a SpscQueue, so GLFW is never called by the physics thread.
+	 *			checkKeyPressed drains the queue into a set of the keys held down (one bit per GLFW key code) and notifies each observer of the keys it registered for, so that the physics costs a few bit tests per tick whatever the number of keys.
+	 *			A key pressed and released between 2 calls of checkKeyPressed is notified once, so short taps are not lost.
+	 *			When the queue is full, key presses are dropped but key releases never are: each press keeps a place free in the queue for its release, so a key can't stay held down forever.
+	 */
 	class KeyboardListener {
 	public:
-		template<std::derived_from<KeyboardObserver>... Listeners>
-		KeyboardListener(const Window& window, Listeners&... listeners) : window{ window } {
-			(this->listeners.push_back(&listeners), ...);
+
+		static constexpr size_t KEYS = 512; //more than GLFW_KEY_LAST
+
+
+		/**
+		 * @brief Starts receiving the key events of the window. The listener uses the user pointer of the window, so there can be a single listener per window.
+		 *
+		 * @param window The window.
+		 * @param capacity Maximum number of key events received by the main thread and not yet read by checkKeyPressed.
+		 */
+		KeyboardListener(const Window& window, size_t capacity = 256) : window{ window }, events{ capacity } {
+			glfwSetWindowUserPointer(+window, this);
+			glfwSetKeyCallback(+window, onKey);
 		}
 
+		~KeyboardListener() {
+			glfwSetKeyCallback(+window, nullptr);
+			glfwSetWindowUserPointer(+window, nullptr);
+		}
 
+		KeyboardListener(const KeyboardListener&) = delete;
+		KeyboardListener& operator=(const KeyboardListener&) = delete;
+
+
+
+		/**
+		 * @brief Notifies an observer, at each call of checkKeyPressed, of the keys (GLFW key codes) of the list which are held down. Observers must be added before checkKeyPressed is called for the first time.
+		 */
+		void addObserver(KeyboardObserver& observer, std::initializer_list<int> keys) {
+			for (int key : keys) {
+				observers.push_back({ checkKey(key), &observer });
+			}
+			std::stable_sort(observers.begin(), observers.end(), [](const auto& o1, const auto& o2) { return o1.first < o2.first; }); //keys in ascending order, as GLFW codes
+		}
+
+
+		/**
+		 * @brief Reads the key events received since the last call and notifies the observers of the keys held down. To be called by a single thread.
+		 */
 		void checkKeyPressed() {
-			for (int key = 32; key <= 96; ++key) {
-				if (glfwGetKey(+window, key)) {
-					notifyKeyPress(key);
+			auto now = std::chrono::steady_clock::now();
+			std::bitset<KEYS> tapped; //pressed since the last call, maybe already released
+			events.drain([this, &tapped, now](const KeyEvent& event) {
+				pressed[event.key] = event.pressed;
+				if (event.pressed) {
+					tapped[event.key] = true;
 				}
-			}
-			for (int key = 256; key <= 348; ++key) {
-				if (glfwGetKey(+window, key)) {
-					notifyKeyPress(key);
+				maxLatency = std::max(maxLatency, std::chrono::duration_cast<std::chrono::nanoseconds>(now - event.time));
+			});
+
+			auto notify = pressed | tapped;
+			for (const auto& [key, observer] : observers) {
+				if (notify[key]) {
+					observer->onKeyPress(key);
 				}
 			}
 		}
 
 
+		/**
+		 * @brief Returns whether a key is held down, as of the last call of checkKeyPressed. To be called by the thread which calls checkKeyPressed.
+		 */
+		bool isPressed(int key) const {
+			return pressed[checkKey(key)];
+		}
+
+
+		/**
+		 * @brief Returns the longest time a key event waited in the queue before being read by checkKeyPressed. To be called by the thread which calls checkKeyPressed (or after it stopped).
+		 */
+		std::chrono::nanoseconds getMaxLatency() const {
+			return maxLatency;
+		}
+
+
+		/**
+		 * @brief Returns how many key events have been lost because checkKeyPressed was not called often enough.
+		 */
+		uint64_t getDropped() const {
+			return events.getDropped();
+		}
+
+
 	private:
 
-		void notifyKeyPress(int keyPressed) {
-			for (auto& listener : listeners) {
-				listener->onKeyPress(keyPressed);
+		static int checkKey(int key) {
+			if (key < 0 || key >= static_cast<int>(KEYS)) {
+				throw std::out_of_range{ "Invalid key code " + std::to_string(key) };
+			}
+			return key;
+		}
+
+
+		//GLFW key callback, called by the thread which polls the events
+		static void onKey(GLFWwindow* window, int key, int, int action, int) {
+			auto listener = static_cast<KeyboardListener*>(glfwGetWindowUserPointer(window));
+			if (listener == nullptr || key < 0 || key >= static_cast<int>(KEYS) || action == GLFW_REPEAT) {
+				return; //GLFW_KEY_UNKNOWN, or a key held down (its state doesn't change)
+			}
+			KeyEvent event{ key, action == GLFW_PRESS, std::chrono::steady_clock::now() };
+			auto& queued = listener->queuedPresses;
+			if (event.pressed) {
+				//keep a place for the release of this key and of the other keys held down
+				if (listener->events.push(event, queued.count() + (queued[key] ? 0 : 1))) {
+					queued[key] = true;
+				}
 			}
+			else if (queued[key]) {
+				listener->events.push(event); //always fits, a place has been kept for it
+				queued[key] = false;
+			} //else the press has been dropped, so checkKeyPressed never saw the key held down
 		}
 
 
-		std::vector<KeyboardObserver*> listeners;
 		const Window& window;
+		SpscQueue<KeyEvent> events; //from the main thread to the physics thread
+		std::bitset<KEYS> pressed; //used only by the thread which calls checkKeyPressed
+		std::bitset<KEYS> queuedPresses; //keys whose press has been queued and not their release, used only by the thread which polls the events
+		std::vector<std::pair<int, KeyboardObserver*>> observers; //key and observer, by key
+		std::chrono::nanoseconds maxLatency{ 0 };
 	};
 
 }
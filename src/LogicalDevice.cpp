@@ -1,6 +1,8 @@
 #include "LogicalDevice.h"
 #include "PhysicalDevice.h"
 #include "Queue.h"
+#include "MemoryAllocator.h"
+#include "PipelineCache.h"
 #include "VulkanException.h"
 
 #include <iostream>
@@ -8,8 +10,8 @@
 #include <set>
 
 
-Vulkan::LogicalDevice::LogicalDevice(const PhysicalDevice& physicalGpu) {
-	const auto queueFamiliesIndices = physicalGpu.getQueueFamiliesIndices(); //indices of the queues families for the graphics and presentation queues
+Vulkan::LogicalDevice::LogicalDevice(const PhysicalDevice& physicalGpu, const std::string& pipelineCachePath) {
+	const auto queueFamiliesIndices = physicalGpu.getQueueFamiliesIndices(); //indices of the queues families for the graphics, presentation and transfer queues
 	//keep only unique indices (i.e. if for example graphics and presentation queues use the same family, only one queue needs to be created)
 	std::set<int> uniqueQueueFamiliesIndices;
 	for (const auto& queueFamilyIndex : queueFamiliesIndices) {
@@ -17,13 +19,13 @@ Vulkan::LogicalDevice::LogicalDevice(const PhysicalDevice& physicalGpu) {
 	}
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos; //array where to save the structs to create the queues
 
-	//for each queue family (graphics and presentation) create the concrete queue
+	//for each queue family (graphics, presentation and transfer) create the concrete queue
 	for (float queuePriority = 1.0f; const auto & queueFamilyIndex : uniqueQueueFamiliesIndices) {
 		//struct to create a queue
 		VkDeviceQueueCreateInfo queueCreateInfo{};
 		queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 		queueCreateInfo.queueFamilyIndex = queueFamilyIndex;
-		queueCreateInfo.queueCount = uniqueQueueFamiliesIndices.size();
+		queueCreateInfo.queueCount = 1; //a single queue per family (there is a single priority too)
 		queueCreateInfo.pQueuePriorities = &queuePriority;
 		queueCreateInfos.push_back(queueCreateInfo); //add the struct to the list
 	}
@@ -31,6 +33,9 @@ Vulkan::LogicalDevice::LogicalDevice(const PhysicalDevice& physicalGpu) {
 
 	VkPhysicalDeviceFeatures deviceFeatures{}; //advanced features we need
 	deviceFeatures.samplerAnisotropy = VK_TRUE; //TODO we should check in the PhysicalDevice::isSuitable if anisotropic is supported (but it always is on modern GPUs)
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(+physicalGpu, &supportedFeatures);
+	deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC; //BC compressed textures where available (see TextureImage)
 
 	auto requiredDeviceExtensions = physicalGpu.getRequiredDeviceExtensions();
 	//struct containing info for the creation of the logical device based on the choosen physical device
@@ -54,12 +59,18 @@ Vulkan::LogicalDevice::LogicalDevice(const PhysicalDevice& physicalGpu) {
 			std::forward_as_tuple(*this, queueFamilyIndex)); //create and insert the Queue object into the list of queues
 	}
 
+	memoryAllocator = std::make_unique<MemoryAllocator>(virtualGpu, physicalGpu);
+	pipelineCache = std::make_unique<PipelineCache>(virtualGpu, physicalGpu, pipelineCachePath);
+
 	std::cout << "\n+ LogicalDevice created";
 }
 
 
 
 Vulkan::LogicalDevice::~LogicalDevice() {
+	pipelineCache->save(); //the pipelines created in this run are compiled in the next ones
+	pipelineCache.reset();
+	memoryAllocator.reset(); //the memory must be freed before the device is destroyed
 	vkDestroyDevice(virtualGpu, nullptr);
 	std::cout << "\n- LogicalDevice destroyed";
 }
@@ -75,3 +86,15 @@ const VkDevice& Vulkan::LogicalDevice::operator+() const {
 const Vulkan::Queue& Vulkan::LogicalDevice::operator[](QueueFamily queueFamily) const {
 	return queues.find(queueFamily)->second;
 }
+
+
+
+Vulkan::MemoryAllocator& Vulkan::LogicalDevice::getMemoryAllocator() const {
+	return *memoryAllocator;
+}
+
+
+
+const Vulkan::PipelineCache& Vulkan::LogicalDevice::getPipelineCache() const {
+	return *pipelineCache;
+}
@@ -4,17 +4,24 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <map>
+#include <memory>
+#include <string>
 
 
 
-namespace Vulkan { class LogicalDevice; class PhysicalDevice; enum class QueueFamily; class Queue; }
+namespace Vulkan { class LogicalDevice; class PhysicalDevice; enum class QueueFamily; class Queue; class MemoryAllocator; class PipelineCache; }
 
 /**
  * @brief A logical device is an abstraction of the physical GPU which we can mainly use to send commands.
  */
 class Vulkan::LogicalDevice {
 	public:
-		LogicalDevice(const PhysicalDevice& physicalGpu);
+		/**
+		 * @brief Creates the device, its queues, its memory allocator and its pipeline cache.
+		 *
+		 * @param pipelineCachePath The file the pipeline cache is loaded from, and saved to when the device is destroyed.
+		 */
+		LogicalDevice(const PhysicalDevice& physicalGpu, const std::string& pipelineCachePath = "pipelines.cache");
 
 		~LogicalDevice();
 
@@ -41,9 +48,25 @@ class Vulkan::LogicalDevice {
 		const Queue& operator[](QueueFamily queueFamily) const;
 
 
+		/**
+		 * @brief Returns the allocator which gives the device memory to the buffers and images created on this device.
+		 * 
+		 * @return The memory allocator of this device.
+		 */
+		MemoryAllocator& getMemoryAllocator() const;
+
+
+		/**
+		 * @brief Returns the cache every pipeline created on this device goes through.
+		 */
+		const PipelineCache& getPipelineCache() const;
+
+
 	private:
 		VkDevice virtualGpu;
 		std::map<QueueFamily, Queue> queues; //the queues we created
+		std::unique_ptr<MemoryAllocator> memoryAllocator;
+		std::unique_ptr<PipelineCache> pipelineCache;
 		
 };
 
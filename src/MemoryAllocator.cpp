@@ -0,0 +1,232 @@
+#include "MemoryAllocator.h"
+#include "PhysicalDevice.h"
+#include "VulkanException.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+
+
+
+Vulkan::MemoryAllocator::MemoryAllocator(VkDevice virtualGpu, const PhysicalDevice& realGpu) : virtualGpu{ virtualGpu } {
+	vkGetPhysicalDeviceMemoryProperties(+realGpu, &memoryProperties);
+	const auto limits = realGpu.getProperties().limits;
+	bufferImageGranularity = limits.bufferImageGranularity;
+	nonCoherentAtomSize = limits.nonCoherentAtomSize;
+	maxMemoryAllocationCount = limits.maxMemoryAllocationCount;
+
+	//a block takes at most 1/8 of its heap, so that a small heap isn't filled by a single block
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+		const auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+		blockSizes.push_back(std::max(std::min(BLOCK_SIZE, std::bit_floor(heapSize / 8)), MIN_ALLOCATION_SIZE));
+	}
+	blocks.resize(memoryProperties.memoryTypeCount);
+
+	std::cout << "\n+ MemoryAllocator created";
+}
+
+
+
+Vulkan::MemoryAllocator::~MemoryAllocator() {
+	for (auto& typeBlocks : blocks) {
+		for (auto& block : typeBlocks) {
+			freeDeviceMemory(block->memory, block->mapped);
+		}
+	}
+	std::cout << "\n- MemoryAllocator destroyed";
+}
+
+
+
+Vulkan::MemoryAllocator::Allocation Vulkan::MemoryAllocator::allocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties) {
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(virtualGpu, buffer, &requirements);
+
+	auto allocation = allocate(requirements, requiredProperties, preferredProperties, false);
+	if (VkResult result = vkBindBufferMemory(virtualGpu, buffer, allocation.memory, allocation.offset); result != VK_SUCCESS) {
+		free(allocation);
+		throw VulkanException{ "Failed to bind the buffer memory", result };
+	}
+	return allocation;
+}
+
+
+
+Vulkan::MemoryAllocator::Allocation Vulkan::MemoryAllocator::allocateForImage(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties) {
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(virtualGpu, image, &requirements);
+
+	auto allocation = allocate(requirements, requiredProperties, preferredProperties, tiling == VK_IMAGE_TILING_OPTIMAL);
+	if (VkResult result = vkBindImageMemory(virtualGpu, image, allocation.memory, allocation.offset); result != VK_SUCCESS) {
+		free(allocation);
+		throw VulkanException{ "Failed to bind the image memory", result };
+	}
+	return allocation;
+}
+
+
+
+Vulkan::MemoryAllocator::Allocation Vulkan::MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties, bool isOptimalImage) {
+	const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, requiredProperties, preferredProperties);
+	const auto properties = memoryProperties.memoryTypes[memoryType].propertyFlags;
+	const VkDeviceSize blockSize = blockSizes[memoryType];
+
+	//an optimal image takes whole pages of bufferImageGranularity, so no linear resource can share a page with it; a mapped range must be flushed in whole atoms
+	VkDeviceSize size = requirements.size;
+	VkDeviceSize alignment = requirements.alignment;
+	if (isOptimalImage) {
+		size = (size + bufferImageGranularity - 1) / bufferImageGranularity * bufferImageGranularity;
+		alignment = std::max(alignment, bufferImageGranularity);
+	}
+	if ((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+		alignment = std::max(alignment, nonCoherentAtomSize);
+	}
+
+	std::lock_guard lock{ mutex };
+
+	//large images (e.g. textures) and whatever wouldn't fit comfortably in a block get their own allocation
+	if (size > blockSize / 2 || (isOptimalImage && size >= blockSize / 4)) {
+		Allocation allocation{ allocateDeviceMemory(memoryType, requirements.size), 0, requirements.size, memoryType, nullptr, nullptr };
+		stats.dedicatedAllocations++;
+		stats.dedicatedBytes += allocation.size;
+		return allocation;
+	}
+
+	//the first block with enough room, or else a new block
+	auto& typeBlocks = blocks[memoryType];
+	for (auto& block : typeBlocks) {
+		if (auto node = block->allocator.allocate(size, alignment)) {
+			block->allocations++;
+			stats.allocations++;
+			stats.usedBytes += node->size;
+			return Allocation{ block->memory, node->offset, node->size, memoryType, nullptr, block.get() };
+		}
+	}
+
+	typeBlocks.push_back(std::make_unique<Block>(allocateDeviceMemory(memoryType, blockSize), blockSize));
+	stats.blocks++;
+	stats.blockBytes += blockSize;
+	auto& block = *typeBlocks.back();
+	auto node = block.allocator.allocate(size, alignment); //the resource is at most half a block, so it fits in an empty one
+	block.allocations++;
+	stats.allocations++;
+	stats.usedBytes += node->size;
+	return Allocation{ block.memory, node->offset, node->size, memoryType, nullptr, &block };
+}
+
+
+
+void Vulkan::MemoryAllocator::free(Allocation& allocation) {
+	if (allocation.memory == VK_NULL_HANDLE) {
+		return;
+	}
+	std::lock_guard lock{ mutex };
+
+	if (allocation.block == nullptr) {
+		freeDeviceMemory(allocation.memory, allocation.mapped);
+		stats.dedicatedAllocations--;
+		stats.dedicatedBytes -= allocation.size;
+	}
+	else {
+		auto block = static_cast<Block*>(allocation.block);
+		block->allocator.free(Utilities::BuddyAllocator::Node{ allocation.offset, allocation.size });
+		block->allocations--;
+		stats.allocations--;
+		stats.usedBytes -= allocation.size;
+
+		//free an empty block, unless it is the last one of its memory type (so that creating and destroying a single resource doesn't allocate each time)
+		auto& typeBlocks = blocks[allocation.memoryType];
+		if (block->allocations == 0 && typeBlocks.size() > 1) {
+			stats.blocks--;
+			stats.blockBytes -= block->allocator.getSize();
+			freeDeviceMemory(block->memory, block->mapped);
+			std::erase_if(typeBlocks, [block](const auto& b) { return b.get() == block; });
+		}
+	}
+
+	allocation = Allocation{};
+}
+
+
+
+std::byte* Vulkan::MemoryAllocator::map(Allocation& allocation) {
+	if (allocation.mapped != nullptr) {
+		return allocation.mapped;
+	}
+	if (!(getMemoryProperties(allocation) & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+		throw VulkanException{ "Failed to map the memory", "The memory isn't host visible" };
+	}
+
+	std::lock_guard lock{ mutex };
+
+	//a memory can be mapped only once, so a block is mapped whole and its resources share the mapping
+	auto block = static_cast<Block*>(allocation.block);
+	std::byte*& base = block != nullptr ? block->mapped : allocation.mapped;
+	if (base == nullptr) {
+		void* rawData;
+		if (VkResult result = vkMapMemory(virtualGpu, allocation.memory, 0, VK_WHOLE_SIZE, 0, &rawData); result != VK_SUCCESS) {
+			throw VulkanException{ "Failed to map the memory", result };
+		}
+		base = static_cast<std::byte*>(rawData);
+	}
+
+	allocation.mapped = block != nullptr ? base + allocation.offset : base;
+	return allocation.mapped;
+}
+
+
+
+VkMemoryPropertyFlags Vulkan::MemoryAllocator::getMemoryProperties(const Allocation& allocation) const {
+	return memoryProperties.memoryTypes[allocation.memoryType].propertyFlags;
+}
+
+
+
+Vulkan::MemoryAllocator::Stats Vulkan::MemoryAllocator::getStats() const {
+	std::lock_guard lock{ mutex };
+	return stats;
+}
+
+
+
+uint32_t Vulkan::MemoryAllocator::findMemoryType(uint32_t suitableTypesBitmask, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties) const {
+	for (auto mask : { requiredProperties | preferredProperties, requiredProperties }) {
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+			if ((suitableTypesBitmask & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & mask) == mask) {
+				return i;
+			}
+		}
+	}
+
+	throw VulkanException{ "No suitable memory for the resource" };
+}
+
+
+
+VkDeviceMemory Vulkan::MemoryAllocator::allocateDeviceMemory(uint32_t memoryType, VkDeviceSize size) {
+	if (stats.deviceAllocations >= maxMemoryAllocationCount) {
+		throw VulkanException{ "Failed to allocate device memory", "Too many allocations (maxMemoryAllocationCount)" };
+	}
+
+	VkMemoryAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = size;
+	allocInfo.memoryTypeIndex = memoryType;
+
+	VkDeviceMemory memory;
+	if (VkResult result = vkAllocateMemory(virtualGpu, &allocInfo, nullptr, &memory); result != VK_SUCCESS) {
+		throw VulkanException{ "Failed to allocate device memory", result };
+	}
+	stats.deviceAllocations++;
+	return memory;
+}
+
+
+
+void Vulkan::MemoryAllocator::freeDeviceMemory(VkDeviceMemory memory, std::byte* mapped) {
+	if (mapped != nullptr) {
+		vkUnmapMemory(virtualGpu, memory);
+	}
+	vkFreeMemory(virtualGpu, memory, nullptr);
+	stats.deviceAllocations--;
+}
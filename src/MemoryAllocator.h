@@ -0,0 +1,136 @@
+#ifndef VULKAN_MEMORYALLOCATOR
+#define VULKAN_MEMORYALLOCATOR
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "BuddyAllocator.h"
+
+
+namespace Vulkan { class MemoryAllocator; class PhysicalDevice; }
+
+/**
+ * @brief The MemoryAllocator gives the device memory to buffers and images, by sub-allocating few large blocks instead of calling vkAllocateMemory for each resource.
+ * @details Drivers cap the number of allocations (maxMemoryAllocationCount) and each allocation is slow, so each memory type has its own list of blocks, and the resources get ranges of a block from a buddy allocator.
+ *			Images with optimal tiling take whole pages of bufferImageGranularity, so they never share a page with a buffer.
+ *			Large images and resources which don't fit in a block get a dedicated allocation.
+ *			Host visible blocks are mapped once, the first time a resource in them asks for a mapping, and stay mapped till they are freed.
+ *			The allocator is owned by the LogicalDevice and can be used by many threads.
+ */
+class Vulkan::MemoryAllocator {
+public:
+
+	/**
+	 * @brief The memory of a resource: a range of a block, or a whole dedicated allocation.
+	 */
+	struct Allocation {
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0; //in memory
+		VkDeviceSize size = 0; //may be larger than the size required by the resource
+		uint32_t memoryType = 0;
+		std::byte* mapped = nullptr; //set by map
+		void* block = nullptr; //the block the range belongs to, or nullptr if the allocation is dedicated
+	};
+
+
+	struct Stats {
+		uint32_t deviceAllocations = 0; //alive vkAllocateMemory allocations (blocks + dedicated)
+		uint32_t blocks = 0;
+		uint32_t dedicatedAllocations = 0;
+		uint32_t allocations = 0; //alive ranges of the blocks
+		VkDeviceSize blockBytes = 0;
+		VkDeviceSize usedBytes = 0; //used in the blocks (the requests rounded up to a power of 2)
+		VkDeviceSize dedicatedBytes = 0;
+	};
+
+
+	static constexpr VkDeviceSize BLOCK_SIZE = VkDeviceSize{ 64 } << 20; //a block is smaller if its heap is small
+	static constexpr VkDeviceSize MIN_ALLOCATION_SIZE = 256;
+
+
+	MemoryAllocator(VkDevice virtualGpu, const PhysicalDevice& realGpu);
+
+	~MemoryAllocator();
+
+	MemoryAllocator(const MemoryAllocator&) = delete;
+	MemoryAllocator(MemoryAllocator&&) = delete;
+	MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+	MemoryAllocator& operator=(MemoryAllocator&&) = delete;
+
+
+
+	/**
+	 * @brief Allocates the memory of a buffer, in a memory type which has all the required properties and, if possible, all the preferred ones, and binds it to the buffer.
+	 */
+	Allocation allocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties = 0);
+
+
+	/**
+	 * @brief Allocates the memory of an image, in a memory type which has all the required properties and, if possible, all the preferred ones, and binds it to the image.
+	 *
+	 * @param tiling The tiling the image has been created with: optimal images are kept apart from buffers and linear images, as bufferImageGranularity requires.
+	 */
+	Allocation allocateForImage(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties = 0);
+
+
+	/**
+	 * @brief Gives back the memory of a resource, which must have already been destroyed (or never use the memory again). Empty blocks are freed, except the last one of each memory type.
+	 */
+	void free(Allocation& allocation);
+
+
+	/**
+	 * @brief Returns a pointer to the memory of the allocation, which stays valid till the allocation is freed. The memory must be host visible.
+	 */
+	std::byte* map(Allocation& allocation);
+
+
+	/**
+	 * @brief Returns the properties of the memory type of an allocation.
+	 */
+	VkMemoryPropertyFlags getMemoryProperties(const Allocation& allocation) const;
+
+
+	Stats getStats() const;
+
+
+private:
+
+	struct Block {
+		Block(VkDeviceMemory memory, VkDeviceSize size) : memory{ memory }, allocator{ size, MIN_ALLOCATION_SIZE } {}
+
+		VkDeviceMemory memory;
+		Utilities::BuddyAllocator allocator;
+		std::byte* mapped = nullptr;
+		uint32_t allocations = 0;
+	};
+
+
+	Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties, bool isOptimalImage);
+
+	//Return the first memory type which is suitable and has both the required and the preferred properties, or else the first one which is suitable and has the required properties.
+	uint32_t findMemoryType(uint32_t suitableTypesBitmask, VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties) const;
+
+	VkDeviceMemory allocateDeviceMemory(uint32_t memoryType, VkDeviceSize size);
+
+	void freeDeviceMemory(VkDeviceMemory memory, std::byte* mapped);
+
+
+	VkDevice virtualGpu;
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	VkDeviceSize bufferImageGranularity;
+	VkDeviceSize nonCoherentAtomSize;
+	uint32_t maxMemoryAllocationCount;
+	std::vector<VkDeviceSize> blockSizes; //for each memory type
+	std::vector<std::vector<std::unique_ptr<Block>>> blocks; //for each memory type
+
+	Stats stats;
+	mutable std::mutex mutex;
+};
+
+
+#endif
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <span>
 #include <vector>
 #include <tuple>
 
@@ -34,15 +35,26 @@ namespace Vulkan::Objects {
 
 	public:
 
-		Model(std::unique_ptr<Vulkan::Physics::Hitbox> hitbox, glm::vec3 rotationEuler, Vertex, std::string pathToModel, Structs... uniforms) : vertices{}, indexes{}, uniforms{ Matrices{}, uniforms... }, hitbox{ std::move(hitbox) }, reactToKeyPress{ [](Model&, int) {} } {
+		Model(std::unique_ptr<Vulkan::Physics::Hitbox> hitbox, glm::vec3 rotationEuler, Vertex, std::string pathToModel, Structs... uniforms) : vertices{}, indexes{}, uniforms{ Matrices{}, uniforms... }, ownedHitbox{ std::move(hitbox) }, reactToKeyPress{ [](Model&, int) {} } {
 			ModelLoader<Vertex>::loadModel(pathToModel, vertices, indexes);
 			rotation = glm::quat(rotationEuler);
+			this->hitbox = ownedHitbox.get();
 		}
 
 
-		Model(glm::vec3 rotationEuler, float scale, Physics::Position position, std::vector<Vertex> vertices, std::vector<uint32_t> indexes, Structs... uniforms) : vertices{ vertices }, indexes{ indexes }, uniforms{ Matrices{}, uniforms... }, hitbox{}, reactToKeyPress{ [](Model&, int) {} } {
+		/**
+		 * @brief Builds a model which follows a hitbox owned by someone else (e.g. a Physics::Table), which must outlive the model.
+		 */
+		Model(Vulkan::Physics::Hitbox& hitbox, glm::vec3 rotationEuler, Vertex, std::string pathToModel, Structs... uniforms) : vertices{}, indexes{}, uniforms{ Matrices{}, uniforms... }, hitbox{ &hitbox }, reactToKeyPress{ [](Model&, int) {} } {
+			ModelLoader<Vertex>::loadModel(pathToModel, vertices, indexes);
+			rotation = glm::quat(rotationEuler);
+		}
+
+
+		Model(glm::vec3 rotationEuler, float scale, Physics::Position position, std::vector<Vertex> vertices, std::vector<uint32_t> indexes, Structs... uniforms) : vertices{ vertices }, indexes{ indexes }, uniforms{ Matrices{}, uniforms... }, reactToKeyPress{ [](Model&, int) {} } {
 			rotation = glm::quat(rotationEuler);
-			hitbox = std::make_unique<Vulkan::Physics::Hitbox>(position, scale);
+			ownedHitbox = std::make_unique<Vulkan::Physics::Hitbox>(position, scale);
+			hitbox = ownedHitbox.get();
 		}
 
 
@@ -56,8 +68,11 @@ namespace Vulkan::Objects {
 		}
 
 
-		void setVertices(std::vector<Vertex> vertices) {
-			this->vertices = vertices;
+		/**
+		 * @brief Replaces the vertices. If the model has at least as many vertices as before, the vertices are copied in place, without allocating.
+		 */
+		void setVertices(std::span<const Vertex> vertices) {
+			this->vertices.assign(vertices.begin(), vertices.end());
 		}
 
 
@@ -127,7 +142,8 @@ namespace Vulkan::Objects {
 
 		glm::quat rotation; //in this simplified version of the physics (2D) a model can have a different rotation than the one of its hitbox
 
-		std::unique_ptr<Vulkan::Physics::Hitbox> hitbox;
+		std::unique_ptr<Vulkan::Physics::Hitbox> ownedHitbox; //empty if the hitbox is owned by someone else
+		Vulkan::Physics::Hitbox* hitbox;
 
 		std::function<void(Model&, int)> reactToKeyPress;
 	};
@@ -40,12 +40,12 @@ namespace Vulkan::Physics {
 			return *this;
 		};
 
-		virtual const glm::quat& getRotation() const {
+		virtual glm::quat getRotation() const {
 			std::scoped_lock lock{ mutex };
 			return rotation;
 		}
 
-		virtual const glm::vec3& getRotationEuler() const {
+		virtual glm::vec3 getRotationEuler() const {
 			std::scoped_lock lock{ mutex };
 
 			auto yaw = glm::yaw(rotation);
@@ -85,6 +85,7 @@ std::map<Vulkan::QueueFamily, int> Vulkan::PhysicalDevice::queueFamiliesSupport(
 
 	//for each family, check whether it supports the required families (families are named by their position in the queueFamily vector
 	std::map<QueueFamily, std::vector<int>> supportedFamilies; //std::map[families supporting graphics, families supporting presentation]
+	std::vector<int> transferOnlyFamilies, transferComputeFamilies; //families which can copy but not draw
 	for (int i = 0; const auto & queueFamily : queueFamilies) {
 		//check graphics family
 		if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
@@ -98,6 +99,11 @@ std::map<Vulkan::QueueFamily, int> Vulkan::PhysicalDevice::queueFamiliesSupport(
 			supportedFamilies[QueueFamily::PRESENTATION].push_back(i);
 		}
 
+		//check transfer family (graphics and compute families can always copy, even if they don't have the transfer bit)
+		if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+			(queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT ? transferComputeFamilies : transferOnlyFamilies).push_back(i);
+		}
+
 		i++;
 	}
 
@@ -105,7 +111,11 @@ std::map<Vulkan::QueueFamily, int> Vulkan::PhysicalDevice::queueFamiliesSupport(
 	if (supportedFamilies[QueueFamily::GRAPHICS].size() == 0 || supportedFamilies[QueueFamily::PRESENTATION].size() == 0) {
 		throw VulkanException("The GPU doesn't support all of the required families");
 	}
-	return chooseFewestPossible(supportedFamilies);
+	auto chosenFamilies = chooseFewestPossible(supportedFamilies);
+
+	//the uploads go to a family which only copies (usually a copy engine, which works while the graphics queue renders), or else to one which doesn't draw, or else to the graphics family
+	chosenFamilies[QueueFamily::TRANSFER] = !transferOnlyFamilies.empty() ? transferOnlyFamilies[0] : !transferComputeFamilies.empty() ? transferComputeFamilies[0] : chosenFamilies[QueueFamily::GRAPHICS];
+	return chosenFamilies;
 }
 
 
@@ -71,7 +71,7 @@ class Vulkan::PhysicalDevice {
 
 
 		VkPhysicalDevice gpu = VK_NULL_HANDLE;
-		std::map<QueueFamily, int> queueFamiliesIndices; //the indices of the graphics and presentation families (they can be the same)
+		std::map<QueueFamily, int> queueFamiliesIndices; //the indices of the graphics, presentation and transfer families (they can be the same)
 		const std::vector<const char*> requiredDeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME }; //list of required extensions for the device
 };
 
@@ -0,0 +1,136 @@
+#ifndef VULKAN_PHYSICSARENA
+#define VULKAN_PHYSICSARENA
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace Vulkan::Physics {
+
+	/**
+	 * @brief Owns the objects of the physics (hitboxes, fields, ...), storing the objects of the same type next to each other.
+	 * @details Each type has its own pool of chunks, and each object takes a slot of its pool. Slots are aligned to (and as big as a multiple of) a cache line, so 2 objects never share a cache line and objects created one after the other lie one after the other in memory.
+	 *			Objects never move, so pointers to them are valid until the arena is reset. Resetting destroys all the objects but keeps the memory, so that building the next table (e.g. for a new game) doesn't allocate.
+	 */
+	class PhysicsArena {
+	public:
+
+		static constexpr size_t CACHE_LINE = 64;
+
+
+		/**
+		 * @param slotsPerChunk How many objects of a type are allocated at a time.
+		 */
+		PhysicsArena(size_t slotsPerChunk = 256) : slotsPerChunk{ slotsPerChunk } {}
+
+		PhysicsArena(const PhysicsArena&) = delete;
+		PhysicsArena& operator=(const PhysicsArena&) = delete;
+
+		~PhysicsArena() {
+			reset();
+		}
+
+
+
+		/**
+		 * @brief Builds an object in the pool of its type.
+		 *
+		 * @param ...args The arguments of the constructor of T.
+		 * @return The object, owned by the arena.
+		 */
+		template<typename T, typename... Args>
+		T& create(Args&&... args) {
+			auto& pool = getPool<T>();
+			void* slot = pool.nextSlot(slotsPerChunk);
+			T* object = new (slot) T(std::forward<Args>(args)...);
+			destructors.emplace_back(object, [](void* p) { static_cast<T*>(p)->~T(); });
+			return *object;
+		}
+
+
+		/**
+		 * @brief Destroys all the objects, in the opposite order of creation. The memory is kept for the objects created afterwards.
+		 */
+		void reset() {
+			for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+				it->second(it->first);
+			}
+			destructors.clear();
+			for (auto& [type, pool] : pools) {
+				pool.used = 0;
+			}
+		}
+
+
+		/**
+		 * @brief Returns the number of objects alive.
+		 */
+		size_t size() const {
+			return destructors.size();
+		}
+
+
+		/**
+		 * @brief Returns the bytes allocated by the arena (used or not).
+		 */
+		size_t getCapacity() const {
+			size_t capacity = 0;
+			for (const auto& [type, pool] : pools) {
+				capacity += pool.chunks.size() * slotsPerChunk * pool.slotSize;
+			}
+			return capacity;
+		}
+
+
+
+	private:
+
+		struct AlignedDelete {
+			void operator()(std::byte* p) const {
+				::operator delete(p, std::align_val_t{ CACHE_LINE });
+			}
+		};
+
+
+		struct Pool {
+			size_t slotSize;
+			std::vector<std::unique_ptr<std::byte, AlignedDelete>> chunks;
+			size_t used = 0; //slots used, in all the chunks
+
+			void* nextSlot(size_t slotsPerChunk) {
+				if (used == chunks.size() * slotsPerChunk) {
+					chunks.emplace_back(static_cast<std::byte*>(::operator new(slotsPerChunk * slotSize, std::align_val_t{ CACHE_LINE })));
+				}
+				void* slot = chunks[used / slotsPerChunk].get() + (used % slotsPerChunk) * slotSize;
+				used++;
+				return slot;
+			}
+		};
+
+
+		template<typename T>
+		Pool& getPool() {
+			static_assert(alignof(T) <= CACHE_LINE, "PhysicsArena slots are aligned to a cache line");
+			auto [it, inserted] = pools.try_emplace(std::type_index{ typeid(T) });
+			if (inserted) {
+				it->second.slotSize = (sizeof(T) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+			}
+			return it->second;
+		}
+
+
+		size_t slotsPerChunk;
+		std::unordered_map<std::type_index, Pool> pools;
+		std::vector<std::pair<void*, void(*)(void*)>> destructors;
+	};
+
+}
+
+
+#endif
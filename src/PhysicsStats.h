@@ -0,0 +1,199 @@
+#ifndef VULKAN_PHYSICSSTATS
+#define VULKAN_PHYSICSSTATS
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "SpscQueue.h"
+
+
+namespace Vulkan::Physics {
+
+	/**
+	 * @brief What happened during a single Universe::calculate.
+	 */
+	struct TickRecord {
+		uint64_t tick; //progressive number of the tick, gaps mean records have been dropped
+		float elapsedSeconds; //the simulated time step
+
+		//counters
+		uint32_t bodies;
+		uint32_t pairTests; //pairs of bodies whose collision has been checked
+		uint32_t contacts; //pairs of bodies which collided
+		uint32_t callbacks; //collision actions called
+		uint32_t bodiesIntegrated; //bodies moved
+
+		//phases
+		std::chrono::nanoseconds fieldsTime;
+		std::chrono::nanoseconds collisionsTime;
+		std::chrono::nanoseconds integrationTime;
+		std::chrono::nanoseconds totalTime;
+	};
+
+
+
+	/**
+	 * @brief The per-tick records of a Universe, written by the thread which runs the physics and read by any other (single) thread.
+	 * @details The records are kept in a SpscQueue: the physics never waits for the reader. If the reader is too slow and the queue is full, new records are dropped (and counted) instead of overwriting unread ones.
+	 *			A Universe records its ticks only if a PhysicsStats is attached to it (Universe::setStats), otherwise the instrumentation costs a single branch per tick.
+	 */
+	class PhysicsStats {
+	public:
+
+		/**
+		 * @param capacity Maximum number of unread records, rounded up to a power of 2.
+		 */
+		PhysicsStats(size_t capacity = 4096) : records{ capacity }, nextTick{ 0 } {}
+
+		PhysicsStats(const PhysicsStats&) = delete;
+		PhysicsStats& operator=(const PhysicsStats&) = delete;
+
+
+
+		/**
+		 * @brief Adds the record of a tick. To be called only by the physics thread.
+		 */
+		void push(TickRecord record) {
+			record.tick = nextTick++;
+			records.push(record);
+		}
+
+
+		/**
+		 * @brief Moves all the unread records to the end of a vector. To be called only by the reading thread.
+		 *
+		 * @return The number of records read.
+		 */
+		size_t drain(std::vector<TickRecord>& records) {
+			return drain([&records](const TickRecord& record) { records.push_back(record); });
+		}
+
+
+		/**
+		 * @brief Passes all the unread records, oldest first, to a function. To be called only by the reading thread.
+		 *
+		 * @return The number of records read.
+		 */
+		template<typename F>
+		size_t drain(F&& consume) {
+			return records.drain(std::forward<F>(consume));
+		}
+
+
+		/**
+		 * @brief Returns how many records have been dropped because the queue was full.
+		 */
+		uint64_t getDropped() const {
+			return records.getDropped();
+		}
+
+
+	private:
+		Utilities::SpscQueue<TickRecord> records;
+		uint64_t nextTick; //used only by the physics thread
+	};
+
+
+
+	/**
+	 * @brief The distribution of the tick times of a set of records.
+	 */
+	struct TickSummary {
+		size_t ticks;
+		std::chrono::nanoseconds p50;
+		std::chrono::nanoseconds p99;
+		std::chrono::nanoseconds max;
+		size_t deadlineMisses; //ticks which lasted more than the deadline
+	};
+
+
+	/**
+	 * @brief Summarizes the tick times of a set of records.
+	 *
+	 * @param records The records to summarize.
+	 * @param deadline The maximum time a tick should last (e.g. the time step the physics is supposed to keep up with).
+	 */
+	inline TickSummary summarize(const std::vector<TickRecord>& records, std::chrono::nanoseconds deadline) {
+		TickSummary summary{ records.size(), {}, {}, {}, 0 };
+		if (records.empty()) {
+			return summary;
+		}
+
+		std::vector<std::chrono::nanoseconds> times;
+		times.reserve(records.size());
+		for (const auto& record : records) {
+			times.push_back(record.totalTime);
+			if (record.totalTime > deadline) {
+				summary.deadlineMisses++;
+			}
+		}
+		std::sort(times.begin(), times.end());
+		summary.p50 = times[(times.size() - 1) / 2];
+		summary.p99 = times[(times.size() - 1) * 99 / 100];
+		summary.max = times.back();
+		return summary;
+	}
+
+
+
+	/**
+	 * @brief The last records of a PhysicsStats, kept by the reading thread (e.g. to alert when the physics misses its deadline).
+	 * @details The records are kept in a ring buffer allocated once, so that update doesn't allocate (it is called every frame).
+	 */
+	class TickHistory {
+	public:
+
+		/**
+		 * @param length How many records are kept, older ones are discarded.
+		 */
+		TickHistory(size_t length = 10000) : length{ std::max<size_t>(length, 1) } {
+			records.reserve(this->length);
+		}
+
+
+		/**
+		 * @brief Reads the new records of stats.
+		 */
+		void update(PhysicsStats& stats) {
+			stats.drain([this](const TickRecord& record) {
+				if (records.size() < length) {
+					records.push_back(record);
+				}
+				else {
+					records[oldest] = record;
+					oldest = (oldest + 1) % length;
+				}
+			});
+		}
+
+
+		TickSummary summarize(std::chrono::nanoseconds deadline) const {
+			return Physics::summarize(getRecords(), deadline);
+		}
+
+
+		/**
+		 * @brief Returns a copy of the records, oldest first.
+		 */
+		std::vector<TickRecord> getRecords() const {
+			std::vector<TickRecord> res;
+			res.reserve(records.size());
+			res.insert(res.end(), records.begin() + oldest, records.end());
+			res.insert(res.end(), records.begin(), records.begin() + oldest);
+			return res;
+		}
+
+
+	private:
+		size_t length;
+		std::vector<TickRecord> records; //a ring buffer once full
+		size_t oldest = 0; //index of the oldest record, once the buffer is full
+	};
+
+}
+
+
+#endif
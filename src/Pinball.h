@@ -19,6 +19,7 @@
 #include "FieldFunctions.h"
 #include "Foundations.h"
 #include "Framebuffer.h"
+#include "FrameRingBuffer.h"
 #include "Hitbox.h"
 #include "Image.h"
 #include "ImageView.h"
@@ -26,6 +27,7 @@
 #include "InputAssembly.h"
 #include "Instance.h"
 #include "LogicalDevice.h"
+#include "MemoryAllocator.h"
 #include "Model.h"
 #include "Multisampler.h"
 #include "PhysicalDevice.h"
@@ -38,6 +40,7 @@
 #include "Semaphore.h"
 #include "Set.h"
 #include "Shader.h"
+#include "SpecializationConstants.h"
 #include "StaticSet.h"
 #include "Subpass.h"
 #include "Swapchain.h"
@@ -46,6 +49,7 @@
 #include "SwapchainSurfaceFormat.h"
 #include "UniformBuffer.h"
 #include "Universe.h"
+#include "UploadContext.h"
 #include "VertexBuffer.h"
 #include "VertexInput.h"
 #include "Viewport.h"
@@ -3,10 +3,13 @@
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <exception>
 #include <vector>
 #include <concepts>
+#include <optional>
 
 #include "LogicalDevice.h"
+#include "PipelineCache.h"
 #include "Attachment.h"
 #include "AttachmentColorBlendingMode.h"
 #include "DepthStencil.h"
@@ -21,10 +24,15 @@
 #include "Subpass.h"
 #include "VertexInput.h"
 #include "Viewport.h"
+#include "JobSystem.h"
+#include "Timeline.h"
 
 
 namespace Vulkan { class Pipeline; }
 
+/**
+ * @brief A graphics pipeline, created right away or compiled by a job (see the asynchronous constructor), so that many pipelines are compiled by the workers while the frames are drawn.
+ */
 class Vulkan::Pipeline {
 
 public:
@@ -43,6 +51,129 @@ public:
 		const PipelineOptions::DynamicState& dynamicState = PipelineOptions::DynamicState{},
 		const PipelineOptions::Viewport& viewport = PipelineOptions::Viewport{}
 	) : virtualGpu{ virtualGpu }, pipelineLayout{ pipelineLayout } {
+		pipeline = create(virtualGpu, renderPass, subpassIndex, shaders, vertexArraysDescriptor, pipelineLayout, rasterizer, inputAssembly, multisampler, depthStencil, dynamicState, viewport);
+		ready = true;
+	}
+
+
+	/**
+	 * @brief Compiles the pipeline with a job and returns right away: the pipeline is a handle, which can be drawn with once isReady returns true.
+	 * @details The options must live till the pipeline is ready (or destroyed), since the job reads them.
+	 *
+	 * @param name The name of the job, and of the compilation in the timeline. It must outlive the pipeline (e.g. a string literal).
+	 * @param timeline If not null, where the compilation is recorded.
+	 */
+	Pipeline(
+		const LogicalDevice& virtualGpu,
+		const PipelineOptions::RenderPass& renderPass,
+		int subpassIndex,
+		const std::vector<PipelineOptions::Shader*>& shaders,
+		const PipelineOptions::PipelineVertexArrays& vertexArraysDescriptor,
+		const PipelineOptions::PipelineLayout& pipelineLayout,
+		const PipelineOptions::Rasterizer& rasterizer,
+		const PipelineOptions::InputAssembly& inputAssembly,
+		const PipelineOptions::Multisampler& multisampler,
+		const PipelineOptions::DepthStencil& depthStencil,
+		const PipelineOptions::DynamicState& dynamicState,
+		const PipelineOptions::Viewport& viewport,
+		Utilities::JobSystem& jobs,
+		const char* name,
+		Utilities::Timeline* timeline = nullptr
+	) : virtualGpu{ virtualGpu }, pipelineLayout{ pipelineLayout }, jobs{ &jobs } {
+		jobs.submit(compilation, [this, &virtualGpu, &renderPass, subpassIndex, shaders, &vertexArraysDescriptor, &pipelineLayout, &rasterizer, &inputAssembly, &multisampler, &depthStencil, &dynamicState, &viewport, name, timeline]() {
+			std::optional<Utilities::Timeline::Scope> scope;
+			if (timeline != nullptr) {
+				scope.emplace(*timeline, name);
+			}
+			pipeline = create(virtualGpu, renderPass, subpassIndex, shaders, vertexArraysDescriptor, pipelineLayout, rasterizer, inputAssembly, multisampler, depthStencil, dynamicState, viewport);
+			}, name);
+	}
+
+	Pipeline(const Pipeline&&) = delete;
+	Pipeline(Pipeline&&) = delete;
+	Pipeline& operator=(const Pipeline&) = delete;
+	Pipeline& operator=(Pipeline&&) = delete;
+
+	~Pipeline() {
+		if (jobs != nullptr) {
+			try {
+				jobs->wait(compilation); //the job writes into this object
+			}
+			catch (...) {} //there is no pipeline to destroy
+		}
+		vkDestroyPipeline(+virtualGpu, pipeline, nullptr);
+	}
+
+	/**
+	 * @brief Returns the pipeline, which must be ready (see isReady).
+	 */
+	const VkPipeline& operator+() const {
+		return pipeline;
+	}
+
+
+	/**
+	 * @brief Returns whether the pipeline has been created, so it can be drawn with. Rethrows the error of the compilation, if it failed, at each call.
+	 */
+	bool isReady() {
+		if (!ready && compilation.isDone()) {
+			collect();
+		}
+		if (failure) {
+			std::rethrow_exception(failure);
+		}
+		return ready;
+	}
+
+
+	/**
+	 * @brief Returns when the pipeline is ready, running jobs in the meantime. Rethrows the error of the compilation, if it failed, at each call.
+	 */
+	void wait() {
+		if (!ready && !failure) {
+			collect();
+		}
+		if (failure) {
+			std::rethrow_exception(failure);
+		}
+	}
+
+
+	const PipelineOptions::PipelineLayout& getLayout() const {
+		return pipelineLayout;
+	}
+
+private:
+
+	//waits for the compilation and keeps its outcome, since the JobSystem forgets the error of a job once it has been rethrown
+	void collect() {
+		try {
+			jobs->wait(compilation);
+			if (pipeline == VK_NULL_HANDLE) {
+				throw VulkanException{ "Failed to create graphics pipeline!", "The compilation ended without a pipeline" };
+			}
+			ready = true;
+		}
+		catch (...) {
+			failure = std::current_exception();
+		}
+	}
+
+
+	static VkPipeline create(
+		const LogicalDevice& virtualGpu,
+		const PipelineOptions::RenderPass& renderPass,
+		int subpassIndex,
+		const std::vector<PipelineOptions::Shader*>& shaders,
+		const PipelineOptions::PipelineVertexArrays& vertexArraysDescriptor,
+		const PipelineOptions::PipelineLayout& pipelineLayout,
+		const PipelineOptions::Rasterizer& rasterizer,
+		const PipelineOptions::InputAssembly& inputAssembly,
+		const PipelineOptions::Multisampler& multisampler,
+		const PipelineOptions::DepthStencil& depthStencil,
+		const PipelineOptions::DynamicState& dynamicState,
+		const PipelineOptions::Viewport& viewport
+	) {
 		//create the array of VkPipelineShaderStageCreateInfo starting from the shaders
 		std::vector<VkPipelineShaderStageCreateInfo> shadersDescriptors;
 		for (const auto& shader : shaders) {
@@ -72,33 +203,21 @@ public:
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 		pipelineInfo.basePipelineIndex = -1;
 
-		if (VkResult result = vkCreateGraphicsPipelines(+virtualGpu, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline); result != VK_SUCCESS) {
+		VkPipeline pipeline;
+		if (VkResult result = vkCreateGraphicsPipelines(+virtualGpu, +virtualGpu.getPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline); result != VK_SUCCESS) {
 			throw VulkanException("Failed to create graphics pipeline!", result);
 		}
-	}
-
-	Pipeline(const Pipeline&&) = delete;
-	Pipeline(Pipeline&&) = delete;
-	Pipeline& operator=(const Pipeline&) = delete;
-	Pipeline& operator=(Pipeline&&) = delete;
-
-	~Pipeline() {
-		vkDestroyPipeline(+virtualGpu, pipeline, nullptr);
-	}
-
-	const VkPipeline& operator+() const {
 		return pipeline;
 	}
 
 
-	const PipelineOptions::PipelineLayout& getLayout() const {
-		return pipelineLayout;
-	}
-
-private:
-	VkPipeline pipeline;
+	VkPipeline pipeline = VK_NULL_HANDLE;
 	const LogicalDevice& virtualGpu;
 	const PipelineOptions::PipelineLayout& pipelineLayout;
+	Utilities::JobSystem* jobs = nullptr; //of the compilation, if the pipeline is compiled by a job
+	Utilities::JobCounter compilation;
+	bool ready = false; //only with a pipeline
+	std::exception_ptr failure; //the error of the compilation, if it failed
 };
 
 
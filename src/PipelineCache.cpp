@@ -0,0 +1,153 @@
+#include <vulkan/vulkan.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include "PipelineCache.h"
+#include "PhysicalDevice.h"
+#include "VulkanException.h"
+
+
+
+Vulkan::PipelineCache::PipelineCache(VkDevice virtualGpu, const PhysicalDevice& realGpu, std::string path) : virtualGpu{ virtualGpu }, path{ std::move(path) } {
+	const auto properties = realGpu.getProperties();
+	driverVersion = properties.driverVersion;
+	const auto data = load(properties);
+
+	VkPipelineCacheCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	createInfo.initialDataSize = data.size();
+	createInfo.pInitialData = data.data();
+
+	if (VkResult result = vkCreatePipelineCache(virtualGpu, &createInfo, nullptr, &pipelineCache); result != VK_SUCCESS) {
+		throw VulkanException("Failed to create the pipeline cache!", result);
+	}
+	loadedBytes = data.size();
+	loadedChecksum = getChecksum(data);
+
+	if (isWarm()) {
+		std::cout << "\n+ PipelineCache loaded " << loadedBytes << " bytes from " << this->path;
+	}
+	else {
+		std::cout << "\n+ PipelineCache empty: " << coldReason;
+	}
+}
+
+
+
+Vulkan::PipelineCache::~PipelineCache() {
+	vkDestroyPipelineCache(virtualGpu, pipelineCache, nullptr);
+}
+
+
+
+const VkPipelineCache& Vulkan::PipelineCache::operator+() const {
+	return pipelineCache;
+}
+
+
+
+void Vulkan::PipelineCache::save() const {
+	size_t size = 0;
+	VkResult result = vkGetPipelineCacheData(virtualGpu, pipelineCache, &size, nullptr);
+	std::vector<std::byte> data(size);
+	if (result == VK_SUCCESS) {
+		result = vkGetPipelineCacheData(virtualGpu, pipelineCache, &size, data.data());
+	}
+	if (result != VK_SUCCESS) {
+		std::cout << "\nFailed to read the pipeline cache (code " << result << ")";
+		return;
+	}
+	data.resize(size);
+	const uint64_t checksum = getChecksum(data);
+	if (size == loadedBytes && checksum == loadedChecksum) {
+		return; //no new pipelines
+	}
+
+	FileHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.driverVersion = driverVersion;
+	header.dataSize = size;
+	header.checksum = checksum;
+
+	const std::string temporaryPath = path + ".tmp";
+	{
+		std::ofstream out{ temporaryPath, std::ios::binary | std::ios::trunc };
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(data.data()), data.size());
+		if (!out) {
+			std::cout << "\nFailed to write the pipeline cache to " << temporaryPath;
+			return;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error) {
+		std::cout << "\nFailed to write the pipeline cache to " << path << ": " << error.message();
+		return;
+	}
+	std::cout << "\n- PipelineCache saved " << size << " bytes to " << path;
+}
+
+
+
+std::vector<std::byte> Vulkan::PipelineCache::load(const VkPhysicalDeviceProperties& properties) {
+	std::ifstream in{ path, std::ios::binary | std::ios::ate };
+	if (!in) {
+		coldReason = "no cache at " + path;
+		return {};
+	}
+	const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+	in.seekg(0);
+
+	FileHeader header{};
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+		coldReason = path + " is not a pipeline cache";
+		return {};
+	}
+	if (header.driverVersion != properties.driverVersion) {
+		coldReason = path + " has been made by another driver version";
+		return {};
+	}
+
+	if (header.dataSize != fileSize - sizeof(header)) {
+		coldReason = path + " is corrupted";
+		return {};
+	}
+	std::vector<std::byte> data(header.dataSize);
+	if (!in.read(reinterpret_cast<char*>(data.data()), data.size()) || getChecksum(data) != header.checksum) {
+		coldReason = path + " is corrupted";
+		return {};
+	}
+
+	//the header of the Vulkan cache (VK_PIPELINE_CACHE_HEADER_VERSION_ONE): its length, its version, the vendor, the device and the pipeline cache UUID
+	uint32_t vulkanHeader[4];
+	if (data.size() < sizeof(vulkanHeader) + VK_UUID_SIZE) {
+		coldReason = path + " is corrupted";
+		return {};
+	}
+	std::memcpy(vulkanHeader, data.data(), sizeof(vulkanHeader));
+	if (vulkanHeader[0] < sizeof(vulkanHeader) + VK_UUID_SIZE || vulkanHeader[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) {
+		coldReason = path + " has an unknown format";
+		return {};
+	}
+	if (vulkanHeader[2] != properties.vendorID || vulkanHeader[3] != properties.deviceID || std::memcmp(data.data() + sizeof(vulkanHeader), properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+		coldReason = path + " has been made by another device or driver";
+		return {};
+	}
+	return data;
+}
+
+
+
+uint64_t Vulkan::PipelineCache::getChecksum(const std::vector<std::byte>& data) {
+	//FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (auto byte : data) {
+		hash = (hash ^ static_cast<uint64_t>(byte)) * 1099511628211ull;
+	}
+	return hash;
+}
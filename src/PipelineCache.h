@@ -0,0 +1,102 @@
+#ifndef VULKAN_PIPELINECACHE
+#define VULKAN_PIPELINECACHE
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace Vulkan { class PipelineCache; class PhysicalDevice; }
+
+/**
+ * @brief The pipeline cache of the device, which is loaded from a file at startup and saved to it at shutdown, so that the shaders are compiled by the driver only the first time a pipeline is created.
+ * @details The file is this program's header (a magic number, the driver version, the size and a checksum of the data) followed by the data of the Vulkan cache, which starts with the vendor, the device and the pipeline cache UUID it was made by.
+ *			The data is given to the driver only if all of them match the current device and driver (the pipeline cache UUID changes with the driver), since a driver may not reject a corrupted or foreign cache gracefully; otherwise the cache starts empty (cold).
+ *			The cache is owned by the LogicalDevice, which saves it before it is destroyed. Creating pipelines with the same cache from many threads is safe.
+ */
+class Vulkan::PipelineCache {
+public:
+
+	/**
+	 * @brief Creates the cache from the content of the file at path, if it is valid for this device, else empty.
+	 */
+	PipelineCache(VkDevice virtualGpu, const PhysicalDevice& realGpu, std::string path);
+
+	~PipelineCache();
+
+	PipelineCache(const PipelineCache&) = delete;
+	PipelineCache(PipelineCache&&) = delete;
+	PipelineCache& operator=(const PipelineCache&) = delete;
+	PipelineCache& operator=(PipelineCache&&) = delete;
+
+
+	const VkPipelineCache& operator+() const;
+
+
+	/**
+	 * @brief Writes the content of the cache to the file (through a temporary file, so that a crash never leaves a truncated cache), unless it hasn't changed since it was loaded.
+	 * @details It doesn't throw: if the file cannot be written, the next run starts cold.
+	 */
+	void save() const;
+
+
+	/**
+	 * @brief Returns whether the cache has been loaded from the file, so the pipelines of the previous runs don't need to be compiled.
+	 */
+	bool isWarm() const {
+		return loadedBytes > 0;
+	}
+
+
+	/**
+	 * @brief Returns why the cache is cold (e.g. the file has been made by another driver), or an empty string if it is warm.
+	 */
+	const std::string& getColdReason() const {
+		return coldReason;
+	}
+
+
+	size_t getLoadedBytes() const {
+		return loadedBytes;
+	}
+
+
+	const std::string& getPath() const {
+		return path;
+	}
+
+
+private:
+
+	struct FileHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t driverVersion;
+		uint32_t reserved;
+		uint64_t dataSize;
+		uint64_t checksum; //of the data
+	};
+
+	static constexpr char MAGIC[4] = { 'V', 'K', 'P', 'C' };
+	static constexpr uint32_t VERSION = 1;
+
+
+	//Read the data of the cache from the file, or set coldReason and return nothing if it is missing or not valid for this device
+	std::vector<std::byte> load(const VkPhysicalDeviceProperties& properties);
+
+	static uint64_t getChecksum(const std::vector<std::byte>& data);
+
+
+	VkPipelineCache pipelineCache;
+	VkDevice virtualGpu;
+	std::string path;
+	uint32_t driverVersion;
+	size_t loadedBytes = 0;
+	uint64_t loadedChecksum = 0;
+	std::string coldReason;
+};
+
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef VULKAN_PLANARROTATION
+#define VULKAN_PLANARROTATION
+
+#include <cmath>
+#include <numbers>
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+
+namespace Vulkan::Physics {
+
+	/**
+	 * @brief A rotation around the z axis, stored as an angle and its sine and cosine.
+	 * @details The physics of the table happens on the xy plane, so this is all a body needs to rotate its vertices: 2 multiplications and an addition per coordinate, and no trigonometry at all unless the angle changes.
+	 *			The quaternion is built only when someone asks for it (e.g. the model matrix of the graphics).
+	 */
+	class PlanarRotation {
+	public:
+		PlanarRotation(float angle = 0.0f) : angle{ 0.0f }, sin{ 0.0f }, cos{ 1.0f } {
+			setAngle(angle);
+		}
+
+
+		/**
+		 * @brief Adds an angle (radians, counterclockwise) to the rotation. Sine and cosine are updated only if the angle actually changes.
+		 */
+		void rotate(float delta) {
+			if (delta != 0.0f) {
+				setAngle(angle + delta);
+			}
+		}
+
+
+		void setAngle(float angle) {
+			this->angle = std::remainder(angle, 2.0f * std::numbers::pi_v<float>); //keep the angle small, so that it doesn't lose precision
+			sin = std::sin(this->angle);
+			cos = std::cos(this->angle);
+		}
+
+
+		float getAngle() const {
+			return angle;
+		}
+
+		float getSin() const {
+			return sin;
+		}
+
+		float getCos() const {
+			return cos;
+		}
+
+
+		/**
+		 * @brief Rotates a vector around the z axis.
+		 */
+		glm::vec3 apply(const glm::vec3& v) const {
+			return glm::vec3{ cos * v.x - sin * v.y, sin * v.x + cos * v.y, v.z };
+		}
+
+
+		/**
+		 * @brief Rotates a vector around the z axis by the opposite angle (e.g. from the reference system of the world to the one of a rotated body).
+		 */
+		glm::vec3 applyInverse(const glm::vec3& v) const {
+			return glm::vec3{ cos * v.x + sin * v.y, -sin * v.x + cos * v.y, v.z };
+		}
+
+
+		glm::quat toQuaternion() const {
+			return glm::angleAxis(angle, glm::vec3{ 0.0f, 0.0f, 1.0f });
+		}
+
+
+		/**
+		 * @brief Returns the angle of the rotation around z of a quaternion, ignoring any other component.
+		 */
+		static float angleAroundZ(const glm::quat& rotation) {
+			return 2.0f * std::atan2(rotation.z, rotation.w);
+		}
+
+
+	private:
+		float angle;
+		float sin;
+		float cos;
+	};
+
+}
+
+
+#endif
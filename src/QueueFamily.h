@@ -6,7 +6,7 @@
  */
 namespace Vulkan {
 	enum class QueueFamily {
-		GRAPHICS, PRESENTATION
+		GRAPHICS, PRESENTATION, TRANSFER
 	};
 }
 
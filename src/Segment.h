@@ -59,7 +59,7 @@ namespace Vulkan::Physics {
 			return origin;
 		}
 
-		const Position& getEnd() const {
+		Position getEnd() const {
 			return origin + direction;
 		}
 
@@ -3,7 +3,7 @@
 #include "VulkanException.h"
 
 
-Vulkan::PipelineOptions::Shader::Shader(const LogicalDevice& virtualGpu, std::string spirvFileName, VkShaderStageFlagBits shaderType, std::string entrypoint) : virtualGpu{ virtualGpu }, shaderStageInfo{}, entrypoint{ entrypoint } {
+Vulkan::PipelineOptions::Shader::Shader(const LogicalDevice& virtualGpu, std::string spirvFileName, VkShaderStageFlagBits shaderType, std::string entrypoint, SpecializationConstants constants) : virtualGpu{ virtualGpu }, shaderStageInfo{}, entrypoint{ entrypoint }, constants{ std::move(constants) } {
 	auto code = readSpirvFile(spirvFileName); //the code of the shader in SPIR-V format
 
 	//struct to create the shader module
@@ -21,11 +21,22 @@ Vulkan::PipelineOptions::Shader::Shader(const LogicalDevice& virtualGpu, std::st
 	shaderStageInfo.stage = shaderType;
 	shaderStageInfo.module = shaderModule;
 	shaderStageInfo.pName = this->entrypoint.c_str();
+	specializationInfo = this->constants.getInfo();
+	shaderStageInfo.pSpecializationInfo = this->constants.isEmpty() ? nullptr : &specializationInfo;
+}
+
+
+Vulkan::PipelineOptions::Shader::Shader(const Shader& shader, SpecializationConstants constants) : shaderModule{ shader.shaderModule }, shaderStageInfo{ shader.shaderStageInfo }, virtualGpu{ shader.virtualGpu }, entrypoint{ shader.entrypoint }, constants{ std::move(constants) }, isVariant{ true } {
+	shaderStageInfo.pName = entrypoint.c_str();
+	specializationInfo = this->constants.getInfo();
+	shaderStageInfo.pSpecializationInfo = this->constants.isEmpty() ? nullptr : &specializationInfo;
 }
 
 
 Vulkan::PipelineOptions::Shader::~Shader() {
-	vkDestroyShaderModule(+virtualGpu, shaderModule, nullptr);
+	if (!isVariant) {
+		vkDestroyShaderModule(+virtualGpu, shaderModule, nullptr);
+	}
 }
 
 
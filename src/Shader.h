@@ -6,6 +6,7 @@
 #include <vector>
 #include <string>
 
+#include "SpecializationConstants.h"
 
 namespace Vulkan { class LogicalDevice; namespace PipelineOptions { class Shader; } }
 
@@ -22,8 +23,15 @@ class Vulkan::PipelineOptions::Shader {
 		 * @param spirvFileName Path to the SPIR-V code. The root of the path is the folder where the executable od the program using this class is placed.
 		 * @param shaderType The type of the shader (generally a vertex, tessellation or fragment shader).
 		 * @param entrypoint Name of the first function to call in the shader.
+		 * @param constants The values of the specialization constants of the shader, which the pipelines using it are compiled with.
 		 */
-		Shader(const LogicalDevice& virtualGpu, std::string spirvFileName, VkShaderStageFlagBits shaderType, std::string entrypoint = "main");
+		Shader(const LogicalDevice& virtualGpu, std::string spirvFileName, VkShaderStageFlagBits shaderType, std::string entrypoint = "main", SpecializationConstants constants = SpecializationConstants{});
+
+		/**
+		 * @brief Creates a variant of a shader: the same code, with other values of its specialization constants (e.g. one per lighting model).
+		 * @details The variant shares the code of shader, so it must not outlive it.
+		 */
+		Shader(const Shader& shader, SpecializationConstants constants);
 
 		Shader(const Shader&) = delete;
 		Shader(Shader&&) = delete;
@@ -50,6 +58,9 @@ class Vulkan::PipelineOptions::Shader {
 		VkPipelineShaderStageCreateInfo shaderStageInfo;
 		const LogicalDevice& virtualGpu;
 		std::string entrypoint;
+		SpecializationConstants constants;
+		VkSpecializationInfo specializationInfo;
+		bool isVariant = false; //whether the module belongs to another shader
 };
 
 #endif
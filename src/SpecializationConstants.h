@@ -0,0 +1,75 @@
+#ifndef VULKAN_SPECIALIZATIONCONSTANTS
+#define VULKAN_SPECIALIZATIONCONSTANTS
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+namespace Vulkan::PipelineOptions { class SpecializationConstants; }
+
+/**
+ * @brief The values of the specialization constants of a shader (the ones declared with layout(constant_id = ...) in GLSL), which are fixed when a pipeline is created.
+ * @details The driver compiles the shader with these values, so the code they disable is compiled out: a pipeline per combination of the values replaces a branch on a uniform in each invocation.
+ */
+class Vulkan::PipelineOptions::SpecializationConstants {
+public:
+
+	SpecializationConstants() = default;
+
+
+	/**
+	 * @brief Sets the value of the constant with constantId, which replaces its default value in the shader.
+	 *
+	 * @tparam T The type of the constant in the shader: int, uint, float or bool.
+	 * @return This object, so that many constants are set in a single expression.
+	 */
+	template<typename T> requires std::same_as<T, int32_t> || std::same_as<T, uint32_t> || std::same_as<T, float> || std::same_as<T, bool>
+	SpecializationConstants& set(uint32_t constantId, T value) {
+		uint32_t word; //each type takes 4 bytes, a bool is a VkBool32
+		if constexpr (std::same_as<T, bool>) {
+			word = value ? VK_TRUE : VK_FALSE;
+		}
+		else {
+			std::memcpy(&word, &value, sizeof(word));
+		}
+
+		auto entry = std::find_if(entries.begin(), entries.end(), [constantId](const VkSpecializationMapEntry& entry) { return entry.constantID == constantId; });
+		if (entry == entries.end()) {
+			entries.push_back(VkSpecializationMapEntry{ constantId, static_cast<uint32_t>(data.size() * sizeof(uint32_t)), sizeof(uint32_t) });
+			data.push_back(word);
+		}
+		else {
+			data[entry->offset / sizeof(uint32_t)] = word;
+		}
+		return *this;
+	}
+
+
+	bool isEmpty() const {
+		return entries.empty();
+	}
+
+
+	/**
+	 * @brief Returns the VkSpecializationInfo of the constants, which points into this object: it is valid as long as the object isn't changed or destroyed.
+	 */
+	VkSpecializationInfo getInfo() const {
+		VkSpecializationInfo info{};
+		info.mapEntryCount = static_cast<uint32_t>(entries.size());
+		info.pMapEntries = entries.data();
+		info.dataSize = data.size() * sizeof(uint32_t);
+		info.pData = data.data();
+		return info;
+	}
+
+
+private:
+	std::vector<VkSpecializationMapEntry> entries;
+	std::vector<uint32_t> data;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef VULKAN_SPSCQUEUE
+#define VULKAN_SPSCQUEUE
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+namespace Vulkan::Utilities {
+
+	/**
+	 * @brief A lock-free single-producer single-consumer queue of fixed capacity.
+	 * @details The producer never waits for the consumer: if the queue is full, new items are dropped (and counted) instead of overwriting unread ones. Only one thread may push and only one (other) thread may drain.
+	 */
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	class SpscQueue {
+	public:
+
+		/**
+		 * @param capacity Maximum number of unread items, rounded up to a power of 2.
+		 */
+		SpscQueue(size_t capacity) : ring(std::bit_ceil(std::max<size_t>(capacity, 2))), mask{ ring.size() - 1 }, head{ 0 }, tail{ 0 }, dropped{ 0 } {}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+
+
+
+		/**
+		 * @brief Adds an item. To be called only by the producer.
+		 *
+		 * @param reserved Number of places to keep free after the item, for items which must not be dropped later.
+		 * @return Whether the item has been added, false if the queue was full.
+		 */
+		bool push(const T& item, size_t reserved = 0) {
+			auto currentHead = head.load(std::memory_order_relaxed);
+			if (currentHead - tail.load(std::memory_order_acquire) + reserved >= ring.size()) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			ring[currentHead & mask] = item;
+			head.store(currentHead + 1, std::memory_order_release);
+			return true;
+		}
+
+
+		/**
+		 * @brief Passes all the unread items, oldest first, to a function. To be called only by the consumer.
+		 *
+		 * @return The number of items read.
+		 */
+		template<typename F>
+		size_t drain(F&& consume) {
+			auto currentTail = tail.load(std::memory_order_relaxed);
+			auto currentHead = head.load(std::memory_order_acquire);
+			for (auto i = currentTail; i != currentHead; ++i) {
+				consume(ring[i & mask]);
+			}
+			tail.store(currentHead, std::memory_order_release);
+			return currentHead - currentTail;
+		}
+
+
+		/**
+		 * @brief Returns how many items have been dropped because the queue was full.
+		 */
+		uint64_t getDropped() const {
+			return dropped.load(std::memory_order_relaxed);
+		}
+
+
+	private:
+		std::vector<T> ring;
+		const size_t mask;
+		alignas(64) std::atomic<uint64_t> head; //next item to write, written only by the producer
+		alignas(64) std::atomic<uint64_t> tail; //next item to read, written only by the consumer
+		std::atomic<uint64_t> dropped;
+	};
+
+}
+
+
+#endif
@@ -2,6 +2,8 @@
 #define VULKAN_STAGINGBUFFER
 
 #include <vulkan/vulkan.h>
+#include <cstddef>
+#include <span>
 
 #include "LogicalDevice.h"
 #include "PhysicalDevice.h"
@@ -15,16 +17,21 @@ class Vulkan::Buffers::StagingBuffer : public Buffer {
 public:
 
     StagingBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
-
+        mapPersistently();
     }
 
 
 
     void fillBuffer(unsigned char* data, size_t size) {
-        void* rawData;
-        vkMapMemory(+virtualGpu, bufferMemory, 0, size, 0, &rawData);
-        memcpy(rawData, data, size);
-        vkUnmapMemory(+virtualGpu, bufferMemory);
+        write(data, size, 0);
+    }
+
+
+    /**
+     * @brief Returns the whole memory of the buffer, which is mapped for the lifetime of the buffer. The memory is coherent, so what is written there needn't be flushed.
+     */
+    std::span<std::byte> getMappedMemory() {
+        return { mapped, size };
     }
 
 
@@ -2,7 +2,10 @@
 #define VULKAN_STATICSET
 
 #include <glm/glm.hpp>
+#include <map>
+#include <span>
 #include <tuple>
+#include <vector>
 #include <concepts>
 #include <type_traits>
 
@@ -17,6 +20,7 @@ namespace Vulkan {
 
 	/**
 	 * @brief In a static set there isn't the notion of 'object' (like in DynamicSet). Each binding is "single". It can also contain images.
+	 * @details The buffer bindings are dynamic uniform buffers, whose dynamic offset is the current region of their buffer (see getDynamicOffsets), so that a binding in a FrameRingBuffer follows the frames in flight.
 	 */
 	class StaticSet : public Set {
 	public:
@@ -25,7 +29,7 @@ namespace Vulkan {
 			StaticBufferBindingInfo(int size, const Buffers::UniformBuffer& buffer, int offset) : size{ size }, buffer{ buffer }, offset{ offset } {}
 
 			DescriptorSetBindingCreationInfo generateDescriptorSetBindingInfo(const VkDescriptorSet& descriptorSet) const override {
-				return DescriptorSetBindingCreationInfo{ binding, descriptorSet, size, buffer, offset };
+				return DescriptorSetBindingCreationInfo{ binding, descriptorSet, size, buffer, offset, 0 }; //dynamic, the dynamic offset is the region of the buffer
 			}
 
 			int size; //the size of the binding
@@ -35,13 +39,13 @@ namespace Vulkan {
 
 
 		struct ImageBindingInfo : public Set::BindingInfo {
-			ImageBindingInfo(const TextureImage& texture) : texture{ texture } {}
+			ImageBindingInfo(const TextureImage& texture) : texture{ &texture } {}
 
 			DescriptorSetBindingCreationInfo generateDescriptorSetBindingInfo(const VkDescriptorSet& descriptorSet) const override {
-				return DescriptorSetBindingCreationInfo{ binding, descriptorSet, texture };
+				return DescriptorSetBindingCreationInfo{ binding, descriptorSet, *texture };
 			}
 
-			const TextureImage& texture;
+			const TextureImage* texture; //a pointer, since the texture of the binding can be changed (see setTexture)
 		};
 
 
@@ -58,11 +62,11 @@ namespace Vulkan {
 		 * @param ...bindingsInfo
 		 */
 		template<typename... Structs, typename... T> requires
-			((std::same_as<T, std::tuple<VkShaderStageFlagBits, Structs, Buffers::UniformBuffer*, int>> || std::same_as<T, std::tuple<VkShaderStageFlagBits, TextureImage*>>) && ...)
+			((std::same_as<T, std::tuple<VkShaderStageFlagBits, Structs, Buffers::UniformBuffer*, int>> || std::same_as<T, std::tuple<VkShaderStageFlagBits, const TextureImage*>>) && ...)
 			StaticSet(const LogicalDevice& virtualGpu, const T&... bindingsInfo) : Set{ virtualGpu } {
 			(this->bindingsInfo.push_back(createBindingInfo(bindingsInfo)), ...);
 
-			createDescriptorSetLayout(std::pair{ std::get<0>(bindingsInfo), std::same_as<T, std::tuple<VkShaderStageFlagBits, TextureImage*>> ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }...);
+			createDescriptorSetLayout(std::pair{ std::get<0>(bindingsInfo), std::same_as<T, std::tuple<VkShaderStageFlagBits, const TextureImage*>> ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC }...);
 		}
 
 
@@ -81,21 +85,54 @@ namespace Vulkan {
 		 */
 		template<typename... Bindings>
 		void fillBuffer(Buffers::UniformBuffer& buffer, const Bindings&... bindings) const {
-			std::vector<StaticBufferBindingInfo*> bindingsInfo;
-			try {
-				bindingsInfo = bindingsPerBuffer.at(&buffer); //get the info of the bindings of the buffer
-			}
-			catch (const std::out_of_range&) {
+			auto found = bindingsPerBuffer.find(&buffer); //get the info of the bindings of the buffer (by reference, since it is called every frame)
+			if (found == bindingsPerBuffer.end()) {
 				throw VulkanException{ "Failed to fill the uniform buffer", "The buffer to be filled isn't used in this set" };
 			}
+			const auto& bindingsInfo = found->second;
 
 			//fill the buffer by placing the n-th binding at the position pointed by the n-th bindingInfo (for the buffer) offset
 			int counter = 0;
-			([&bindingsInfo, &counter, &buffer](Bindings binding) {
+			([&bindingsInfo, &counter, &buffer](const Bindings& binding) {
 				buffer.fillBuffer(binding, bindingsInfo[counter]->offset);
 				counter++;
 				}(bindings), ...);
+			buffer.flush();
+
+		}
+
+
+
+		/**
+		 * @brief Changes the texture of an image binding. The descriptor sets of this set which already exist keep the old texture till they are updated (see DescriptorSet::update).
+		 */
+		void setTexture(int binding, const TextureImage& texture) {
+			auto imageBinding = dynamic_cast<ImageBindingInfo*>(bindingsInfo.at(binding).get());
+			if (!imageBinding) {
+				throw VulkanException{ "Failed to set the texture", "The binding isn't an image binding" };
+			}
+			imageBinding->texture = &texture;
+		}
+
 
+
+		/**
+		 * @brief Returns the number of buffer bindings, i.e. the number of dynamic offsets needed to bind the descriptor set.
+		 */
+		int getAmountOfDynamicBindings() const {
+			return static_cast<int>(bufferBindings.size());
+		}
+
+
+		/**
+		 * @brief Writes the dynamic offset of each buffer binding, in order: the offset of the current region of its buffer (see UniformBuffer::getRegionOffset).
+		 *
+		 * @param offsets Where to write the offsets, at least getAmountOfDynamicBindings() elements.
+		 */
+		void getDynamicOffsets(std::span<uint32_t> offsets) const {
+			for (size_t i = 0; i < bufferBindings.size(); ++i) {
+				offsets[i] = bufferBindings[i]->buffer.getRegionOffset();
+			}
 		}
 
 
@@ -107,11 +144,12 @@ namespace Vulkan {
 			auto tmp = std::make_unique<StaticBufferBindingInfo>(sizeof(std::get<1>(info)), *std::get<2>(info), std::get<3>(info));
 			tmp->binding = bindingsInfo.size();
 			bindingsPerBuffer[std::get<2>(info)].push_back(tmp.get());
+			bufferBindings.push_back(tmp.get());
 			return tmp;
 		}
 
 
-		std::unique_ptr<ImageBindingInfo> createBindingInfo(const std::tuple<VkShaderStageFlagBits, TextureImage*>& info) {
+		std::unique_ptr<ImageBindingInfo> createBindingInfo(const std::tuple<VkShaderStageFlagBits, const TextureImage*>& info) {
 			auto tmp = std::make_unique<ImageBindingInfo>(*std::get<1>(info));
 			tmp->binding = bindingsInfo.size();
 			return tmp;
@@ -119,6 +157,7 @@ namespace Vulkan {
 
 
 		std::map<const Buffers::UniformBuffer*, std::vector<StaticBufferBindingInfo*>> bindingsPerBuffer; //this map holds the bindings relative to each buffer used in the Set
+		std::vector<StaticBufferBindingInfo*> bufferBindings; //the buffer bindings, in order (the order of their dynamic offsets)
 
 
 	};
@@ -0,0 +1,356 @@
+#ifndef VULKAN_TABLE
+#define VULKAN_TABLE
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TableFile.h"
+#include "Hitbox.h"
+#include "Field.h"
+#include "FieldFunctions.h"
+#include "Universe.h"
+#include "GameStatus.h"
+#include "PhysicsArena.h"
+
+
+namespace Vulkan::Physics {
+
+	/**
+	 * @brief The physical objects of a pinball table (hitboxes, fields and universes) built from a TableFile.
+	 * @details Hitboxes and fields are built in a PhysicsArena, grouped by type and in the order of the table file, so that the universes walk them (almost) linearly in memory. Models point to them, so the Table must outlive the models.
+	 *			A Table doesn't depend on the TableFile after it has been built.
+	 */
+	class Table {
+	public:
+
+		/**
+		 * @brief The description of a model of the table, to be loaded by the graphics side.
+		 */
+		struct ModelDescription {
+			uint32_t hitbox;
+			std::string path;
+			glm::vec3 rotation;
+		};
+
+
+		/**
+		 * @brief Builds the table.
+		 *
+		 * @param file The table file.
+		 * @param externalArena If not null, the arena the objects are built in (e.g. to reuse the same memory for many games). They stay in the arena after the Table is destroyed: the caller resets the arena (after the Table has been destroyed) to destroy them. If null, the table uses its own arena.
+		 */
+		Table(const TableFile& file, PhysicsArena* externalArena = nullptr) : arena{ externalArena != nullptr ? *externalArena : ownArena }, gameUniverse{ nullptr }, leftPad{ nullptr }, rightPad{ nullptr }, puller{ nullptr }, pullerRestingPosition{} {
+			const auto& header = file.getHeader();
+
+			//hitboxes
+			hitboxes.reserve(file.getHitboxes().size());
+			for (const auto& record : file.getHitboxes()) {
+				hitboxes.push_back(&makeHitbox(file, record));
+				hitboxNames.emplace_back(file.getString(record.name));
+				actions.push_back(record.action);
+			}
+
+			//fields
+			fields.reserve(file.getFields().size());
+			for (const auto& record : file.getFields()) {
+				fields.push_back(&arena.create<Field>(makeField(record.type, toPosition(record.position), record.intensity)));
+				fieldTypes.push_back(record.type);
+			}
+
+			//universes
+			for (const auto& record : file.getUniverses()) {
+				std::vector<Field*> universeFields;
+				for (auto i : file.getIndices(record.fields)) {
+					universeFields.push_back(fields[i]);
+				}
+				std::vector<Hitbox*> universeBodies;
+				for (auto i : file.getIndices(record.bodies)) {
+					universeBodies.push_back(hitboxes[i]);
+				}
+				universes.push_back(std::make_unique<Universe>(std::move(universeFields), std::move(universeBodies)));
+				universeNames.emplace_back(file.getString(record.name));
+			}
+
+			//models and lights
+			for (const auto& record : file.getModels()) {
+				models.push_back(ModelDescription{ record.hitbox, std::string{ file.getString(record.path) }, glm::vec3{ record.rotation.x, record.rotation.y, record.rotation.z } });
+			}
+			lights.assign(file.getLights().begin(), file.getLights().end());
+
+			//game roles
+			gameUniverse = header.gameUniverse != TableFormat::NONE ? universes[header.gameUniverse].get() : nullptr;
+			leftPad = header.leftPad != TableFormat::NONE ? hitboxes[header.leftPad] : nullptr;
+			rightPad = header.rightPad != TableFormat::NONE ? hitboxes[header.rightPad] : nullptr;
+			puller = header.puller != TableFormat::NONE ? hitboxes[header.puller] : nullptr;
+			if (puller != nullptr) {
+				pullerRestingPosition = puller->getPosition();
+			}
+			for (auto i : file.getIndices(header.balls)) {
+				balls.push_back(hitboxes[i]);
+			}
+			for (auto i : file.getIndices(header.bumpers)) {
+				bumpers.push_back(hitboxes[i]);
+			}
+		}
+
+		Table(const Table&) = delete;
+		Table& operator=(const Table&) = delete;
+
+
+
+		size_t getHitboxesCount() const {
+			return hitboxes.size();
+		}
+
+		Hitbox& getHitbox(uint32_t i) const {
+			return *hitboxes[i];
+		}
+
+		const std::string& getHitboxName(uint32_t i) const {
+			return hitboxNames[i];
+		}
+
+		TableFormat::CollisionAction getCollisionAction(uint32_t i) const {
+			return actions[i];
+		}
+
+		/**
+		 * @brief Returns the index of the hitbox with the specified name. Throws std::out_of_range if there is no such hitbox.
+		 */
+		uint32_t findHitbox(const std::string& name) const {
+			auto found = std::find(hitboxNames.begin(), hitboxNames.end(), name);
+			if (found == hitboxNames.end()) {
+				throw std::out_of_range{ "The table has no hitbox named " + name };
+			}
+			return static_cast<uint32_t>(std::distance(hitboxNames.begin(), found));
+		}
+
+
+		/**
+		 * @brief Returns the universe with the specified name. Throws std::out_of_range if there is no such universe.
+		 */
+		Universe& getUniverse(const std::string& name) const {
+			auto found = std::find(universeNames.begin(), universeNames.end(), name);
+			if (found == universeNames.end()) {
+				throw std::out_of_range{ "The table has no universe named " + name };
+			}
+			return *universes[std::distance(universeNames.begin(), found)];
+		}
+
+		std::vector<Universe*> getUniverses() const {
+			std::vector<Universe*> res;
+			for (const auto& universe : universes) {
+				res.push_back(universe.get());
+			}
+			return res;
+		}
+
+		const std::vector<ModelDescription>& getModels() const {
+			return models;
+		}
+
+
+
+		Universe& getGameUniverse() const {
+			return *checkRole(gameUniverse, "game universe");
+		}
+
+		Hitbox& getLeftPad() const {
+			return *checkRole(leftPad, "left pad");
+		}
+
+		Hitbox& getRightPad() const {
+			return *checkRole(rightPad, "right pad");
+		}
+
+		Hitbox& getPuller() const {
+			return *checkRole(puller, "puller");
+		}
+
+		const Position& getPullerRestingPosition() const {
+			checkRole(puller, "puller");
+			return pullerRestingPosition;
+		}
+
+		const std::vector<Hitbox*>& getBalls() const {
+			return balls;
+		}
+
+		const std::vector<Hitbox*>& getBumpers() const {
+			return bumpers;
+		}
+
+
+
+		/**
+		 * @brief Changes the intensity of all the fields of a type (e.g. to tune the friction without compiling the table again).
+		 */
+		void setFieldIntensity(TableFormat::FieldType type, float intensity) {
+			for (size_t i = 0; i < fields.size(); ++i) {
+				if (fieldTypes[i] == type) {
+					*fields[i] = makeField(type, fields[i]->getPosition(), intensity); //universes point to the field, so it is changed in place
+				}
+			}
+		}
+
+
+		/**
+		 * @brief Binds the collision actions of the table to a game.
+		 *
+		 * @param gameStatus The game the actions act on.
+		 * @param onCollision Optional function called on every collision of every hitbox, with the index of the hitbox, before its action (so it sees the game as it was before the collision).
+		 */
+		void bindCollisionActions(GameStatus& gameStatus, std::function<void(uint32_t, Hitbox&)> onCollision = {}) {
+			for (uint32_t i = 0; i < hitboxes.size(); ++i) {
+				std::function<void(Hitbox&)> action; //empty if the hitbox has no action
+				switch (actions[i]) {
+				case TableFormat::CollisionAction::INVERT_BUMPER:
+					action = [&gameStatus, bumper = hitboxes[i]](Hitbox&) {
+						gameStatus.invertBumper(bumper);
+					};
+					break;
+				case TableFormat::CollisionAction::KILL_BALL:
+					action = [&gameStatus](Hitbox& collidingBall) {
+						gameStatus.killBall(&collidingBall);
+					};
+					break;
+				case TableFormat::CollisionAction::START_GAME:
+					action = [this, &gameStatus](Hitbox&) {
+						gameStatus.startNewGame(getPuller().getSpeed());
+						getPuller().reset(pullerRestingPosition);
+					};
+					break;
+				default:
+					break;
+				}
+
+				if (onCollision) {
+					hitboxes[i]->setCollisionAction([action, onCollision, i](Hitbox& collidingObject) {
+						onCollision(i, collidingObject);
+						if (action) {
+							action(collidingObject);
+						}
+					});
+				}
+				else {
+					hitboxes[i]->setCollisionAction(action);
+				}
+			}
+		}
+
+
+		/**
+		 * @brief Moves the point lights of the table where their hitboxes are.
+		 */
+		void updateLights(Lights& lights) const {
+			for (const auto& light : this->lights) {
+				auto position = hitboxes[light.hitbox]->getPosition();
+				getPointLightPosition(lights, light.slot) = glm::vec3{ position.x(), position.y(), light.height };
+			}
+		}
+
+
+
+		/**
+		 * @brief Builds the Field corresponding to a FieldType.
+		 */
+		static Field makeField(TableFormat::FieldType type, Position position, float intensity) {
+			switch (type) {
+			case TableFormat::FieldType::GRAVITY:
+				return Field{ position, &FieldFunctions::gravity, intensity };
+			case TableFormat::FieldType::FRICTION:
+				return Field{ position, &FieldFunctions::friction, intensity };
+			case TableFormat::FieldType::CENTRAL:
+				return Field{ position, &FieldFunctions::centralField, intensity };
+			default:
+				throw std::runtime_error{ "Unknown field type " + std::to_string(static_cast<uint32_t>(type)) };
+			}
+		}
+
+
+	private:
+
+		static Position toPosition(const TableFormat::Vec3& v) {
+			return Position{ v.x, v.y, v.z };
+		}
+
+
+		Hitbox& makeHitbox(const TableFile& file, const TableFormat::HitboxRecord& record) {
+			Hitbox* hitbox;
+			if (record.type == TableFormat::HitboxType::CIRCLE) {
+				hitbox = record.mass > 0.0f ?
+					&arena.create<CircleHitbox>(record.radius, toPosition(record.position), record.scale, record.mass) :
+					&arena.create<CircleHitbox>(record.radius, toPosition(record.position), record.scale);
+			}
+			else {
+				std::vector<Position> vertices;
+				for (const auto& vertex : file.getVertices(record.vertices)) {
+					vertices.push_back(toPosition(vertex));
+				}
+				Mass mass = record.mass > 0.0f ? Mass{ record.mass } : Mass{ std::numeric_limits<float>::max() / 10.0f }; //the same mass the constructors of static hitboxes use
+
+				switch (record.type) {
+				case TableFormat::HitboxType::CAPSULE:
+					hitbox = &arena.create<CapsuleHitbox>(toPosition(record.position), record.scale, mass, vertices[0], vertices[1], record.radius);
+					break;
+				case TableFormat::HitboxType::POLYGON:
+					hitbox = &arena.create<ConvexPolygonHitbox>(toPosition(record.position), record.scale, mass, std::move(vertices));
+					break;
+				default:
+					hitbox = record.mass > 0.0f ?
+						&arena.create<FrameHitbox>(toPosition(record.position), record.scale, Mass{ record.mass }, std::move(vertices)) :
+						&arena.create<FrameHitbox>(toPosition(record.position), record.scale, std::move(vertices));
+					break;
+				}
+			}
+
+			if (record.rotation != 0.0f) {
+				hitbox->rotate(record.rotation, { 0.0f, 0.0f, 1.0f });
+			}
+			return *hitbox;
+		}
+
+
+		template<typename T>
+		static T* checkRole(T* role, const char* name) {
+			if (role == nullptr) {
+				throw std::runtime_error{ std::string{ "The table has no " } + name };
+			}
+			return role;
+		}
+
+
+		PhysicsArena ownArena; //unused if the table is built in an external arena
+		PhysicsArena& arena;
+
+		std::vector<Hitbox*> hitboxes;
+		std::vector<std::string> hitboxNames;
+		std::vector<TableFormat::CollisionAction> actions;
+
+		std::vector<Field*> fields;
+		std::vector<TableFormat::FieldType> fieldTypes;
+
+		std::vector<std::unique_ptr<Universe>> universes;
+		std::vector<std::string> universeNames;
+
+		std::vector<ModelDescription> models;
+		std::vector<TableFormat::LightRecord> lights;
+
+		Universe* gameUniverse;
+		Hitbox* leftPad;
+		Hitbox* rightPad;
+		Hitbox* puller;
+		Position pullerRestingPosition;
+		std::vector<Hitbox*> balls;
+		std::vector<Hitbox*> bumpers;
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef VULKAN_TABLECONTROLS
+#define VULKAN_TABLECONTROLS
+
+#include <glm/glm.hpp>
+
+#include "AnglesLiterals.h"
+#include "Hitbox.h"
+
+const float FLIPPER_ANGULAR_SPEED = 15.0f;
+const float FLIPPER_MAX_ANGLE = 40.0_deg;
+const float FLIPPER_MIN_ANGLE = -15.0_deg;
+const float PULLER_MIN_Y = -6.700;
+constexpr float PULLER_PULLUP_FORCE = 5000.0f;
+
+
+/**
+ * @brief The controls of the table (pads and puller) expressed on the hitboxes only.
+ * @details These functions don't know anything about models, windows or keys, so that both the game and the headless simulation can drive the table in the same way.
+ */
+namespace Vulkan::Animations {
+
+	//The segment along the pad: the core of a capsule, or the first segment of a frame.
+	inline Vulkan::Physics::Segment padSegment(const Vulkan::Physics::Hitbox& pad) {
+		if (auto capsule = dynamic_cast<const Vulkan::Physics::CapsuleHitbox*>(&pad)) {
+			return capsule->getSegment();
+		}
+		return static_cast<const Vulkan::Physics::FrameHitbox&>(pad)[0];
+	}
+
+
+	//These 2 functions are used to check whether the pad is in his "working area" without using the angles. This is because it is hard to obtain the angles from the quaternion.
+	inline bool checkRightPadArea(const Vulkan::Physics::Hitbox& rightFlipper, float slackMax = 0.0f, float slackMin = 0.0f) {
+		const auto& segment = padSegment(rightFlipper); //the segment of the hitbox of the pad
+		const auto& extreme = segment.getDirection(); //the extreme point of the segment if its origin was on (0; 0)
+		const auto maxX = glm::cos(180.0_deg - FLIPPER_MAX_ANGLE) * segment.length(); //the maximum x coordinate of the extreme of the segment if it goes "over" this value it goes out of the "working area".
+		const auto minX = glm::cos(-180.0_deg - FLIPPER_MIN_ANGLE) * segment.length(); //the minumum x coordinate of the extreme of the segment if it goes "under" this value it goes out of the "working area".
+
+		//check the extremes (instead of the angle)
+		return (extreme.x() < maxX + slackMax && extreme.y() > 0.0f) || (extreme.x() < minX + slackMin && extreme.y() <= 0.0f);
+	}
+
+	inline bool checkLeftPadArea(const Vulkan::Physics::Hitbox& leftFlipper, float slackMax = 0.0f, float slackMin = 0.0f) {
+		//look at previous function for explaination
+		const auto& segment = padSegment(leftFlipper);
+		const auto& extreme = segment.getDirection();
+		const auto maxX = glm::cos(FLIPPER_MAX_ANGLE) * segment.length();
+		const auto minX = glm::cos(FLIPPER_MIN_ANGLE) * segment.length();
+
+		return (extreme.x() > maxX - slackMax && extreme.y() > 0.0f) || (extreme.x() > minX - slackMin && extreme.y() <= 0.0f);
+	}
+
+
+
+	/**
+	 * @brief Brings the pads back to their resting position. It must be called at every physics step, before the pads are raised by the player.
+	 */
+	inline void lowerPads(Vulkan::Physics::Hitbox& leftFlipper, Vulkan::Physics::Hitbox& rightFlipper, float angularSpeed = FLIPPER_ANGULAR_SPEED) {
+		rightFlipper.setAngularSpeed(0.0f);
+		if (checkRightPadArea(rightFlipper, 0.1f)) {
+			rightFlipper.setAngularSpeed(angularSpeed);
+		}
+
+		leftFlipper.setAngularSpeed(0.0f);
+		if (checkLeftPadArea(leftFlipper, 0.1f)) {
+			leftFlipper.setAngularSpeed(-angularSpeed);
+		}
+	}
+
+
+	/**
+	 * @brief Raises the right pad, as long as it is inside its working area.
+	 */
+	inline void raiseRightPad(Vulkan::Physics::Hitbox& rightFlipper, float angularSpeed = FLIPPER_ANGULAR_SPEED) {
+		if (checkRightPadArea(rightFlipper, 0.0f, 0.1f)) {
+			rightFlipper.setAngularSpeed(-angularSpeed);
+		}
+		else {
+			rightFlipper.setAngularSpeed(0.0f);
+		}
+	}
+
+
+	/**
+	 * @brief Raises the left pad, as long as it is inside its working area.
+	 */
+	inline void raiseLeftPad(Vulkan::Physics::Hitbox& leftFlipper, float angularSpeed = FLIPPER_ANGULAR_SPEED) {
+		if (checkLeftPadArea(leftFlipper, 0.0f, 0.1f)) {
+			leftFlipper.setAngularSpeed(angularSpeed);
+		}
+		else {
+			leftFlipper.setAngularSpeed(0.0f);
+		}
+	}
+
+
+	/**
+	 * @brief Pulls the puller down, until it reaches PULLER_MIN_Y. Once released, the puller field brings it back up.
+	 *
+	 * @param restingPosition The position of the puller when it is not pulled, which gives the x and z coordinates of the puller at PULLER_MIN_Y.
+	 */
+	inline void pullPuller(Vulkan::Physics::Hitbox& puller, const Vulkan::Physics::Position& restingPosition) {
+		if (puller.getPosition().y() > PULLER_MIN_Y) {
+			puller.addExternalForce(Vulkan::Physics::Force{ 0.0f, -PULLER_PULLUP_FORCE - 0.000001f, 0.0f });
+		}
+		else {
+			puller.reset(Vulkan::Physics::Position{ restingPosition.x(), PULLER_MIN_Y, restingPosition.z() });
+			puller.addExternalForce(Vulkan::Physics::Force{ 0.0f, -PULLER_PULLUP_FORCE, 0.0f });
+		}
+	}
+
+}
+
+
+#endif
@@ -0,0 +1,260 @@
+#include "TableFile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+Vulkan::Physics::TableFile::TableFile(const std::string& path) : path{ path }, data{ nullptr }, size{ 0 }, fileHandle{ nullptr }, mappingHandle{ nullptr }, header{ nullptr } {
+	map();
+	try {
+		validate();
+	}
+	catch (...) {
+		unmap();
+		throw;
+	}
+}
+
+
+Vulkan::Physics::TableFile::~TableFile() {
+	unmap();
+}
+
+
+
+#ifdef _WIN32
+
+void Vulkan::Physics::TableFile::map() {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error{ "Failed to open table file " + path };
+	}
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize)) {
+		unmap();
+		throw std::runtime_error{ "Failed to read the size of table file " + path };
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+	if (size == 0) {
+		unmap();
+		throw std::runtime_error{ "Table file " + path + " is empty" };
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		unmap();
+		throw std::runtime_error{ "Failed to map table file " + path };
+	}
+	mappingHandle = mapping;
+
+	data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (data == nullptr) {
+		unmap();
+		throw std::runtime_error{ "Failed to map table file " + path };
+	}
+}
+
+
+void Vulkan::Physics::TableFile::unmap() {
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+		data = nullptr;
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+	if (fileHandle != nullptr) {
+		CloseHandle(fileHandle);
+		fileHandle = nullptr;
+	}
+}
+
+#else
+
+void Vulkan::Physics::TableFile::map() {
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		throw std::runtime_error{ "Failed to open table file " + path };
+	}
+
+	struct stat fileInfo {};
+	if (fstat(file, &fileInfo) != 0) {
+		close(file);
+		throw std::runtime_error{ "Failed to read the size of table file " + path };
+	}
+	size = static_cast<size_t>(fileInfo.st_size);
+	if (size == 0) {
+		close(file);
+		throw std::runtime_error{ "Table file " + path + " is empty" };
+	}
+
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file); //the mapping keeps the file alive
+	if (mapped == MAP_FAILED) {
+		throw std::runtime_error{ "Failed to map table file " + path };
+	}
+	data = static_cast<const std::byte*>(mapped);
+}
+
+
+void Vulkan::Physics::TableFile::unmap() {
+	if (data != nullptr) {
+		munmap(const_cast<std::byte*>(data), size);
+		data = nullptr;
+	}
+}
+
+#endif
+
+
+
+template<typename T>
+std::span<const T> Vulkan::Physics::TableFile::section(const TableFormat::Section& section) const {
+	if (section.offset % alignof(T) != 0 || section.offset > size || (size - section.offset) / sizeof(T) < section.count) {
+		throw std::runtime_error{ "Table file " + path + " is corrupted: a section is outside the file" };
+	}
+	return std::span<const T>{ reinterpret_cast<const T*>(data + section.offset), section.count };
+}
+
+
+void Vulkan::Physics::TableFile::checkRange(TableFormat::Range range, size_t size, const char* what) const {
+	if (range.first > size || size - range.first < range.count) {
+		throw std::runtime_error{ "Table file " + path + " is corrupted: " + what + " out of bounds" };
+	}
+}
+
+
+void Vulkan::Physics::TableFile::checkIndex(uint32_t index, size_t size, const char* what) const {
+	if (index >= size) {
+		throw std::runtime_error{ "Table file " + path + " is corrupted: " + what + " out of bounds" };
+	}
+}
+
+
+void Vulkan::Physics::TableFile::checkString(uint32_t offset) const {
+	checkIndex(offset, strings.size(), "string");
+}
+
+
+void Vulkan::Physics::TableFile::validate() {
+	if (size < sizeof(TableFormat::Header)) {
+		throw std::runtime_error{ "Table file " + path + " is too small" };
+	}
+
+	//pointer fixups: from now on sections are accessed through these spans
+	header = reinterpret_cast<const TableFormat::Header*>(data);
+	if (std::memcmp(header->magic, TableFormat::MAGIC, sizeof(TableFormat::MAGIC)) != 0) {
+		throw std::runtime_error{ path + " is not a table file" };
+	}
+	if (header->version != TableFormat::VERSION) {
+		throw std::runtime_error{ "Table file " + path + " has version " + std::to_string(header->version) + ", expected " + std::to_string(TableFormat::VERSION) + ". Compile it again with TableCompiler" };
+	}
+	if (header->fileSize != size) {
+		throw std::runtime_error{ "Table file " + path + " is truncated" };
+	}
+
+	hitboxes = section<TableFormat::HitboxRecord>(header->hitboxes);
+	vertices = section<TableFormat::Vec3>(header->vertices);
+	fields = section<TableFormat::FieldRecord>(header->fields);
+	models = section<TableFormat::ModelRecord>(header->models);
+	universes = section<TableFormat::UniverseRecord>(header->universes);
+	indices = section<uint32_t>(header->indices);
+	lights = section<TableFormat::LightRecord>(header->lights);
+	strings = section<char>(header->strings);
+
+	if (strings.empty() || strings.back() != '\0') {
+		throw std::runtime_error{ "Table file " + path + " is corrupted: strings are not terminated" };
+	}
+
+	//every reference must point inside the file, so that the loader doesn't need to check anything
+	for (const auto& hitbox : hitboxes) {
+		checkString(hitbox.name);
+		if (hitbox.type == TableFormat::HitboxType::FRAME) {
+			checkRange(hitbox.vertices, vertices.size(), "hitbox vertices");
+			if (hitbox.vertices.count < 2) {
+				throw std::runtime_error{ "Table file " + path + " is corrupted: a frame has less than 2 vertices" };
+			}
+		}
+		else if (hitbox.type == TableFormat::HitboxType::CAPSULE) {
+			checkRange(hitbox.vertices, vertices.size(), "hitbox vertices");
+			if (hitbox.vertices.count != 2) {
+				throw std::runtime_error{ "Table file " + path + " is corrupted: a capsule doesn't have 2 vertices" };
+			}
+		}
+		else if (hitbox.type == TableFormat::HitboxType::POLYGON) {
+			checkRange(hitbox.vertices, vertices.size(), "hitbox vertices");
+			if (hitbox.vertices.count < 3) {
+				throw std::runtime_error{ "Table file " + path + " is corrupted: a polygon has less than 3 vertices" };
+			}
+			if (!TableFormat::isConvex(getVertices(hitbox.vertices))) {
+				throw std::runtime_error{ "Table file " + path + " is corrupted: a polygon is not convex" };
+			}
+		}
+		else if (hitbox.type != TableFormat::HitboxType::CIRCLE) {
+			throw std::runtime_error{ "Table file " + path + " is corrupted: unknown hitbox type" };
+		}
+		if (hitbox.action > TableFormat::CollisionAction::START_GAME) {
+			throw std::runtime_error{ "Table file " + path + " is corrupted: unknown collision action" };
+		}
+	}
+
+	for (const auto& field : fields) {
+		checkString(field.name);
+		if (field.type > TableFormat::FieldType::CENTRAL) {
+			throw std::runtime_error{ "Table file " + path + " is corrupted: unknown field type" };
+		}
+	}
+
+	for (const auto& model : models) {
+		checkIndex(model.hitbox, hitboxes.size(), "model hitbox");
+		checkString(model.path);
+	}
+
+	for (const auto& universe : universes) {
+		checkString(universe.name);
+		checkRange(universe.fields, indices.size(), "universe fields");
+		checkRange(universe.bodies, indices.size(), "universe bodies");
+		for (auto field : getIndices(universe.fields)) {
+			checkIndex(field, fields.size(), "universe field");
+		}
+		for (auto body : getIndices(universe.bodies)) {
+			checkIndex(body, hitboxes.size(), "universe body");
+		}
+	}
+
+	for (const auto& light : lights) {
+		checkIndex(light.hitbox, hitboxes.size(), "light hitbox");
+		checkIndex(light.slot, TableFormat::POINT_LIGHTS, "light slot");
+	}
+
+	for (auto role : { header->leftPad, header->rightPad, header->puller }) {
+		if (role != TableFormat::NONE) {
+			checkIndex(role, hitboxes.size(), "game role");
+		}
+	}
+	if (header->gameUniverse != TableFormat::NONE) {
+		checkIndex(header->gameUniverse, universes.size(), "game universe");
+	}
+	checkRange(header->balls, indices.size(), "balls");
+	checkRange(header->bumpers, indices.size(), "bumpers");
+	for (auto ball : getIndices(header->balls)) {
+		checkIndex(ball, hitboxes.size(), "ball");
+	}
+	for (auto bumper : getIndices(header->bumpers)) {
+		checkIndex(bumper, hitboxes.size(), "bumper");
+	}
+}
@@ -0,0 +1,108 @@
+#ifndef VULKAN_TABLEFILE
+#define VULKAN_TABLEFILE
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "TableFormat.h"
+
+
+namespace Vulkan::Physics {
+
+	/**
+	 * @brief A binary table file mapped in memory.
+	 * @details The constructor maps the file, checks that every section and every index is inside the file, and then computes the pointer to each section. After that the records are read straight from the mapped memory.
+	 *			A TableFile is read only, so the same instance can be used at the same time by many threads.
+	 */
+	class TableFile {
+	public:
+
+		/**
+		 * @brief Maps and validates a table file. Throws std::runtime_error if the file cannot be mapped or it is not a valid table.
+		 */
+		TableFile(const std::string& path);
+
+		~TableFile();
+
+		TableFile(const TableFile&) = delete;
+		TableFile& operator=(const TableFile&) = delete;
+
+
+		const TableFormat::Header& getHeader() const {
+			return *header;
+		}
+
+		std::span<const TableFormat::HitboxRecord> getHitboxes() const {
+			return hitboxes;
+		}
+
+		std::span<const TableFormat::Vec3> getVertices(TableFormat::Range range) const {
+			return vertices.subspan(range.first, range.count);
+		}
+
+		std::span<const TableFormat::FieldRecord> getFields() const {
+			return fields;
+		}
+
+		std::span<const TableFormat::ModelRecord> getModels() const {
+			return models;
+		}
+
+		std::span<const TableFormat::UniverseRecord> getUniverses() const {
+			return universes;
+		}
+
+		std::span<const uint32_t> getIndices(TableFormat::Range range) const {
+			return indices.subspan(range.first, range.count);
+		}
+
+		std::span<const TableFormat::LightRecord> getLights() const {
+			return lights;
+		}
+
+		std::string_view getString(uint32_t offset) const {
+			return std::string_view{ strings.data() + offset };
+		}
+
+		const std::string& getPath() const {
+			return path;
+		}
+
+
+	private:
+
+		void map();
+		void unmap();
+		void validate();
+
+		template<typename T>
+		std::span<const T> section(const TableFormat::Section& section) const;
+
+		void checkRange(TableFormat::Range range, size_t size, const char* what) const;
+		void checkIndex(uint32_t index, size_t size, const char* what) const;
+		void checkString(uint32_t offset) const;
+
+
+		std::string path;
+		const std::byte* data;
+		size_t size;
+		void* fileHandle; //platform handles, see TableFile.cpp
+		void* mappingHandle;
+
+		const TableFormat::Header* header;
+		std::span<const TableFormat::HitboxRecord> hitboxes;
+		std::span<const TableFormat::Vec3> vertices;
+		std::span<const TableFormat::FieldRecord> fields;
+		std::span<const TableFormat::ModelRecord> models;
+		std::span<const TableFormat::UniverseRecord> universes;
+		std::span<const uint32_t> indices;
+		std::span<const TableFormat::LightRecord> lights;
+		std::span<const char> strings;
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef VULKAN_TABLEFORMAT
+#define VULKAN_TABLEFORMAT
+
+#include <cstdint>
+#include <bit>
+#include <span>
+#include <type_traits>
+
+
+/**
+ * @brief Layout of the binary table files (.tbl), which describe the physical objects of a table, its models, lights and game roles.
+ * @details A table file is a Header followed by sections of fixed size records. Every section is addressed by its byte offset from the beginning of the file, so that the file can be mapped in memory and used as is.
+ *			Records reference each other by index (e.g. the bodies of a universe are indices of hitboxes) and reference strings by their byte offset in the strings section.
+ *			All the values are little endian and every section is 4 bytes aligned.
+ *			Readable tables (.table) are compiled into this format by the TableCompiler tool.
+ */
+namespace Vulkan::Physics::TableFormat {
+
+	static_assert(std::endian::native == std::endian::little, "Table files are little endian");
+
+	constexpr char MAGIC[4] = { 'P', 'T', 'B', 'L' };
+	constexpr uint32_t VERSION = 2; //2: capsule and polygon hitboxes
+	constexpr uint32_t NONE = 0xFFFFFFFF; //an index which doesn't point to anything
+	constexpr uint32_t POINT_LIGHTS = 9; //the slots of the point lights which follow hitboxes (position0 to position8 of the Lights struct)
+
+
+	enum class HitboxType : uint32_t {
+		CIRCLE = 0,
+		FRAME = 1,
+		CAPSULE = 2,
+		POLYGON = 3 //convex
+	};
+
+
+	enum class FieldType : uint32_t {
+		GRAVITY = 0,
+		FRICTION = 1,
+		CENTRAL = 2
+	};
+
+
+	/**
+	 * @brief What happens to the game when a hitbox collides with something.
+	 */
+	enum class CollisionAction : uint32_t {
+		NONE = 0,
+		INVERT_BUMPER = 1, //the hitbox is a bumper which switches on or off
+		KILL_BALL = 2, //the colliding ball is out of the game
+		START_GAME = 3 //the puller launched the ball
+	};
+
+
+	struct Vec3 {
+		float x, y, z;
+	};
+
+
+	/**
+	 * @brief Position of an array of records in the file.
+	 */
+	struct Section {
+		uint32_t offset; //in bytes, from the beginning of the file
+		uint32_t count; //number of records
+	};
+
+
+	/**
+	 * @brief A contiguous range of records inside a section.
+	 */
+	struct Range {
+		uint32_t first;
+		uint32_t count;
+	};
+
+
+	struct HitboxRecord {
+		uint32_t name;
+		HitboxType type;
+		Vec3 position;
+		float scale;
+		float mass; //0 for static objects
+		float radius; //only for circles and capsules
+		float rotation; //radians around the z axis
+		Range vertices; //only for frames, capsules (the 2 ends of the segment) and polygons, in the vertices section
+		CollisionAction action;
+	};
+
+
+	struct FieldRecord {
+		uint32_t name;
+		FieldType type;
+		Vec3 position;
+		float intensity; //meaning depends on the type: g for gravity, mu for friction, force for central fields
+	};
+
+
+	struct ModelRecord {
+		uint32_t hitbox;
+		uint32_t path; //path of the OBJ file
+		Vec3 rotation; //radians, rotation of the model relative to its hitbox
+	};
+
+
+	struct UniverseRecord {
+		uint32_t name;
+		Range fields; //in the indices section, indices of fields
+		Range bodies; //in the indices section, indices of hitboxes
+	};
+
+
+	/**
+	 * @brief A point light which follows a hitbox.
+	 */
+	struct LightRecord {
+		uint32_t hitbox;
+		uint32_t slot; //index of the point light in the Lights struct, less than POINT_LIGHTS
+		float height; //z coordinate of the light
+	};
+
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t fileSize;
+		uint32_t reserved;
+
+		Section hitboxes; //HitboxRecord
+		Section vertices; //Vec3
+		Section fields; //FieldRecord
+		Section models; //ModelRecord
+		Section universes; //UniverseRecord
+		Section indices; //uint32_t
+		Section lights; //LightRecord
+		Section strings; //char, NUL terminated strings
+
+		//game roles
+		uint32_t gameUniverse; //the universe balls are added to
+		uint32_t leftPad;
+		uint32_t rightPad;
+		uint32_t puller;
+		Range balls; //in the indices section
+		Range bumpers; //in the indices section
+	};
+
+
+	//whether the vertices of a polygon describe a convex polygon: the turns between consecutive edges all go the same way (clockwise or counterclockwise), and no edge is degenerate
+	inline bool isConvex(std::span<const Vec3> vertices) {
+		int turns = 0;
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			const Vec3& a = vertices[i];
+			const Vec3& b = vertices[(i + 1) % vertices.size()];
+			const Vec3& c = vertices[(i + 2) % vertices.size()];
+			if (a.x == b.x && a.y == b.y) {
+				return false;
+			}
+			float cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+			int turn = (cross > 0.0f) - (cross < 0.0f);
+			if (turn != 0) {
+				if (turns != 0 && turn != turns) {
+					return false;
+				}
+				turns = turn;
+			}
+		}
+		return turns != 0;
+	}
+
+
+	static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) % 4 == 0);
+	static_assert(std::is_trivially_copyable_v<HitboxRecord> && sizeof(HitboxRecord) % 4 == 0);
+	static_assert(std::is_trivially_copyable_v<FieldRecord> && sizeof(FieldRecord) % 4 == 0);
+	static_assert(std::is_trivially_copyable_v<ModelRecord> && sizeof(ModelRecord) % 4 == 0);
+	static_assert(std::is_trivially_copyable_v<UniverseRecord> && sizeof(UniverseRecord) % 4 == 0);
+	static_assert(std::is_trivially_copyable_v<LightRecord> && sizeof(LightRecord) % 4 == 0);
+}
+
+
+#endif
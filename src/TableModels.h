@@ -0,0 +1,52 @@
+#ifndef VULKAN_TABLEMODELS
+#define VULKAN_TABLEMODELS
+
+#include <memory>
+#include <vector>
+
+#include "Model.h"
+#include "Table.h"
+#include "JobSystem.h"
+
+
+namespace Vulkan::Objects {
+
+	/**
+	 * @brief Loads the models described by a table. Each model follows its hitbox (owned by the table), so it moves with the physics of the table.
+	 * @details Models are returned in the same order they have in the table file, which is also the order their vertices and uniforms are stored in the buffers.
+	 *			The table must outlive the models.
+	 *
+	 * @param table The table the hitboxes are taken from.
+	 * @param ...uniforms Additional uniforms of each model.
+	 */
+	template<IsVertex V, typename... S>
+	std::vector<std::unique_ptr<Model<V, S...>>> loadTableModels(const Physics::Table& table, S... uniforms) {
+		std::vector<std::unique_ptr<Model<V, S...>>> models;
+		for (const auto& description : table.getModels()) {
+			models.push_back(std::make_unique<Model<V, S...>>(table.getHitbox(description.hitbox), description.rotation, V{}, description.path, uniforms...));
+		}
+		return models;
+	}
+
+
+	/**
+	 * @brief Loads the models described by a table, reading the model files in parallel. See loadTableModels.
+	 *
+	 * @param table The table the hitboxes are taken from.
+	 * @param jobs The job system the models are loaded with.
+	 * @param ...uniforms Additional uniforms of each model.
+	 */
+	template<IsVertex V, typename... S>
+	std::vector<std::unique_ptr<Model<V, S...>>> loadTableModels(const Physics::Table& table, Utilities::JobSystem& jobs, S... uniforms) {
+		const auto& descriptions = table.getModels();
+		std::vector<std::unique_ptr<Model<V, S...>>> models(descriptions.size());
+		jobs.parallelFor(0, descriptions.size(), 1, [&table, &descriptions, &models, &uniforms...](size_t i) {
+			models[i] = std::make_unique<Model<V, S...>>(table.getHitbox(descriptions[i].hitbox), descriptions[i].rotation, V{}, descriptions[i].path, uniforms...);
+			}, "loadTableModels");
+		return models;
+	}
+
+}
+
+
+#endif
@@ -0,0 +1,439 @@
+#ifndef VULKAN_TEXTURECOMPRESSION
+#define VULKAN_TEXTURECOMPRESSION
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "TextureFormat.h"
+
+
+/**
+ * @brief Builds the mip chain of an RGBA8 image and encodes its levels as the GPU samples them (see TextureFormat::Encoding).
+ * @details The mip levels are box filtered in linear space, since the texels are sRGB. The encoders fit a line through the colors of each 4x4 block (its principal axis), take the endpoints from the extremes of the block along it, and then refine them by least squares on the chosen indices.
+ *			BC7 blocks are all encoded in mode 6 (a single line in RGBA, 7 bits per channel plus a p-bit per endpoint, 16 indices), which is the fastest mode to search and handles alpha and smooth gradients well.
+ */
+namespace Vulkan::TextureCompression {
+
+	using TextureFormat::Encoding;
+
+
+	namespace Details {
+
+		inline const std::array<float, 256>& getSrgbToLinear() {
+			static const auto table = [] {
+				std::array<float, 256> res;
+				for (int i = 0; i < 256; ++i) {
+					const float c = i / 255.0f;
+					res[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+				return res;
+			}();
+			return table;
+		}
+
+
+		inline const std::array<uint8_t, 4096>& getLinearToSrgb() {
+			static const auto table = [] {
+				std::array<uint8_t, 4096> res;
+				for (int i = 0; i < 4096; ++i) {
+					const float c = i / 4095.0f;
+					const float srgb = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+					res[i] = static_cast<uint8_t>(std::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+				}
+				return res;
+			}();
+			return table;
+		}
+
+
+		//the 16 texels of a 4x4 block, as RGBA; the texels outside the image (in the last row or column of blocks of a small level) repeat the ones at its border
+		struct Block {
+			float texels[16][4];
+		};
+
+
+		inline Block loadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY) {
+			Block block;
+			for (uint32_t i = 0; i < 16; ++i) {
+				const uint32_t x = std::min(blockX * 4 + i % 4, width - 1), y = std::min(blockY * 4 + i / 4, height - 1);
+				for (int c = 0; c < 4; ++c) {
+					block.texels[i][c] = rgba[(size_t{ y } * width + x) * 4 + c];
+				}
+			}
+			return block;
+		}
+
+
+		//the extremes of the block along its principal axis, in the first channels
+		inline void fitLine(const Block& block, int channels, float endpoints[2][4]) {
+			float mean[4]{};
+			for (const auto& texel : block.texels) {
+				for (int c = 0; c < channels; ++c) {
+					mean[c] += texel[c] / 16.0f;
+				}
+			}
+
+			float covariance[4][4]{};
+			for (const auto& texel : block.texels) {
+				for (int i = 0; i < channels; ++i) {
+					for (int j = 0; j < channels; ++j) {
+						covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+					}
+				}
+			}
+
+			//power iteration, starting from the diagonal of the bounding box
+			float axis[4]{};
+			for (int c = 0; c < channels; ++c) {
+				float low = 255.0f, high = 0.0f;
+				for (const auto& texel : block.texels) {
+					low = std::min(low, texel[c]);
+					high = std::max(high, texel[c]);
+				}
+				axis[c] = high - low;
+			}
+			for (int iteration = 0; iteration < 8; ++iteration) {
+				float next[4]{}, length = 0.0f;
+				for (int i = 0; i < channels; ++i) {
+					for (int j = 0; j < channels; ++j) {
+						next[i] += covariance[i][j] * axis[j];
+					}
+					length = std::max(length, std::abs(next[i]));
+				}
+				if (length == 0.0f) {
+					break; //a flat block, or the axis is already an eigenvector of eigenvalue 0
+				}
+				for (int c = 0; c < channels; ++c) {
+					axis[c] = next[c] / length;
+				}
+			}
+
+			float squaredLength = 0.0f;
+			for (int c = 0; c < channels; ++c) {
+				squaredLength += axis[c] * axis[c];
+			}
+			float low = 0.0f, high = 0.0f;
+			if (squaredLength > 0.0f) {
+				low = 1e30f, high = -1e30f;
+				for (const auto& texel : block.texels) {
+					float t = 0.0f;
+					for (int c = 0; c < channels; ++c) {
+						t += (texel[c] - mean[c]) * axis[c];
+					}
+					low = std::min(low, t / squaredLength);
+					high = std::max(high, t / squaredLength);
+				}
+			}
+			for (int c = 0; c < channels; ++c) {
+				endpoints[0][c] = std::clamp(mean[c] + axis[c] * low, 0.0f, 255.0f);
+				endpoints[1][c] = std::clamp(mean[c] + axis[c] * high, 0.0f, 255.0f);
+			}
+		}
+
+
+		//chooses the closest color of the palette for each texel, and returns the total squared error
+		inline float assignIndices(const Block& block, int channels, const int palette[][4], int paletteSize, uint8_t indices[16]) {
+			float error = 0.0f;
+			for (int i = 0; i < 16; ++i) {
+				float best = 1e30f;
+				for (int p = 0; p < paletteSize; ++p) {
+					float distance = 0.0f;
+					for (int c = 0; c < channels; ++c) {
+						const float d = block.texels[i][c] - palette[p][c];
+						distance += d * d;
+					}
+					if (distance < best) {
+						best = distance;
+						indices[i] = static_cast<uint8_t>(p);
+					}
+				}
+				error += best;
+			}
+			return error;
+		}
+
+
+		//the endpoints which minimize the squared error when each texel is interpolated with the weight of its index (0 is the first endpoint, 1 the second one); false if they are not determined (e.g. all the texels have the same weight)
+		inline bool refitEndpoints(const Block& block, int channels, const uint8_t indices[16], const float weights[], float endpoints[2][4]) {
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[4]{}, bx[4]{};
+			for (int i = 0; i < 16; ++i) {
+				const float w = weights[indices[i]];
+				aa += (1.0f - w) * (1.0f - w);
+				ab += (1.0f - w) * w;
+				bb += w * w;
+				for (int c = 0; c < channels; ++c) {
+					ax[c] += (1.0f - w) * block.texels[i][c];
+					bx[c] += w * block.texels[i][c];
+				}
+			}
+
+			const float determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f) {
+				return false;
+			}
+			for (int c = 0; c < channels; ++c) {
+				endpoints[0][c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+				endpoints[1][c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+			}
+			return true;
+		}
+
+
+		inline uint16_t toRgb565(const float color[4]) {
+			const auto r = static_cast<uint16_t>(color[0] * 31.0f / 255.0f + 0.5f);
+			const auto g = static_cast<uint16_t>(color[1] * 63.0f / 255.0f + 0.5f);
+			const auto b = static_cast<uint16_t>(color[2] * 31.0f / 255.0f + 0.5f);
+			return static_cast<uint16_t>(r << 11 | g << 5 | b);
+		}
+
+
+		inline void fromRgb565(uint16_t color, int result[4]) {
+			const int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+			result[0] = r << 3 | r >> 2;
+			result[1] = g << 2 | g >> 4;
+			result[2] = b << 3 | b >> 2;
+			result[3] = 255;
+		}
+
+
+		//BC1 in 4 colors mode: the first endpoint is the larger one
+		inline void encodeBC1Block(const Block& block, std::byte* destination) {
+			static constexpr float WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+			float endpoints[2][4];
+			fitLine(block, 3, endpoints);
+
+			uint64_t best = 0;
+			float bestError = 1e30f;
+			for (int attempt = 0; attempt < 3; ++attempt) {
+				uint16_t color0 = toRgb565(endpoints[0]), color1 = toRgb565(endpoints[1]);
+				if (color0 < color1) {
+					std::swap(color0, color1);
+				}
+
+				uint8_t indices[16]{};
+				float error;
+				if (color0 == color1) {
+					//a single color: the 3 colors mode, where index 0 is the first endpoint
+					int palette[1][4];
+					fromRgb565(color0, palette[0]);
+					error = assignIndices(block, 3, palette, 1, indices);
+				}
+				else {
+					int palette[4][4];
+					fromRgb565(color0, palette[0]);
+					fromRgb565(color1, palette[1]);
+					for (int c = 0; c < 3; ++c) {
+						palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+						palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+					}
+					error = assignIndices(block, 3, palette, 4, indices);
+				}
+
+				if (error < bestError) {
+					bestError = error;
+					best = uint64_t{ color0 } | uint64_t{ color1 } << 16;
+					for (int i = 0; i < 16; ++i) {
+						best |= uint64_t{ indices[i] } << (32 + 2 * i);
+					}
+				}
+				if (color0 == color1 || !refitEndpoints(block, 3, indices, WEIGHTS, endpoints)) {
+					break;
+				}
+			}
+			std::memcpy(destination, &best, sizeof(best));
+		}
+
+
+		//the 7 bits of each channel of an endpoint of a BC7 mode 6 block, and the p-bit, which is the lowest bit of all its channels
+		struct Bc7Endpoint {
+			uint8_t channels[4];
+			uint8_t pBit;
+
+			int get(int c) const {
+				return channels[c] << 1 | pBit;
+			}
+		};
+
+
+		inline Bc7Endpoint quantizeBc7Endpoint(const float color[4]) {
+			Bc7Endpoint best{};
+			float bestError = 1e30f;
+			for (uint8_t pBit = 0; pBit < 2; ++pBit) {
+				Bc7Endpoint endpoint{ {}, pBit };
+				float error = 0.0f;
+				for (int c = 0; c < 4; ++c) {
+					endpoint.channels[c] = static_cast<uint8_t>(std::clamp(static_cast<int>(std::lround((color[c] - pBit) / 2.0f)), 0, 127));
+					const float d = color[c] - endpoint.get(c);
+					error += d * d;
+				}
+				if (error < bestError) {
+					bestError = error;
+					best = endpoint;
+				}
+			}
+			return best;
+		}
+
+
+		//writes the bits of a block from the lowest one
+		struct BitWriter {
+			uint8_t bytes[16]{};
+			unsigned int position = 0;
+
+			void write(uint32_t value, unsigned int bits) {
+				for (unsigned int i = 0; i < bits; ++i, ++position) {
+					bytes[position / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (position % 8));
+				}
+			}
+		};
+
+
+		inline void encodeBC7Block(const Block& block, std::byte* destination) {
+			static constexpr int WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+			static constexpr float NORMALIZED_WEIGHTS[16] = { 0 / 64.0f, 4 / 64.0f, 9 / 64.0f, 13 / 64.0f, 17 / 64.0f, 21 / 64.0f, 26 / 64.0f, 30 / 64.0f, 34 / 64.0f, 38 / 64.0f, 43 / 64.0f, 47 / 64.0f, 51 / 64.0f, 55 / 64.0f, 60 / 64.0f, 64 / 64.0f };
+			float endpoints[2][4];
+			fitLine(block, 4, endpoints);
+
+			Bc7Endpoint best[2]{};
+			uint8_t bestIndices[16]{};
+			float bestError = 1e30f;
+			for (int attempt = 0; attempt < 3; ++attempt) {
+				const Bc7Endpoint quantized[2] = { quantizeBc7Endpoint(endpoints[0]), quantizeBc7Endpoint(endpoints[1]) };
+				int palette[16][4];
+				for (int p = 0; p < 16; ++p) {
+					for (int c = 0; c < 4; ++c) {
+						palette[p][c] = ((64 - WEIGHTS[p]) * quantized[0].get(c) + WEIGHTS[p] * quantized[1].get(c) + 32) >> 6;
+					}
+				}
+
+				uint8_t indices[16];
+				const float error = assignIndices(block, 4, palette, 16, indices);
+				if (error < bestError) {
+					bestError = error;
+					std::copy(std::begin(quantized), std::end(quantized), best);
+					std::copy(std::begin(indices), std::end(indices), bestIndices);
+				}
+				if (error == 0.0f || !refitEndpoints(block, 4, indices, NORMALIZED_WEIGHTS, endpoints)) {
+					break;
+				}
+			}
+
+			//the highest bit of the index of the first texel isn't stored, so it must be 0
+			if (bestIndices[0] & 8) {
+				std::swap(best[0], best[1]);
+				for (auto& index : bestIndices) {
+					index = static_cast<uint8_t>(15 - index);
+				}
+			}
+
+			BitWriter bits;
+			bits.write(1 << 6, 7); //mode 6
+			for (int c = 0; c < 4; ++c) {
+				bits.write(best[0].channels[c], 7);
+				bits.write(best[1].channels[c], 7);
+			}
+			bits.write(best[0].pBit, 1);
+			bits.write(best[1].pBit, 1);
+			bits.write(bestIndices[0], 3);
+			for (int i = 1; i < 16; ++i) {
+				bits.write(bestIndices[i], 4);
+			}
+			std::memcpy(destination, bits.bytes, sizeof(bits.bytes));
+		}
+	}
+
+
+
+	/**
+	 * @brief Returns the next level of the mip chain of an RGBA8 sRGB image: half its size (at least 1), each texel the average of 2x2 texels.
+	 */
+	inline std::vector<uint8_t> downsample(const uint8_t* rgba, uint32_t width, uint32_t height) {
+		const auto& toLinear = Details::getSrgbToLinear();
+		const auto& toSrgb = Details::getLinearToSrgb();
+		const uint32_t nextWidth = std::max(width / 2, 1u), nextHeight = std::max(height / 2, 1u);
+
+		std::vector<uint8_t> res(size_t{ nextWidth } * nextHeight * 4);
+		for (uint32_t y = 0; y < nextHeight; ++y) {
+			const uint32_t rows[2] = { std::min(2 * y, height - 1), std::min(2 * y + 1, height - 1) };
+			for (uint32_t x = 0; x < nextWidth; ++x) {
+				const uint32_t columns[2] = { std::min(2 * x, width - 1), std::min(2 * x + 1, width - 1) };
+				float sum[4]{};
+				for (auto row : rows) {
+					for (auto column : columns) {
+						const uint8_t* texel = rgba + (size_t{ row } * width + column) * 4;
+						for (int c = 0; c < 3; ++c) {
+							sum[c] += toLinear[texel[c]];
+						}
+						sum[3] += texel[3];
+					}
+				}
+
+				uint8_t* texel = res.data() + (size_t{ y } * nextWidth + x) * 4;
+				for (int c = 0; c < 3; ++c) {
+					texel[c] = toSrgb[static_cast<size_t>(sum[c] / 4.0f * 4095.0f + 0.5f)];
+				}
+				texel[3] = static_cast<uint8_t>(sum[3] / 4.0f + 0.5f);
+			}
+		}
+		return res;
+	}
+
+
+	/**
+	 * @brief Encodes an RGBA8 sRGB image (a mip level) into destination, which holds TextureFormat::getLevelSize(encoding, width, height) bytes.
+	 */
+	inline void encode(Encoding encoding, const uint8_t* rgba, uint32_t width, uint32_t height, std::byte* destination) {
+		if (encoding == Encoding::RGBA8) {
+			std::memcpy(destination, rgba, size_t{ width } * height * 4);
+			return;
+		}
+
+		const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+		const uint32_t blockBytes = TextureFormat::getBlockBytes(encoding);
+		for (uint32_t y = 0; y < blocksY; ++y) {
+			for (uint32_t x = 0; x < blocksX; ++x) {
+				const auto block = Details::loadBlock(rgba, width, height, x, y);
+				std::byte* blockDestination = destination + (size_t{ y } * blocksX + x) * blockBytes;
+				if (encoding == Encoding::BC1) {
+					Details::encodeBC1Block(block, blockDestination);
+				}
+				else {
+					Details::encodeBC7Block(block, blockDestination);
+				}
+			}
+		}
+	}
+
+
+	/**
+	 * @brief Builds the whole mip chain of an RGBA8 sRGB image and encodes each level.
+	 *
+	 * @return The encoded levels, level 0 (the image itself) first.
+	 */
+	inline std::vector<std::vector<std::byte>> cook(const uint8_t* rgba, uint32_t width, uint32_t height, Encoding encoding) {
+		std::vector<std::vector<std::byte>> levels;
+		std::vector<uint8_t> current;
+		const uint8_t* texels = rgba;
+		for (uint32_t level = 0; level < TextureFormat::getLevelCount(width, height); ++level) {
+			const uint32_t levelWidth = TextureFormat::getLevelWidth(width, level), levelHeight = TextureFormat::getLevelWidth(height, level);
+			if (level > 0) {
+				current = downsample(texels, TextureFormat::getLevelWidth(width, level - 1), TextureFormat::getLevelWidth(height, level - 1));
+				texels = current.data();
+			}
+
+			levels.emplace_back(TextureFormat::getLevelSize(encoding, levelWidth, levelHeight));
+			encode(encoding, texels, levelWidth, levelHeight, levels.back().data());
+		}
+		return levels;
+	}
+
+}
+
+
+#endif
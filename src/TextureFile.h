@@ -0,0 +1,213 @@
+#ifndef VULKAN_TEXTUREFILE
+#define VULKAN_TEXTUREFILE
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TextureFormat.h"
+
+
+namespace Vulkan {
+
+	/**
+	 * @brief A cooked texture (.ktx2, see TextureFormat) open for reading.
+	 * @details The constructor reads and validates the header and the level index; the texels of each level are read on request straight into the caller's memory (e.g. staging memory), so they are copied once from the file to where the GPU reads them.
+	 */
+	class TextureFile {
+	public:
+
+		/**
+		 * @brief Opens and validates a cooked texture. Throws std::runtime_error if the file cannot be read or it is not a valid cooked texture.
+		 */
+		TextureFile(const std::string& path) : path{ path }, in{ path, std::ios::binary | std::ios::ate } {
+			if (!in) {
+				throw std::runtime_error{ "Failed to open texture " + path };
+			}
+			const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+			in.seekg(0);
+
+			uint8_t identifier[sizeof(TextureFormat::IDENTIFIER)];
+			if (!in.read(reinterpret_cast<char*>(identifier), sizeof(identifier)) || std::memcmp(identifier, TextureFormat::IDENTIFIER, sizeof(identifier)) != 0) {
+				fail("not a KTX 2.0 file");
+			}
+			if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+				fail("too small");
+			}
+			if (!TextureFormat::isValid(header.vkFormat)) {
+				fail("unsupported format " + std::to_string(header.vkFormat));
+			}
+			if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount > 1 || header.faceCount != 1) {
+				fail("not a 2D texture");
+			}
+			if (header.supercompressionScheme != 0) {
+				fail("supercompressed");
+			}
+			if (header.levelCount == 0 || header.levelCount > TextureFormat::getLevelCount(header.pixelWidth, header.pixelHeight)) {
+				fail("wrong number of levels");
+			}
+
+			levels.resize(header.levelCount);
+			if (!in.read(reinterpret_cast<char*>(levels.data()), levels.size() * sizeof(TextureFormat::LevelRecord))) {
+				fail("truncated level index");
+			}
+			for (uint32_t level = 0; level < header.levelCount; ++level) {
+				const auto& record = levels[level];
+				if (record.byteLength != getLevelSize(level) || record.byteOffset > fileSize || record.byteLength > fileSize - record.byteOffset) {
+					fail("level " + std::to_string(level) + " out of range");
+				}
+			}
+		}
+
+		TextureFile(const TextureFile&) = delete;
+		TextureFile& operator=(const TextureFile&) = delete;
+
+
+		TextureFormat::Encoding getEncoding() const {
+			return static_cast<TextureFormat::Encoding>(header.vkFormat);
+		}
+
+		uint32_t getWidth() const {
+			return header.pixelWidth;
+		}
+
+		uint32_t getHeight() const {
+			return header.pixelHeight;
+		}
+
+		uint32_t getLevelCount() const {
+			return header.levelCount;
+		}
+
+		uint64_t getLevelSize(uint32_t level) const {
+			return TextureFormat::getLevelSize(getEncoding(), TextureFormat::getLevelWidth(header.pixelWidth, level), TextureFormat::getLevelWidth(header.pixelHeight, level));
+		}
+
+		const std::string& getPath() const {
+			return path;
+		}
+
+
+		/**
+		 * @brief Reads the texels of a level into destination, which must be getLevelSize(level) bytes.
+		 */
+		void readLevel(uint32_t level, std::span<std::byte> destination) {
+			const auto& record = levels.at(level);
+			if (destination.size() != record.byteLength) {
+				throw std::runtime_error{ "The destination of level " + std::to_string(level) + " of texture " + path + " has the wrong size" };
+			}
+			in.seekg(record.byteOffset);
+			if (!in.read(reinterpret_cast<char*>(destination.data()), destination.size())) {
+				fail("truncated level " + std::to_string(level));
+			}
+		}
+
+
+		/**
+		 * @brief Writes a cooked texture. Throws std::runtime_error if the file cannot be written.
+		 *
+		 * @param levels The texels of each level, level 0 first (see TextureCompression::cook).
+		 */
+		static void write(const std::string& path, TextureFormat::Encoding encoding, uint32_t width, uint32_t height, const std::vector<std::vector<std::byte>>& levels) {
+			const auto dfd = getDataFormatDescriptor(encoding);
+			const uint32_t blockBytes = TextureFormat::getBlockBytes(encoding);
+
+			TextureFormat::Header header{};
+			header.vkFormat = static_cast<uint32_t>(encoding);
+			header.typeSize = 1;
+			header.pixelWidth = width;
+			header.pixelHeight = height;
+			header.faceCount = 1;
+			header.levelCount = static_cast<uint32_t>(levels.size());
+			header.dfdByteOffset = TextureFormat::LEVELS_OFFSET + header.levelCount * static_cast<uint32_t>(sizeof(TextureFormat::LevelRecord));
+			header.dfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+			//the levels are stored from the smallest one, each aligned to its blocks
+			std::vector<TextureFormat::LevelRecord> records(levels.size());
+			uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+			for (size_t level = levels.size(); level-- > 0;) {
+				offset = (offset + blockBytes - 1) / blockBytes * blockBytes;
+				records[level] = TextureFormat::LevelRecord{ offset, levels[level].size(), levels[level].size() };
+				offset += levels[level].size();
+			}
+
+			std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+			out.write(reinterpret_cast<const char*>(TextureFormat::IDENTIFIER), sizeof(TextureFormat::IDENTIFIER));
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TextureFormat::LevelRecord));
+			out.write(reinterpret_cast<const char*>(dfd.data()), dfd.size() * sizeof(uint32_t));
+			for (size_t level = levels.size(); level-- > 0;) {
+				const auto padding = records[level].byteOffset - static_cast<uint64_t>(out.tellp());
+				out.write("\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", padding);
+				out.write(reinterpret_cast<const char*>(levels[level].data()), levels[level].size());
+			}
+			if (!out) {
+				throw std::runtime_error{ "Failed to write texture " + path };
+			}
+		}
+
+
+	private:
+
+		[[noreturn]] void fail(const std::string& message) const {
+			throw std::runtime_error{ "Texture " + path + " is corrupted: " + message };
+		}
+
+
+		//the basic data format descriptor of the Khronos Data Format specification, which KTX 2.0 requires: how the bits of a texel block map to the channels
+		static std::vector<uint32_t> getDataFormatDescriptor(TextureFormat::Encoding encoding) {
+			struct Sample {
+				uint32_t bitOffset, bitLength, channel;
+				uint32_t upper;
+			};
+			constexpr uint32_t LINEAR = 0x10; //the alpha of an sRGB texture isn't sRGB encoded
+			std::vector<Sample> samples;
+			uint32_t colorModel;
+			switch (encoding) {
+			case TextureFormat::Encoding::BC1:
+				colorModel = 128; //BC1A
+				samples = { { 0, 64, 0, UINT32_MAX } };
+				break;
+			case TextureFormat::Encoding::BC7:
+				colorModel = 134; //BC7
+				samples = { { 0, 128, 0, UINT32_MAX } };
+				break;
+			default:
+				colorModel = 1; //RGBSDA
+				samples = { { 0, 8, 0, 255 }, { 8, 8, 1, 255 }, { 16, 8, 2, 255 }, { 24, 8, 15 | LINEAR, 255 } };
+				break;
+			}
+
+			const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+			const uint32_t blockDimension = TextureFormat::getBlockDimension(encoding) - 1;
+			std::vector<uint32_t> dfd{
+				4 + blockSize, //total size
+				0, //vendor Khronos, basic descriptor type
+				2 | blockSize << 16, //version 1.3
+				colorModel | 1 << 8 | 2 << 16, //BT.709 primaries, sRGB transfer function, straight alpha
+				blockDimension | blockDimension << 8,
+				TextureFormat::getBlockBytes(encoding), //bytes of plane 0
+				0
+			};
+			for (const auto& sample : samples) {
+				dfd.insert(dfd.end(), { sample.bitOffset | (sample.bitLength - 1) << 16 | sample.channel << 24, 0, 0, sample.upper });
+			}
+			return dfd;
+		}
+
+
+		std::string path;
+		std::ifstream in;
+		TextureFormat::Header header{};
+		std::vector<TextureFormat::LevelRecord> levels;
+	};
+
+}
+
+
+#endif
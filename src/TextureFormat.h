@@ -0,0 +1,124 @@
+#ifndef VULKAN_TEXTUREFORMAT
+#define VULKAN_TEXTUREFORMAT
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+
+/**
+ * @brief Layout of the cooked textures (.ktx2): a subset of KTX 2.0 holding a 2D texture with its whole mip chain, ready to be copied to the GPU level by level.
+ * @details A cooked texture is the KTX 2.0 identifier, a Header, a LevelRecord per mip level (level 0, the largest, first), a data format descriptor and then the texels of the levels, smallest level first, each aligned to its block size.
+ *			Only non supercompressed, single layer, single face textures in one of the Encodings are written and read. The texels are in the layout Vulkan copies from a buffer: rows of blocks, tightly packed.
+ *			Textures are cooked by the TextureCooker tool, or by TextureImage the first time it loads an image which has no up to date cooked texture.
+ */
+namespace Vulkan::TextureFormat {
+
+	static_assert(std::endian::native == std::endian::little, "KTX 2.0 files are little endian");
+
+	constexpr uint8_t IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+
+	/**
+	 * @brief How the texels are stored. The values are the ones of the corresponding VkFormat, all sRGB.
+	 */
+	enum class Encoding : uint32_t {
+		RGBA8 = 43, //VK_FORMAT_R8G8B8A8_SRGB, 4 bytes per texel
+		BC1 = 132, //VK_FORMAT_BC1_RGB_SRGB_BLOCK, 8 bytes per 4x4 block (no alpha)
+		BC7 = 146 //VK_FORMAT_BC7_SRGB_BLOCK, 16 bytes per 4x4 block
+	};
+
+
+#pragma pack(push, 4) //as in the file, where the header starts after the 12 bytes of the identifier
+	struct Header {
+		uint32_t vkFormat; //Encoding
+		uint32_t typeSize; //1
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth; //0 (2D)
+		uint32_t layerCount; //0 (not an array)
+		uint32_t faceCount; //1 (not a cube map)
+		uint32_t levelCount;
+		uint32_t supercompressionScheme; //0 (none)
+
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset; //0 (no key/value data)
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset; //0 (no supercompression data)
+		uint64_t sgdByteLength;
+	};
+#pragma pack(pop)
+
+
+	struct LevelRecord {
+		uint64_t byteOffset; //from the beginning of the file
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength; //the same as byteLength
+	};
+
+
+	static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 68);
+	static_assert(std::is_trivially_copyable_v<LevelRecord> && sizeof(LevelRecord) == 24);
+
+	constexpr uint32_t HEADER_OFFSET = sizeof(IDENTIFIER);
+	constexpr uint32_t LEVELS_OFFSET = HEADER_OFFSET + sizeof(Header);
+
+
+
+	/**
+	 * @brief Returns the width and height of a block of texels: the whole texture is made of blocks, and the GPU decodes each of them on its own.
+	 */
+	constexpr uint32_t getBlockDimension(Encoding encoding) {
+		return encoding == Encoding::RGBA8 ? 1 : 4;
+	}
+
+
+	constexpr uint32_t getBlockBytes(Encoding encoding) {
+		switch (encoding) {
+		case Encoding::BC1: return 8;
+		case Encoding::BC7: return 16;
+		default: return 4;
+		}
+	}
+
+
+	/**
+	 * @brief Returns the extension of the cooked textures with an encoding, which replaces the one of the image they are cooked from (e.g. textures/skybox.png is cooked to textures/skybox.bc7.ktx2).
+	 */
+	constexpr const char* getExtension(Encoding encoding) {
+		switch (encoding) {
+		case Encoding::BC1: return ".bc1.ktx2";
+		case Encoding::BC7: return ".bc7.ktx2";
+		default: return ".rgba8.ktx2";
+		}
+	}
+
+
+	constexpr bool isValid(uint32_t vkFormat) {
+		return vkFormat == static_cast<uint32_t>(Encoding::RGBA8) || vkFormat == static_cast<uint32_t>(Encoding::BC1) || vkFormat == static_cast<uint32_t>(Encoding::BC7);
+	}
+
+
+	/**
+	 * @brief Returns the number of levels of the whole mip chain of a texture, down to 1x1.
+	 */
+	constexpr uint32_t getLevelCount(uint32_t width, uint32_t height) {
+		return std::bit_width(std::max({ width, height, 1u }));
+	}
+
+
+	constexpr uint32_t getLevelWidth(uint32_t width, uint32_t level) {
+		return std::max(width >> level, 1u);
+	}
+
+
+	constexpr uint64_t getLevelSize(Encoding encoding, uint32_t width, uint32_t height) {
+		const uint32_t block = getBlockDimension(encoding);
+		return uint64_t{ (width + block - 1) / block } * ((height + block - 1) / block) * getBlockBytes(encoding);
+	}
+}
+
+
+#endif
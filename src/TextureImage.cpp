@@ -1,49 +1,121 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <vulkan/vulkan.h>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
 
 #include "TextureImage.h"
 #include "LogicalDevice.h"
 #include "PhysicalDevice.h"
-#include "StagingBuffer.h"
+#include "UploadContext.h"
 #include "CommandBuffer.h"
 #include "CommandBufferPool.h"
 #include "Barriers.h"
 #include "Queue.h"
+#include "JobSystem.h"
+#include "Timeline.h"
+#include "TextureCompression.h"
+#include "TextureFile.h"
 
 
 
-Vulkan::TextureImage::TextureImage(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, const CommandBufferPool& commandBufferPool, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture)
-    : Image{ virtualGpu, realGpu, VK_FORMAT_R8G8B8A8_SRGB, resolution, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT },
-    textureSampler{ virtualGpu, realGpu }
+Vulkan::TextureImage::TextureImage(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, Buffers::UploadContext& uploadContext, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture, TextureFormat::Encoding encoding, uint32_t firstLevel)
+    : Image{ virtualGpu, realGpu, static_cast<VkFormat>(chooseEncoding(realGpu, encoding)), getLevelResolution(resolution, firstLevel), TextureFormat::getLevelCount(resolution.first, resolution.second) - firstLevel, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT },
+    textureSampler{ virtualGpu, realGpu },
+    firstLevel{ firstLevel }
 {
+    load(pathToTexture, resolution, getEncoding(), firstLevel, prepare(uploadContext));
+}
+
+
+
+Vulkan::TextureImage::TextureImage(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, Buffers::UploadContext& uploadContext, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture, TextureFormat::Encoding encoding, Utilities::JobSystem& jobs, Utilities::JobCounter& loads, Utilities::Timeline* timeline, uint32_t firstLevel)
+    : Image{ virtualGpu, realGpu, static_cast<VkFormat>(chooseEncoding(realGpu, encoding)), getLevelResolution(resolution, firstLevel), TextureFormat::getLevelCount(resolution.first, resolution.second) - firstLevel, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT },
+    textureSampler{ virtualGpu, realGpu },
+    firstLevel{ firstLevel }
+{
+    //the staging memory is mapped for its whole lifetime and stays where it is, so a worker can write into it while the main thread stages other uploads
+    jobs.submit(loads, [pathToTexture, resolution, encoding = getEncoding(), firstLevel, levels = prepare(uploadContext), timeline]() {
+        if (timeline != nullptr) {
+            Utilities::Timeline::Scope scope{ *timeline, "load " + pathToTexture };
+            load(pathToTexture, resolution, encoding, firstLevel, levels);
+        }
+        else {
+            load(pathToTexture, resolution, encoding, firstLevel, levels);
+        }
+        }, "load texture");
+}
+
+
+
+std::vector<std::span<std::byte>> Vulkan::TextureImage::prepare(Buffers::UploadContext& uploadContext) {
+    //the upload context copies the staging memory of each level to the GPU, and moves the image to a layout suitable for sampling
+    std::vector<std::span<std::byte>> levels;
+    for (uint32_t level = 0; level < mipLevels; ++level) {
+        const uint32_t width = TextureFormat::getLevelWidth(resolution.first, level), height = TextureFormat::getLevelWidth(resolution.second, level);
+        levels.push_back(uploadContext.stage(*this, VkImageSubresourceLayers{ VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 }, VkExtent3D{ width, height, 1 }, TextureFormat::getLevelSize(getEncoding(), width, height), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+    }
+    layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; //once the context is submitted
+
+    //create the image view
+    generateImageView("base", *virtualGpu, VK_IMAGE_ASPECT_COLOR_BIT);
+    return levels;
+}
+
+
+
+void Vulkan::TextureImage::load(const std::string& pathToTexture, std::pair<unsigned int, unsigned int> resolution, TextureFormat::Encoding encoding, uint32_t firstLevel, const std::vector<std::span<std::byte>>& levels) {
+    //the cooked texture is used unless the image has changed since it was cooked (if there is no image, the cooked texture is used as is)
+    const auto cookedPath = getCookedPath(pathToTexture, encoding);
+    std::error_code error;
+    const auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+    if (!error) {
+        const auto imageTime = std::filesystem::last_write_time(pathToTexture, error);
+        if (error || imageTime <= cookedTime) {
+            try {
+                TextureFile cooked{ cookedPath };
+                if (cooked.getEncoding() == encoding && cooked.getWidth() == resolution.first && cooked.getHeight() == resolution.second && cooked.getLevelCount() == firstLevel + levels.size()) {
+                    for (uint32_t level = 0; level < levels.size(); ++level) {
+                        cooked.readLevel(firstLevel + level, levels[level]);
+                    }
+                    return;
+                }
+                std::cout << "\nThe cooked texture " << cookedPath << " doesn't match " << pathToTexture << ", cooking it again";
+            }
+            catch (const std::runtime_error& e) {
+                std::cout << "\n" << e.what() << ", cooking it again";
+            }
+        }
+    }
+
     //load image in CPU memory
     int width, height, channels;
     stbi_uc* pixels = stbi_load(pathToTexture.c_str(), &width, &height, &channels, STBI_rgb_alpha);
     if (!pixels) {
-        throw VulkanException{ "Failed to load texture image!" };
+        throw VulkanException{ "Failed to load texture image!", pathToTexture };
     }
     if (resolution != std::pair<unsigned int, unsigned int>{width, height}) {
-        throw VulkanException{ "Width or height of the texture doesn't match width and height of the TextureImage object" };
+        stbi_image_free(pixels);
+        throw VulkanException{ "Width or height of the texture doesn't match width and height of the TextureImage object", pathToTexture };
     }
-    VkDeviceSize imageSize = width * height * 4;
-
-    //load image in a staging buffer, in order to copy it to the GPU next
-    Buffers::StagingBuffer stagingBuffer{ virtualGpu, realGpu, imageSize };
-    stagingBuffer.fillBuffer(pixels, imageSize);
-    stbi_image_free(pixels); //release memory arei in CPU (the image is now in the buffer)
-
-    //change the layout of the image in order to be able to receive data from a buffer
-    transitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, commandBufferPool);
 
-    //fill the image with the data of the staging buffer
-    fillImage(stagingBuffer, commandBufferPool);
-
-    //change image layout to a layout suitable for sampling on the GPU
-    transitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, commandBufferPool);
+    //build and encode the mip chain, then copy the levels of the image to the staging memory
+    const auto cookedLevels = TextureCompression::cook(pixels, resolution.first, resolution.second, encoding);
+    stbi_image_free(pixels); //release memory area in CPU (the levels are cooked)
+    for (size_t level = 0; level < levels.size(); ++level) {
+        memcpy(levels[level].data(), cookedLevels[firstLevel + level].data(), levels[level].size());
+    }
 
-    //create the image view
-    generateImageView("base", virtualGpu, VK_IMAGE_ASPECT_COLOR_BIT);
+    //if the cooked texture cannot be written, the image is cooked again next time
+    try {
+        TextureFile::write(cookedPath, encoding, resolution.first, resolution.second, cookedLevels);
+        std::cout << "\nTexture " << pathToTexture << " cooked to " << cookedPath;
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << "\n" << e.what();
+    }
 }
 
 
@@ -63,27 +135,52 @@ void Vulkan::TextureImage::transitionLayout(VkImageLayout newLayout, const Comma
 
 
 
-void Vulkan::TextureImage::fillImage(const Buffers::StagingBuffer& imageData, const CommandBufferPool& commandBufferPool) {
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = { resolution.first, resolution.second, 1 };
+const Vulkan::TextureSampler& Vulkan::TextureImage::getSampler() const {
+    return textureSampler;
+}
+
+
+
+Vulkan::TextureFormat::Encoding Vulkan::TextureImage::getEncoding() const {
+    return static_cast<TextureFormat::Encoding>(format);
+}
 
-    CommandBuffer commandBuffer{ *virtualGpu, commandBufferPool };
-    commandBuffer.addCommand(vkCmdCopyBufferToImage, +imageData, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region)
-        .endCommand()
-        .sendCommand((*virtualGpu)[QueueFamily::GRAPHICS]);
 
-    vkQueueWaitIdle(+(*virtualGpu)[QueueFamily::GRAPHICS]); //TODO not best for performance
+
+uint32_t Vulkan::TextureImage::getFirstLevel() const {
+    return firstLevel;
 }
 
 
-const Vulkan::TextureSampler& Vulkan::TextureImage::getSampler() const {
-    return textureSampler;
+
+std::pair<unsigned int, unsigned int> Vulkan::TextureImage::getLevelResolution(std::pair<unsigned int, unsigned int> resolution, uint32_t level) {
+    if (level >= TextureFormat::getLevelCount(resolution.first, resolution.second)) {
+        throw VulkanException{ "Failed to create the texture image", "The first level is past the end of the mip chain" };
+    }
+    return { TextureFormat::getLevelWidth(resolution.first, level), TextureFormat::getLevelWidth(resolution.second, level) };
+}
+
+
+
+Vulkan::TextureFormat::Encoding Vulkan::TextureImage::chooseEncoding(const PhysicalDevice& realGpu, TextureFormat::Encoding requested) {
+    if (requested == TextureFormat::Encoding::RGBA8) {
+        return requested;
+    }
+
+    //block compressed formats need a feature (enabled by the LogicalDevice where supported), and the format must be sampled with linear filtering
+    VkPhysicalDeviceFeatures features;
+    vkGetPhysicalDeviceFeatures(+realGpu, &features);
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(+realGpu, static_cast<VkFormat>(requested), &properties);
+    const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    if (features.textureCompressionBC && (properties.optimalTilingFeatures & required) == required) {
+        return requested;
+    }
+    return TextureFormat::Encoding::RGBA8;
+}
+
+
+
+std::string Vulkan::TextureImage::getCookedPath(const std::string& pathToTexture, TextureFormat::Encoding encoding) {
+    return std::filesystem::path{ pathToTexture }.replace_extension(TextureFormat::getExtension(encoding)).string();
 }
\ No newline at end of file
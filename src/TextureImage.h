@@ -2,22 +2,47 @@
 #define VULKAN_TEXTUREIMAGE
 
 #include <vulkan/vulkan.h>
+#include <cstddef>
+#include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "TextureSampler.h"
 #include "Image.h"
+#include "TextureFormat.h"
 
 
 namespace Vulkan {
     class TextureImage; class LogicalDevice; class PhysicalDevice; class CommandBufferPool; class TextureSampler;
-    namespace Buffers { class StagingBuffer; }
+    namespace Buffers { class UploadContext; }
+    namespace Utilities { class JobSystem; class JobCounter; class Timeline; }
 }
 
 
+/**
+ * @brief A sampled image with its whole mip chain, block compressed where the GPU supports it.
+ * @details The texels come from the cooked texture of the image (see TextureFormat and getCookedPath), whose levels are read straight into the staging memory.
+ *          If the cooked texture is missing, or older than the image, the image is decoded, its mip chain is built and encoded (see TextureCompression), and the result is cooked for the next time.
+ */
 class Vulkan::TextureImage : public Vulkan::Image {
 public:
-    TextureImage(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, const CommandBufferPool& commandBufferPool, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture);
+    /**
+     * @brief Loads the texture and stages its texels in uploadContext: the image can be sampled by the commands submitted to the graphics queue after the context is submitted.
+     *
+     * @param resolution The resolution of the texture (i.e. of its level 0).
+     * @param encoding How the texels are stored on the GPU. If the GPU cannot sample it, RGBA8 is used instead.
+     * @param firstLevel The first level of the mip chain of the texture which the image holds: the image is 2^firstLevel times smaller than the texture, and has the levels from firstLevel on (see TextureStreamer).
+     */
+    TextureImage(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, Buffers::UploadContext& uploadContext, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture, TextureFormat::Encoding encoding = TextureFormat::Encoding::BC7, uint32_t firstLevel = 0);
+
+    /**
+     * @brief Reserves the staging memory of the texture in uploadContext, and loads the texture into it with a job, so that many textures are loaded at the same time, while the caller goes on.
+     * @details The context must not be submitted before the load is finished (i.e. before jobs.wait(loads) returns), which rethrows the errors of the load.
+     *
+     * @param timeline If not null, where the load is recorded.
+     */
+    TextureImage(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, Buffers::UploadContext& uploadContext, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture, TextureFormat::Encoding encoding, Utilities::JobSystem& jobs, Utilities::JobCounter& loads, Utilities::Timeline* timeline = nullptr, uint32_t firstLevel = 0);
 
 	TextureImage(const TextureImage&) = delete;
 	TextureImage& operator=(const TextureImage&) = delete;
@@ -37,19 +62,43 @@ public:
     void transitionLayout(VkImageLayout newLayout, const CommandBufferPool& commandBufferPool);
 
 
+    const TextureSampler& getSampler() const;
+
+
+    TextureFormat::Encoding getEncoding() const;
+
+
     /**
-     * @brief Fills the image with the data stored in the buffer.
-     * 
-     * @param imageData Data to load to the image (generally textels).
-     * @param commandBufferPool From where to allocate the command buffer used to perform the copy.
+     * @brief Returns the level of the mip chain of the texture which is the level 0 of the image.
      */
-    void fillImage(const Buffers::StagingBuffer& imageData, const CommandBufferPool& commandBufferPool);
+    uint32_t getFirstLevel() const;
 
 
-    const TextureSampler& getSampler() const;
+    /**
+     * @brief Returns the requested encoding if the GPU can sample and filter it, else RGBA8.
+     */
+    static TextureFormat::Encoding chooseEncoding(const PhysicalDevice& realGpu, TextureFormat::Encoding requested);
+
+
+    /**
+     * @brief Returns where the cooked texture of an image is: next to it, with the extension of the encoding (see TextureFormat::getExtension).
+     */
+    static std::string getCookedPath(const std::string& pathToTexture, TextureFormat::Encoding encoding);
 
 private:
+
+    //Reserve the staging memory of each mip level and create the view; the texels of each level are to be written in the returned memory
+    std::vector<std::span<std::byte>> prepare(Buffers::UploadContext& uploadContext);
+
+    //Read the cooked texture of the image at path (cooking it if needed) straight into the memory of each level
+    static void load(const std::string& pathToTexture, std::pair<unsigned int, unsigned int> resolution, TextureFormat::Encoding encoding, uint32_t firstLevel, const std::vector<std::span<std::byte>>& levels);
+
+    //The resolution of a level of the texture, which must exist
+    static std::pair<unsigned int, unsigned int> getLevelResolution(std::pair<unsigned int, unsigned int> resolution, uint32_t level);
+
+
     TextureSampler textureSampler; //how the image is filtered before accessing (e.g. anisotropic)
+    uint32_t firstLevel;
 
 };
 
@@ -33,7 +33,7 @@ public:
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.mipLodBias = 0.0f;
 		samplerInfo.minLod = 0.0f;
-		samplerInfo.maxLod = 0.0f;
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE; //all the mip levels of the image
 
 		if (VkResult result = vkCreateSampler(+virtualGpu, &samplerInfo, nullptr, &textureSampler); result != VK_SUCCESS) {
 			throw VulkanException{ "Failed to create texture sampler!", result };
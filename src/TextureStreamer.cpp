@@ -0,0 +1,178 @@
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "TextureStreamer.h"
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "StaticSet.h"
+#include "Drawer.h"
+#include "Tracer.h"
+
+
+
+void Vulkan::TextureStreamer::StreamedTexture::bind(StaticSet& set, int binding) {
+	set.setTexture(binding, *image);
+	bindings.push_back({ &set, binding });
+}
+
+
+
+VkDeviceSize Vulkan::TextureStreamer::StreamedTexture::getBytes(uint32_t level) const {
+	const auto encoding = image->getEncoding(); //the one the GPU can sample, which may not be the requested one
+	VkDeviceSize bytes = 0;
+	for (uint32_t i = level; i < TextureFormat::getLevelCount(resolution.first, resolution.second); ++i) {
+		bytes += TextureFormat::getLevelSize(encoding, TextureFormat::getLevelWidth(resolution.first, i), TextureFormat::getLevelWidth(resolution.second, i));
+	}
+	return bytes;
+}
+
+
+
+uint32_t Vulkan::TextureStreamer::StreamedTexture::getSampledLevel() const {
+	if (requestedSize <= 0.0f) {
+		return coarsestLevel;
+	}
+	//each level halves the texels, so the sampled level is the one with about a texel per pixel (the finer one, if in between)
+	const float texels = static_cast<float>(std::max(resolution.first, resolution.second));
+	const float level = std::floor(std::log2(texels / requestedSize));
+	return static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(coarsestLevel)));
+}
+
+
+
+Vulkan::TextureStreamer::TextureStreamer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, Utilities::JobSystem& jobs, VkDeviceSize budget, unsigned int startupSize) :
+	virtualGpu{ virtualGpu }, realGpu{ realGpu }, jobs{ jobs }, budget{ budget }, startupSize{ startupSize }, uploads{ virtualGpu, realGpu } {}
+
+
+
+Vulkan::TextureStreamer::~TextureStreamer() {
+	try {
+		jobs.wait(loads); //the job writes into the staging memory of uploads
+	}
+	catch (...) {} //the image would have been thrown away anyway
+}
+
+
+
+Vulkan::TextureStreamer::StreamedTexture& Vulkan::TextureStreamer::add(Buffers::UploadContext& startupUploads, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture, TextureFormat::Encoding encoding, int priority, Utilities::JobCounter& startupLoads, Utilities::Timeline* timeline) {
+	uint32_t coarsestLevel = 0;
+	while (std::max(TextureFormat::getLevelWidth(resolution.first, coarsestLevel), TextureFormat::getLevelWidth(resolution.second, coarsestLevel)) > startupSize) {
+		coarsestLevel++;
+	}
+
+	auto image = std::make_unique<TextureImage>(virtualGpu, realGpu, startupUploads, resolution, pathToTexture, encoding, jobs, startupLoads, timeline, coarsestLevel);
+	std::unique_ptr<StreamedTexture> texture{ new StreamedTexture{ std::move(image), resolution, std::move(pathToTexture), encoding, priority } };
+	auto position = std::upper_bound(textures.begin(), textures.end(), priority, [](int priority, const std::unique_ptr<StreamedTexture>& texture) { return priority < texture->priority; });
+	auto& added = **textures.insert(position, std::move(texture));
+	updateResidentBytes();
+	return added;
+}
+
+
+
+bool Vulkan::TextureStreamer::update(unsigned int frame, Drawer& drawer) {
+	//start the next transition
+	if (!changing) {
+		changing = plan();
+		if (!changing) {
+			return false;
+		}
+		VULKAN_TRACE_ZONE("TextureStreamer::load");
+		next = std::make_unique<TextureImage>(virtualGpu, realGpu, uploads, changing->resolution, changing->path, changing->encoding, jobs, loads, nullptr, changing->wantedLevel);
+		submitted = false;
+		stats.peakResidentBytes = std::max(stats.peakResidentBytes, stats.residentBytes + changing->getBytes(changing->wantedLevel));
+		return true;
+	}
+
+	//upload the new image once it is loaded
+	if (next && !submitted) {
+		if (!loads.isDone()) {
+			return false;
+		}
+		VULKAN_TRACE_ZONE("TextureStreamer::submit");
+		jobs.wait(loads); //rethrows the error of the load
+		uploads.submit();
+		submitted = true;
+		return true;
+	}
+
+	//swap it in once it is uploaded: from now on the sets point to the new image, but the descriptor sets of the frames in flight still point to the old one
+	if (next) {
+		if (!uploads.collect()) {
+			return false;
+		}
+		VULKAN_TRACE_ZONE("TextureStreamer::swap");
+		(next->getFirstLevel() < changing->getResidentLevel() ? stats.loads : stats.evictions)++;
+		retired = std::move(changing->image);
+		changing->image = std::move(next);
+		for (auto [set, binding] : changing->bindings) {
+			set->setTexture(binding, *changing->image);
+		}
+		rewritten.assign(drawer.getFramesInFlight(), false);
+		updateResidentBytes();
+		std::cout << "\nTexture " << changing->path << ": levels from " << changing->getResidentLevel() << " resident, " << stats.residentBytes << "/" << budget << " bytes of textures";
+	}
+
+	//rewrite the descriptor sets of this frame, whose previous use the GPU has finished; once all of them are rewritten no frame can read the old image anymore
+	if (!rewritten[frame]) {
+		VULKAN_TRACE_ZONE("TextureStreamer::rewrite");
+		for (auto [set, binding] : changing->bindings) {
+			drawer.updateGlobalSet(frame, *set);
+		}
+		rewritten[frame] = true;
+	}
+	if (std::all_of(rewritten.begin(), rewritten.end(), [](bool frameRewritten) { return frameRewritten; })) {
+		retired.reset();
+		changing = nullptr;
+	}
+	return true;
+}
+
+
+
+Vulkan::TextureStreamer::StreamedTexture* Vulkan::TextureStreamer::plan() {
+	//the level each texture is sampled at; a texture gets a coarser level only once it is sampled two levels coarser, so that it doesn't go back and forth when its size is close to the boundary of a level
+	VkDeviceSize total = 0;
+	for (auto& texture : textures) {
+		uint32_t level = texture->getSampledLevel();
+		if (level == texture->getResidentLevel() + 1) {
+			level = texture->getResidentLevel();
+		}
+		texture->wantedLevel = level;
+		texture->requestedSize = 0.0f;
+		total += texture->getBytes(level);
+	}
+
+	//under pressure, the textures with the lowest priority get coarser levels first
+	for (auto& texture : textures) {
+		while (total > budget && texture->wantedLevel < texture->coarsestLevel) {
+			total -= texture->getBytes(texture->wantedLevel) - texture->getBytes(texture->wantedLevel + 1);
+			texture->wantedLevel++;
+		}
+	}
+
+	//evictions first (from the lowest priority), so that the memory is freed before the loads (from the highest priority) need it
+	for (auto& texture : textures) {
+		if (texture->wantedLevel > texture->getResidentLevel()) {
+			return texture.get();
+		}
+	}
+	for (auto texture = textures.rbegin(); texture != textures.rend(); ++texture) {
+		if ((*texture)->wantedLevel < (*texture)->getResidentLevel()) {
+			return texture->get();
+		}
+	}
+	return nullptr;
+}
+
+
+
+void Vulkan::TextureStreamer::updateResidentBytes() {
+	stats.residentBytes = 0;
+	for (const auto& texture : textures) {
+		stats.residentBytes += texture->getBytes(texture->getResidentLevel());
+	}
+	stats.peakResidentBytes = std::max(stats.peakResidentBytes, stats.residentBytes);
+}
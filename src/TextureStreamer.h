@@ -0,0 +1,191 @@
+#ifndef VULKAN_TEXTURESTREAMER
+#define VULKAN_TEXTURESTREAMER
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TextureImage.h"
+#include "TextureFormat.h"
+#include "UploadContext.h"
+#include "JobSystem.h"
+
+
+namespace Vulkan {
+	class TextureStreamer; class LogicalDevice; class PhysicalDevice; class StaticSet; class Drawer;
+	namespace Utilities { class Timeline; }
+}
+
+
+/**
+ * @brief Keeps each texture at the mip level it is seen at, within a memory budget: the textures start from their low levels, and the high ones are loaded in the background.
+ * @details Vulkan 1.0 has no sparse residency, so a texture holds the levels of its mip chain from a first level on, which is changed by loading a new TextureImage from that level (see TextureImage::getFirstLevel) and swapping it in.
+ *			Each frame the users tell how large each texture is on screen (see StreamedTexture::request), which gives the level it is sampled at. If the levels wanted by all the textures don't fit the budget, the textures with the lowest priority are given coarser levels first.
+ *			A transition at a time runs: the new image is loaded by a job and uploaded by the streamer's own UploadContext, then it replaces the old one in the sets which use it, and the descriptor sets of each frame in flight are rewritten once the GPU has finished that frame (see update).
+ *			The old image is destroyed once the descriptor sets of all the frames have been rewritten, since no frame in flight can still read it.
+ */
+class Vulkan::TextureStreamer {
+public:
+
+	/**
+	 * @brief A texture whose resident levels are managed by the streamer.
+	 */
+	class StreamedTexture {
+	public:
+		StreamedTexture(const StreamedTexture&) = delete;
+		StreamedTexture& operator=(const StreamedTexture&) = delete;
+
+
+		/**
+		 * @brief Returns the image which holds the resident levels. It changes when the resident levels change.
+		 */
+		const TextureImage& getImage() const {
+			return *image;
+		}
+
+
+		/**
+		 * @brief Binds the texture to an image binding of a set, which is updated each time the image changes. The descriptor sets of the set must be in the Drawer passed to update.
+		 */
+		void bind(StaticSet& set, int binding);
+
+
+		/**
+		 * @brief Tells the streamer how large the texture is on screen in this frame: the size, in pixels, which the whole texture would cover. It is called for each use of the texture, the largest one counts.
+		 * @details A texture which isn't requested between two plans of the streamer isn't seen, so it is kept at its coarsest level.
+		 */
+		void request(float screenSize) {
+			requestedSize = std::max(requestedSize, screenSize);
+		}
+
+
+		/**
+		 * @brief Returns the first level of the mip chain which is resident.
+		 */
+		uint32_t getResidentLevel() const {
+			return image->getFirstLevel();
+		}
+
+
+		/**
+		 * @brief Returns the bytes of the texels of the levels from level on.
+		 */
+		VkDeviceSize getBytes(uint32_t level) const;
+
+
+		const std::string& getPath() const {
+			return path;
+		}
+
+
+		int getPriority() const {
+			return priority;
+		}
+
+	private:
+		friend class TextureStreamer;
+
+		StreamedTexture(std::unique_ptr<TextureImage> image, std::pair<unsigned int, unsigned int> resolution, std::string path, TextureFormat::Encoding encoding, int priority) :
+			image{ std::move(image) }, resolution{ resolution }, path{ std::move(path) }, encoding{ encoding }, priority{ priority }, coarsestLevel{ this->image->getFirstLevel() } {}
+
+
+		//The level the texture is sampled at, for the size requested since the last plan
+		uint32_t getSampledLevel() const;
+
+
+		std::unique_ptr<TextureImage> image;
+		std::pair<unsigned int, unsigned int> resolution; //of level 0
+		std::string path;
+		TextureFormat::Encoding encoding;
+		int priority;
+		uint32_t coarsestLevel; //the levels from the one loaded at startup on are always resident
+		uint32_t wantedLevel = 0; //the outcome of the last plan
+		float requestedSize = 0.0f;
+		std::vector<std::pair<StaticSet*, int>> bindings;
+	};
+
+
+	struct Stats {
+		uint64_t loads = 0; //transitions to finer levels
+		uint64_t evictions = 0; //transitions to coarser levels
+		VkDeviceSize residentBytes = 0;
+		VkDeviceSize peakResidentBytes = 0; //including the old and the new image of a transition, which are both resident while it runs
+	};
+
+
+
+	/**
+	 * @param budget The bytes of texels the textures can take. The coarsest levels of the textures (the ones loaded at startup) are always resident, even if they take more.
+	 * @param startupSize The largest dimension of the coarsest level of each texture, which is loaded at startup.
+	 */
+	TextureStreamer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, Utilities::JobSystem& jobs, VkDeviceSize budget, unsigned int startupSize = 256);
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	/**
+	 * @brief Waits for the transition which is still running. The GPU must be done with the textures (e.g. vkDeviceWaitIdle).
+	 */
+	~TextureStreamer();
+
+
+
+	/**
+	 * @brief Adds a texture to the streamer, and loads its coarsest levels with a job, which stages them in startupUploads (see the asynchronous constructor of TextureImage).
+	 *
+	 * @param priority Under pressure, the textures with the lowest priority are given coarser levels first.
+	 * @return The texture, which lives as long as the streamer.
+	 */
+	StreamedTexture& add(Buffers::UploadContext& startupUploads, std::pair<unsigned int, unsigned int> resolution, std::string pathToTexture, TextureFormat::Encoding encoding, int priority, Utilities::JobCounter& startupLoads, Utilities::Timeline* timeline = nullptr);
+
+
+	/**
+	 * @brief Moves the running transition forward, or plans and starts the next one. It is called once per frame, once the GPU has finished the previous use of the frame (see Drawer::waitForFrame), and after the textures have been requested.
+	 * @details The images which are swapped in must not be read by the GPU before the uploads of the startup are finished, since the old ones may be destroyed.
+	 *
+	 * @param frame The frame which is about to be drawn, whose descriptor sets can be rewritten.
+	 * @return Whether a transition has been started, submitted, swapped in or finished, which allocates; just planning doesn't.
+	 */
+	bool update(unsigned int frame, Drawer& drawer);
+
+
+	Stats getStats() const {
+		return stats;
+	}
+
+
+private:
+
+	//Choose the level of each texture, then return the texture which should change first (evictions first, so the memory is freed before it is needed), or null
+	StreamedTexture* plan();
+
+	void updateResidentBytes();
+
+
+	const LogicalDevice& virtualGpu;
+	const PhysicalDevice& realGpu;
+	Utilities::JobSystem& jobs;
+	const VkDeviceSize budget;
+	const unsigned int startupSize;
+
+	std::vector<std::unique_ptr<StreamedTexture>> textures; //by increasing priority
+
+	//the running transition: the load of next, its upload, then the rewrite of the descriptor sets of each frame
+	Buffers::UploadContext uploads;
+	Utilities::JobCounter loads;
+	StreamedTexture* changing = nullptr;
+	std::unique_ptr<TextureImage> next;
+	bool submitted = false;
+	std::unique_ptr<TextureImage> retired; //the image which has been swapped out, which the frames still to be rewritten may be reading
+	std::vector<bool> rewritten; //for each frame in flight, whether its descriptor sets use the new image
+
+	Stats stats;
+};
+
+
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef VULKAN_TIMELINE
+#define VULKAN_TIMELINE
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Vulkan::Utilities {
+
+	/**
+	 * @brief Records named intervals of time from many threads and prints them as a chart, one row per interval, so that it shows which ones overlap (e.g. the phases of the startup).
+	 * @details Unlike the Tracer, it is always enabled: it is meant for few, long intervals.
+	 */
+	class Timeline {
+	public:
+
+		using Clock = std::chrono::steady_clock;
+
+
+		/**
+		 * @brief Records an interval from its creation to its destruction.
+		 */
+		class Scope {
+		public:
+			Scope(Timeline& timeline, std::string name) : timeline{ timeline }, name{ std::move(name) }, begin{ Clock::now() } {}
+
+			~Scope() {
+				timeline.add(std::move(name), begin, Clock::now());
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			Timeline& timeline;
+			std::string name;
+			Clock::time_point begin;
+		};
+
+
+		Timeline() : origin{ Clock::now() } {}
+
+		Timeline(const Timeline&) = delete;
+		Timeline& operator=(const Timeline&) = delete;
+
+
+
+		void add(std::string name, Clock::time_point begin, Clock::time_point end) {
+			std::lock_guard lock{ mutex };
+			intervals.push_back(Interval{ std::move(name), begin, end });
+		}
+
+
+		/**
+		 * @brief Prints the intervals in order of beginning: their times in milliseconds since the creation of the timeline, and a bar which spans their part of the chart.
+		 *
+		 * @param width The number of columns of the bars.
+		 */
+		void print(std::ostream& out, size_t width = 60) const {
+			std::lock_guard lock{ mutex };
+			if (intervals.empty()) {
+				return;
+			}
+
+			auto sorted = intervals;
+			std::stable_sort(sorted.begin(), sorted.end(), [](const Interval& i1, const Interval& i2) { return i1.begin < i2.begin; });
+			const auto last = std::max_element(sorted.begin(), sorted.end(), [](const Interval& i1, const Interval& i2) { return i1.end < i2.end; })->end;
+			const double total = std::max(toMilliseconds(last), 1e-3);
+			size_t nameWidth = 0;
+			for (const auto& interval : sorted) {
+				nameWidth = std::max(nameWidth, interval.name.size());
+			}
+
+			for (const auto& interval : sorted) {
+				const double begin = toMilliseconds(interval.begin), end = toMilliseconds(interval.end);
+				const auto firstColumn = static_cast<size_t>(begin / total * width);
+				const auto lastColumn = std::max(firstColumn + 1, static_cast<size_t>(end / total * width));
+				out << "\n" << std::left << std::setw(nameWidth) << interval.name << std::right << std::fixed << std::setprecision(1)
+					<< std::setw(9) << begin << " -" << std::setw(9) << end << " ms |"
+					<< std::string(firstColumn, ' ') << std::string(lastColumn - firstColumn, '#') << std::string(width - std::min(width, lastColumn), ' ') << "|";
+			}
+		}
+
+
+	private:
+
+		struct Interval {
+			std::string name;
+			Clock::time_point begin;
+			Clock::time_point end;
+		};
+
+
+		double toMilliseconds(Clock::time_point time) const {
+			return std::chrono::duration<double, std::milli>(time - origin).count();
+		}
+
+
+		const Clock::time_point origin;
+		mutable std::mutex mutex;
+		std::vector<Interval> intervals;
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef VULKAN_TRACER
+#define VULKAN_TRACER
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+
+
+/**
+ * @brief Records a zone named name (a string literal) from this line to the end of the enclosing scope.
+ * @details Zones are recorded only if VULKAN_TRACING is defined; otherwise the macro expands to nothing, so tracing costs nothing.
+ */
+#ifdef VULKAN_TRACING
+#define VULKAN_TRACE_CONCAT_IMPL(a, b) a##b
+#define VULKAN_TRACE_CONCAT(a, b) VULKAN_TRACE_CONCAT_IMPL(a, b)
+#define VULKAN_TRACE_ZONE(name) const Vulkan::Utilities::TraceZone VULKAN_TRACE_CONCAT(traceZone, __LINE__){ name }
+#else
+#define VULKAN_TRACE_ZONE(name)
+#endif
+
+
+namespace Vulkan::Utilities {
+
+	/**
+	 * @brief Records the zones (named intervals of time) of every thread, and exports them as a Chrome trace (to be opened with chrome://tracing or ui.perfetto.dev).
+	 * @details Each thread records into its own ring buffer, so threads never wait for each other while recording, and only the most recent EVENTS_PER_THREAD zones of each thread are kept.
+	 *			The buffers outlive their threads, so the zones of a thread which has ended can still be exported.
+	 *			The tracer is also a JobObserver: attached to a JobSystem, it records a zone for each job.
+	 */
+	class Tracer : public JobObserver {
+	public:
+
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr size_t EVENTS_PER_THREAD = 1 << 16; //power of 2
+
+
+		/**
+		 * @brief Returns the tracer of the process.
+		 */
+		static Tracer& get() {
+			static Tracer tracer;
+			return tracer;
+		}
+
+		Tracer(const Tracer&) = delete;
+		Tracer& operator=(const Tracer&) = delete;
+
+
+
+		/**
+		 * @brief Records a zone of the calling thread.
+		 *
+		 * @param name The name of the zone. It must outlive the tracer (e.g. a string literal).
+		 */
+		void record(const char* name, Clock::time_point begin, Clock::time_point end) {
+			getThreadBuffer().push(name, toNanoseconds(begin), toNanoseconds(end));
+		}
+
+
+		/**
+		 * @brief Sets the name the calling thread has in the trace (by default "thread" followed by a number).
+		 */
+		void setThreadName(const std::string& name) {
+			auto& buffer = getThreadBuffer();
+			std::lock_guard lock{ buffersMutex };
+			buffer.name = name;
+		}
+
+
+		void onJobBegin(const char*, unsigned int) override { //the name is recorded when the job ends
+			auto& buffer = getThreadBuffer();
+			if (buffer.depth < buffer.open.size()) {
+				buffer.open[buffer.depth] = toNanoseconds(Clock::now());
+			}
+			buffer.depth++;
+		}
+
+		void onJobEnd(const char* name, unsigned int) override { //each thread has its own buffer
+			auto& buffer = getThreadBuffer();
+			buffer.depth--;
+			if (buffer.depth < buffer.open.size()) {
+				buffer.push(name, buffer.open[buffer.depth], toNanoseconds(Clock::now()));
+			}
+		}
+
+
+
+		/**
+		 * @brief Writes the zones recorded till now as a Chrome trace (JSON). It can be called while the other threads are recording.
+		 *
+		 * @return The number of zones written.
+		 */
+		size_t exportChromeTrace(const std::string& path) const {
+			std::ofstream out{ path };
+			if (!out) {
+				throw std::runtime_error{ "Failed to open " + path };
+			}
+
+			size_t zones = 0;
+			out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+			out << std::fixed << std::setprecision(3);
+
+			std::lock_guard lock{ buffersMutex };
+			bool first = true;
+			for (const auto& buffer : buffers) {
+				out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"" << escape(buffer->name.c_str()) << "\"}}";
+				first = false;
+
+				for (const auto& event : buffer->read()) {
+					out << ",\n{\"name\":\"" << escape(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":" << event.begin / 1000.0 << ",\"dur\":" << (event.end - event.begin) / 1000.0 << "}";
+					zones++;
+				}
+			}
+			out << "\n]}\n";
+
+			if (!out) {
+				throw std::runtime_error{ "Failed to write " + path };
+			}
+			return zones;
+		}
+
+
+	private:
+
+		Tracer() : epoch{ Clock::now() } {}
+
+
+		struct Event {
+			const char* name;
+			int64_t begin; //nanoseconds since the creation of the tracer
+			int64_t end;
+		};
+
+
+		//the zones of a thread, written only by that thread and read by the thread which exports them
+		class ThreadBuffer {
+		public:
+			ThreadBuffer(uint32_t id) : id{ id }, name{ "thread " + std::to_string(id) }, slots{ std::make_unique<Slot[]>(EVENTS_PER_THREAD) } {}
+
+			void push(const char* name, int64_t begin, int64_t end) {
+				auto index = written.load(std::memory_order_relaxed);
+				auto& slot = slots[index & (EVENTS_PER_THREAD - 1)];
+				std::atomic_thread_fence(std::memory_order_release); //a reader which sees any of the new values sees the counter of the overwritten event too (see read)
+				slot.name.store(name, std::memory_order_relaxed);
+				slot.begin.store(begin, std::memory_order_relaxed);
+				slot.end.store(end, std::memory_order_relaxed);
+				written.store(index + 1, std::memory_order_release);
+			}
+
+			//the events which are not being overwritten, oldest first
+			std::vector<Event> read() const {
+				const auto last = written.load(std::memory_order_acquire);
+				const auto first = last > EVENTS_PER_THREAD ? last - EVENTS_PER_THREAD : 0;
+				std::vector<Event> res;
+				res.reserve(last - first);
+				for (auto i = first; i < last; ++i) {
+					const auto& slot = slots[i & (EVENTS_PER_THREAD - 1)];
+					res.push_back(Event{ slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed) });
+				}
+
+				//the events the thread started to overwrite while they were read are discarded
+				std::atomic_thread_fence(std::memory_order_acquire);
+				const auto now = written.load(std::memory_order_relaxed);
+				const auto valid = now + 1 > EVENTS_PER_THREAD ? now + 1 - EVENTS_PER_THREAD : 0;
+				if (valid > first) {
+					res.erase(res.begin(), res.begin() + std::min<size_t>(valid - first, res.size()));
+				}
+				return res;
+			}
+
+			const uint32_t id;
+			std::string name; //protected by the mutex of the tracer
+			std::array<int64_t, 32> open{}; //beginning of the jobs being run, innermost last
+			size_t depth = 0;
+
+		private:
+			struct Slot {
+				std::atomic<const char*> name{ nullptr };
+				std::atomic<int64_t> begin{ 0 };
+				std::atomic<int64_t> end{ 0 };
+			};
+
+			std::unique_ptr<Slot[]> slots;
+			std::atomic<uint64_t> written{ 0 };
+		};
+
+
+
+		ThreadBuffer& getThreadBuffer() {
+			if (threadBuffer == nullptr) {
+				std::lock_guard lock{ buffersMutex };
+				buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(buffers.size())));
+				threadBuffer = buffers.back().get();
+			}
+			return *threadBuffer;
+		}
+
+
+		int64_t toNanoseconds(Clock::time_point time) const {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch).count();
+		}
+
+
+		static std::string escape(const char* text) {
+			std::string res;
+			for (; text != nullptr && *text != '\0'; ++text) {
+				if (*text == '"' || *text == '\\') {
+					res += '\\';
+				}
+				res += *text;
+			}
+			return res;
+		}
+
+
+
+		static inline thread_local ThreadBuffer* threadBuffer = nullptr; //there is a single tracer, so the buffer of a thread doesn't depend on the tracer
+
+		const Clock::time_point epoch;
+		mutable std::mutex buffersMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	};
+
+
+
+	/**
+	 * @brief Records a zone from its creation to its destruction. Use VULKAN_TRACE_ZONE, so that the zone is compiled out when tracing is disabled.
+	 */
+	class TraceZone {
+	public:
+		TraceZone(const char* name) : name{ name }, begin{ Tracer::Clock::now() } {}
+
+		~TraceZone() {
+			Tracer::get().record(name, begin, Tracer::Clock::now());
+		}
+
+		TraceZone(const TraceZone&) = delete;
+		TraceZone& operator=(const TraceZone&) = delete;
+
+	private:
+		const char* name;
+		Tracer::Clock::time_point begin;
+	};
+
+}
+
+
+#endif
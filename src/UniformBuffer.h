@@ -14,10 +14,13 @@ namespace Vulkan::Buffers { class UniformBuffer; }
 
 /**
  * @brief This buffer is used to store the uniform data (such as matrices) to be used by the shaders in the GPU.
+ * @details The buffer is mapped for its whole lifetime, so filling it is a memcpy. Coherent memory is preferred; if the GPU has only non-coherent host visible memory, the writes must be flushed (the sets flush the buffer after filling it).
  */
 class Vulkan::Buffers::UniformBuffer : public Buffer {
 public:
-	UniformBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {}
+	UniformBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT }, VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_COHERENT_BIT }) {
+		mapPersistently();
+	}
 
 
 
@@ -25,17 +28,28 @@ public:
 	 * @brief Fills the buffer with the specified data.
 	 * @details Each argument vector is padded. The minimum alignment of the GPU used to build this buffer is used. 
 	 *			For example if the alignment is 4 and the arguments are {2, 2, 2}, {3, 3} then the buffer will have this layout: {2, 2, 2, 0, 3, 3, 0, 0}.
+	 *			The data is visible to the GPU after the next flush (if the memory is coherent, immediately).
+	 *			The offset is relative to the current region (see getRegionOffset).
 	 * 
 	 * @param ...data floats to insert into the buffer.
 	 */
 	template<typename D>
 	void fillBuffer(const D& data, int offset = 0) {
-		void* rawData;
-		vkMapMemory(+virtualGpu, bufferMemory, offset, sizeof(D), 0, &rawData);
-		memcpy(rawData, &data, sizeof(D));
-		vkUnmapMemory(+virtualGpu, bufferMemory);
+		write(&data, sizeof(D), regionOffset + offset);
 	}
 
+
+	/**
+	 * @brief Returns the offset of the region written by fillBuffer and read by the GPU in the current frame: always 0, unless the buffer is a FrameRingBuffer.
+	 * @details The descriptors of the sets point at the first region, and the sets add this offset to the dynamic offsets when their descriptors are bound.
+	 */
+	uint32_t getRegionOffset() const {
+		return regionOffset;
+	}
+
+
+protected:
+	uint32_t regionOffset = 0;
 };
 
 #endif
\ No newline at end of file
@@ -4,8 +4,12 @@
 #include <vector>
 #include <variant>
 #include <typeinfo>
+#include <chrono>
+#include <concepts>
 
 #include "Hitbox.h"
+#include "PhysicsStats.h"
+#include "Tracer.h"
 
 
 namespace Vulkan::Physics {
@@ -30,6 +34,15 @@ namespace Vulkan::Physics {
 		}
 
 
+		/**
+		 * @brief Builds an isolated Universe whose bodies are known only at run-time (e.g. loaded from a table file).
+		 *
+		 * @param fields Vector containing all of the fields acting in this universe.
+		 * @param bodies Objects which can interact among them and with the fields in the universe.
+		 */
+		Universe(std::vector<Field*> fields, std::vector<Hitbox*> bodies) : bodies{ std::move(bodies) }, fields{ std::move(fields) } {}
+
+
 
 		/**
 		 * @brief Calculates the new position of all the objects in the universe, their interaction with the other objects and the fields.
@@ -37,6 +50,11 @@ namespace Vulkan::Physics {
 		 * @param elapsedSeconds Seconds elapsed from last calculation. 2 sequences of calls to calculate with the same elapsedSeconds is deterministic, but 2 sequences with different elapsedSeconds is not.
 		 */
 		void calculate(float elapsedSeconds) {
+			if (stats != nullptr) {
+				calculateInstrumented(elapsedSeconds);
+				return;
+			}
+
 			// 1. calculate forces for each object (i.e. fields)
 			calculateFieldForces();
 
@@ -48,6 +66,15 @@ namespace Vulkan::Physics {
 		}
 
 
+		/**
+		 * @brief Starts (or, with nullptr, stops) recording a TickRecord for each call to calculate.
+		 * @details The stats must outlive the universe, or be detached before being destroyed. They must be attached from the thread which calls calculate, or before that thread starts.
+		 */
+		void setStats(PhysicsStats* stats) {
+			this->stats = stats;
+		}
+
+
 		void addBody(Hitbox& body) {
 			bodies.push_back(&body);
 		}
@@ -61,6 +88,7 @@ namespace Vulkan::Physics {
 
 		//Calculates the forces applied by the fields on the objects.
 		void calculateFieldForces() {
+			VULKAN_TRACE_ZONE("Universe::fields");
 			for (auto body : bodies) {
 				for (auto field : fields) {
 					body->addExternalForce(field->calculateAppliedForce(*body));
@@ -69,8 +97,53 @@ namespace Vulkan::Physics {
 		}
 
 
+		//The same of calculate, but each phase is timed and the record is pushed to the stats.
+		void calculateInstrumented(float elapsedSeconds) {
+			using Clock = std::chrono::steady_clock;
+			TickRecord record{};
+			record.elapsedSeconds = elapsedSeconds;
+			record.bodies = static_cast<uint32_t>(bodies.size());
+
+			auto start = Clock::now();
+			calculateFieldForces();
+			auto fieldsEnd = Clock::now();
+			auto collisions = collisionDetection(elapsedSeconds);
+			auto collisionsEnd = Clock::now();
+			applyForces(elapsedSeconds);
+			auto end = Clock::now();
+
+			record.pairTests = collisions.pairTests;
+			record.contacts = collisions.contacts;
+			record.callbacks = collisions.callbacks;
+			record.bodiesIntegrated = static_cast<uint32_t>(bodies.size());
+			record.fieldsTime = fieldsEnd - start;
+			record.collisionsTime = collisionsEnd - fieldsEnd;
+			record.integrationTime = end - collisionsEnd;
+			record.totalTime = end - start;
+			stats->push(record);
+		}
+
+
+		struct CollisionCounters {
+			uint32_t pairTests = 0;
+			uint32_t contacts = 0;
+			uint32_t callbacks = 0;
+
+			//counts a test between 2 bodies and, if they collided, the actions their notification called
+			void test(const Hitbox& a, const Hitbox& b, bool collided) {
+				pairTests++;
+				if (collided) {
+					contacts++;
+					callbacks += a.hasCollisionAction() + b.hasCollisionAction();
+				}
+			}
+		};
+
+
 		//Detects if there is any collision between 2 objects and in case resolves such collision.
-		void collisionDetection(Time elapsedSeconds) {
+		CollisionCounters collisionDetection(Time elapsedSeconds) {
+			VULKAN_TRACE_ZONE("Universe::collisions");
+			CollisionCounters counters{};
 			for (int i = 0; i < bodies.size(); ++i) {
 				for (int j = i + 1; j < bodies.size(); ++j) {
 					//if only C++ had multiple dynamic dispatch we wouldn't have to do this shit. Visitor is even worse.
@@ -79,29 +152,47 @@ namespace Vulkan::Physics {
 					if (typeid(*bodies[i]) == typeid(CircleHitbox) && typeid(*bodies[j]) == typeid(CircleHitbox)) {
 						CircleHitbox& c1 = static_cast<CircleHitbox&>(*bodies[i]);
 						CircleHitbox& c2 = static_cast<CircleHitbox&>(*bodies[j]);
-						collisionDetection(c2, c1, elapsedSeconds);
+						counters.test(*bodies[i], *bodies[j], collisionDetection(c2, c1, elapsedSeconds));
 					}
 
 					//frame - circle collision
 					else if (typeid(*bodies[i]) == typeid(FrameHitbox) && typeid(*bodies[j]) == typeid(CircleHitbox)) {
 						FrameHitbox& f1 = static_cast<FrameHitbox&>(*bodies[i]);
 						CircleHitbox& c2 = static_cast<CircleHitbox&>(*bodies[j]);
-						collisionDetection(f1, c2, elapsedSeconds);
+						counters.test(*bodies[i], *bodies[j], collisionDetection(f1, c2, elapsedSeconds));
 					}	
 
 					//circle - frame collision
 					else if (typeid(*bodies[i]) == typeid(CircleHitbox) && typeid(*bodies[j]) == typeid(FrameHitbox)) {
 						CircleHitbox& c1 = static_cast<CircleHitbox&>(*bodies[i]);
 						FrameHitbox& f2 = static_cast<FrameHitbox&>(*bodies[j]);
-						collisionDetection(f2, c1, elapsedSeconds);
+						counters.test(*bodies[i], *bodies[j], collisionDetection(f2, c1, elapsedSeconds));
+					}
+
+					//capsule - circle collision
+					else if (typeid(*bodies[i]) == typeid(CapsuleHitbox) && typeid(*bodies[j]) == typeid(CircleHitbox)) {
+						counters.test(*bodies[i], *bodies[j], collisionDetection(static_cast<CapsuleHitbox&>(*bodies[i]), static_cast<CircleHitbox&>(*bodies[j]), elapsedSeconds));
+					}
+					else if (typeid(*bodies[i]) == typeid(CircleHitbox) && typeid(*bodies[j]) == typeid(CapsuleHitbox)) {
+						counters.test(*bodies[i], *bodies[j], collisionDetection(static_cast<CapsuleHitbox&>(*bodies[j]), static_cast<CircleHitbox&>(*bodies[i]), elapsedSeconds));
+					}
+
+					//polygon - circle collision
+					else if (typeid(*bodies[i]) == typeid(ConvexPolygonHitbox) && typeid(*bodies[j]) == typeid(CircleHitbox)) {
+						counters.test(*bodies[i], *bodies[j], collisionDetection(static_cast<ConvexPolygonHitbox&>(*bodies[i]), static_cast<CircleHitbox&>(*bodies[j]), elapsedSeconds));
+					}
+					else if (typeid(*bodies[i]) == typeid(CircleHitbox) && typeid(*bodies[j]) == typeid(ConvexPolygonHitbox)) {
+						counters.test(*bodies[i], *bodies[j], collisionDetection(static_cast<ConvexPolygonHitbox&>(*bodies[j]), static_cast<CircleHitbox&>(*bodies[i]), elapsedSeconds));
 					}
 				}
 			}
+			return counters;
 		}
 
 
 		//Applies all of the forces calculated till now.
 		void applyForces(Time elapsedSeconds) {
+			VULKAN_TRACE_ZONE("Universe::integration");
 			for (auto body : bodies) {
 				body->move(elapsedSeconds);
 			}
@@ -109,8 +200,8 @@ namespace Vulkan::Physics {
 
 
 
-		//Collider between 2 circles
-		static void collisionDetection(CircleHitbox& c1, CircleHitbox& c2, Time elapsedSeconds) {
+		//Collider between 2 circles, returns whether they collided
+		static bool collisionDetection(CircleHitbox& c1, CircleHitbox& c2, Time elapsedSeconds) {
 			auto distance = c1.getPosition() - c2.getPosition();
 			if ( distance <= c1.getRadius() + c2.getRadius()) {
 				//get speeds and masses (to simplify the writing of the equation
@@ -122,16 +213,19 @@ namespace Vulkan::Physics {
 				auto impulse = float((s2 - s1) * n * (-e - 1) * ((m1 * m2) / (m1 + m2)));
 				impulse *= 1.01; //FIXTHIS to avoid compenetration due to rounding errors
 
-				c1.addExternalForce(-(impulse * n) / elapsedSeconds);
-				c2.addExternalForce((impulse * n) / elapsedSeconds);
+				c1.addExternalForce(Impulse{ -(impulse * n) } / elapsedSeconds);
+				c2.addExternalForce(Impulse{ impulse * n } / elapsedSeconds);
 
 				c1.onCollision(c2);
 				c2.onCollision(c1);
+				return true;
 			}
+			return false;
 		}
 
 
-		static void collisionDetection(FrameHitbox& f, CircleHitbox& c, Time elapsedSeconds) {
+		//Collider between a frame and a circle, returns whether they collided
+		static bool collisionDetection(FrameHitbox& f, CircleHitbox& c, Time elapsedSeconds) {
 			bool haveCollided = false; //turns true when at least one segment collided with the circle
 			
 			for (int i = 0; i < f.getNumberOfSegments(); ++i) {
@@ -151,8 +245,8 @@ namespace Vulkan::Physics {
 					auto massCoefficient = (m1 * m2) / (m1 + m2);
 					auto impulse = float(((s2 + tangentialSpeed - s1) * n) * (-e - 1) * massCoefficient);
 
-					f.addExternalForce((impulse * glm::vec3(n)) / elapsedSeconds); //rotational speed of the frame is not affected (simplification that can create problems)
-					c.addExternalForce(-(impulse * glm::vec3(n)) / elapsedSeconds);
+					f.addExternalForce(Impulse{ impulse * glm::vec3(n) } / elapsedSeconds); //rotational speed of the frame is not affected (simplification that can create problems)
+					c.addExternalForce(Impulse{ -(impulse * glm::vec3(n)) } / elapsedSeconds);
 
 					haveCollided = true;
 				}
@@ -162,6 +256,43 @@ namespace Vulkan::Physics {
 				f.onCollision(c);
 				c.onCollision(f);
 			}
+			return haveCollided;
+		}
+
+
+		//Collider between a closed shape (a capsule or a convex polygon) and a circle, returns whether they collided
+		template<typename Shape> requires std::same_as<Shape, CapsuleHitbox> || std::same_as<Shape, ConvexPolygonHitbox>
+		static bool collisionDetection(Shape& shape, CircleHitbox& c, Time elapsedSeconds) {
+			auto contact = shape.contact(c.getPosition(), c.getRadius());
+			if (!contact) {
+				return false;
+			}
+
+			//get speeds and masses (to simplify the writing of the equation
+			auto s1 = c.getSpeed(); auto s2 = shape.getSpeed();
+			auto m1 = c.getMass(); auto m2 = shape.getMass();
+			float e = 1.0f; //we simulate an elastic collision for now. This can vary based on materials.
+			auto n = contact->normal; //pointing to the shape
+
+			//speed of the touched point of the shape, rotation included (angular speed around z times the arm, turned by 90 degrees)
+			glm::vec3 arm = contact->point - shape.getPosition();
+			auto pointSpeed = s2 + Speed{ glm::vec3{ -arm.y, arm.x, 0.0f } * shape.getAngularSpeed() };
+
+			//only if the circle is getting closer, otherwise the impulse would pull it back inside
+			if ((pointSpeed - s1) * n < 0.0f) {
+				auto massCoefficient = (m1 * m2) / (m1 + m2);
+				auto impulse = float(((pointSpeed - s1) * n) * (-e - 1) * massCoefficient);
+
+				shape.addExternalForce(Impulse{ impulse * glm::vec3(n) } / elapsedSeconds); //rotational speed of the shape is not affected (simplification that can create problems)
+				c.addExternalForce(Impulse{ -(impulse * glm::vec3(n)) } / elapsedSeconds);
+			}
+
+			//push the circle out of the shape: otherwise it can stay stuck between the shape and another obstacle (e.g. a raised flipper and the wall next to it), whose impulses keep cancelling each other out
+			c.translate(-(contact->depth * glm::vec3(n)));
+
+			shape.onCollision(c);
+			c.onCollision(shape);
+			return true;
 		}
 
 
@@ -169,6 +300,7 @@ namespace Vulkan::Physics {
 
 		std::vector<Hitbox*> bodies;
 		std::vector<Field*> fields;
+		PhysicsStats* stats = nullptr; //if not null, each tick is recorded
 
 	};
 }
@@ -0,0 +1,181 @@
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+#include "UploadContext.h"
+#include "CommandBuffer.h"
+#include "CommandBufferPool.h"
+#include "Fence.h"
+#include "Semaphore.h"
+#include "Image.h"
+#include "Queue.h"
+#include "QueueFamily.h"
+#include "Tracer.h"
+
+
+
+Vulkan::Buffers::UploadContext::UploadContext(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t stagingBufferSize) :
+    virtualGpu{ virtualGpu }, realGpu{ realGpu }, stagingBufferSize{ stagingBufferSize },
+    transferFamily{ static_cast<uint32_t>(virtualGpu[QueueFamily::TRANSFER].getFamilyIndex()) },
+    graphicsFamily{ static_cast<uint32_t>(virtualGpu[QueueFamily::GRAPHICS].getFamilyIndex()) },
+    transferPool{ std::make_unique<CommandBufferPool>(virtualGpu, QueueFamily::TRANSFER) }
+{
+    if (hasDedicatedTransferQueue()) {
+        graphicsPool = std::make_unique<CommandBufferPool>(virtualGpu, QueueFamily::GRAPHICS);
+    }
+}
+
+
+
+Vulkan::Buffers::UploadContext::~UploadContext() {
+    try {
+        wait(); //the GPU may still read the staging memory
+    }
+    catch (...) {} //the device is lost, so it won't read it any more
+}
+
+
+
+std::span<std::byte> Vulkan::Buffers::UploadContext::stage(const Image& destination, VkImageSubresourceLayers subresource, VkExtent3D extent, size_t size, VkImageLayout finalLayout) {
+    auto [source, sourceOffset, memory] = reserve(size);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = sourceOffset;
+    region.bufferRowLength = 0; //tightly packed
+    region.bufferImageHeight = 0;
+    region.imageSubresource = subresource;
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = extent;
+    imageCopies.push_back(ImageCopy{ source, +destination, region });
+
+    if (std::none_of(images.begin(), images.end(), [&destination](const StagedImage& image) { return image.image == +destination; })) {
+        images.push_back(StagedImage{ +destination, subresource.aspectMask, finalLayout });
+    }
+    return memory;
+}
+
+
+
+void Vulkan::Buffers::UploadContext::submit() {
+    if (bufferCopies.empty() && imageCopies.empty()) {
+        return;
+    }
+    VULKAN_TRACE_ZONE("UploadContext::submit");
+
+    //the barriers around the copies; with a dedicated transfer queue the ones after the copies release the ownership of the destinations to the graphics family, and are repeated on the graphics queue to acquire it
+    const bool transferOwnership = hasDedicatedTransferQueue();
+    const uint32_t sourceFamily = transferOwnership ? transferFamily : VK_QUEUE_FAMILY_IGNORED;
+    const uint32_t destinationFamily = transferOwnership ? graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+    const VkPipelineStageFlags readStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    const VkAccessFlags readAccesses = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+    std::vector<VkImageMemoryBarrier> toTransfer, imagesAfter;
+    for (const auto& image : images) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.image;
+        barrier.subresourceRange = VkImageSubresourceRange{ image.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; //the previous content is discarded
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        toTransfer.push_back(barrier);
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = image.finalLayout;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = transferOwnership ? 0 : VK_ACCESS_SHADER_READ_BIT;
+        barrier.srcQueueFamilyIndex = sourceFamily;
+        barrier.dstQueueFamilyIndex = destinationFamily;
+        imagesAfter.push_back(barrier);
+    }
+
+    std::vector<VkBufferMemoryBarrier> buffersAfter;
+    for (auto buffer : buffers) {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = transferOwnership ? 0 : readAccesses;
+        barrier.srcQueueFamilyIndex = sourceFamily;
+        barrier.dstQueueFamilyIndex = destinationFamily;
+        barrier.buffer = buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        buffersAfter.push_back(barrier);
+    }
+
+    //record the copies
+    Batch batch;
+    batch.transfer = std::make_unique<CommandBuffer>(virtualGpu, *transferPool);
+    if (!toTransfer.empty()) {
+        batch.transfer->addCommand(vkCmdPipelineBarrier, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+    }
+    for (const auto& copy : bufferCopies) {
+        batch.transfer->addCommand(vkCmdCopyBuffer, copy.source, copy.destination, 1, &copy.region);
+    }
+    for (const auto& copy : imageCopies) {
+        batch.transfer->addCommand(vkCmdCopyBufferToImage, copy.source, copy.destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+    }
+    batch.transfer->addCommand(vkCmdPipelineBarrier, VK_PIPELINE_STAGE_TRANSFER_BIT, transferOwnership ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : readStages, 0, 0, nullptr, static_cast<uint32_t>(buffersAfter.size()), buffersAfter.data(), static_cast<uint32_t>(imagesAfter.size()), imagesAfter.data())
+        .endCommand();
+
+    batch.done = std::make_unique<SynchronizationPrimitives::Fence>(virtualGpu);
+    vkResetFences(+virtualGpu, 1, &+*batch.done); //fences are created signaled
+
+    if (!transferOwnership) {
+        batch.transfer->sendCommand(virtualGpu[QueueFamily::TRANSFER], {}, {}, {}, *batch.done);
+    }
+    else {
+        //the graphics queue acquires the destinations once the copies are done
+        for (auto& barrier : imagesAfter) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        }
+        for (auto& barrier : buffersAfter) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = readAccesses;
+        }
+        batch.acquire = std::make_unique<CommandBuffer>(virtualGpu, *graphicsPool);
+        batch.acquire->addCommand(vkCmdPipelineBarrier, readStages, readStages, 0, 0, nullptr, static_cast<uint32_t>(buffersAfter.size()), buffersAfter.data(), static_cast<uint32_t>(imagesAfter.size()), imagesAfter.data())
+            .endCommand();
+
+        //the fence of the acquire tells when the copies are done too, since the acquire waits for them
+        batch.transferDone = std::make_unique<SynchronizationPrimitives::Semaphore>(virtualGpu);
+        const std::array<VkSemaphore, 1> semaphores{ +*batch.transferDone };
+        const std::array<VkPipelineStageFlags, 1> waitStages{ readStages };
+        batch.transfer->sendCommand(virtualGpu[QueueFamily::TRANSFER], {}, semaphores, {});
+        batch.acquire->sendCommand(virtualGpu[QueueFamily::GRAPHICS], semaphores, {}, waitStages, *batch.done);
+    }
+
+    batch.stagingBuffers = std::move(stagingBuffers);
+    inFlight.push_back(std::move(batch));
+    submissions++;
+
+    stagingBuffers.clear();
+    used = 0;
+    bufferCopies.clear();
+    imageCopies.clear();
+    buffers.clear();
+    images.clear();
+}
+
+
+
+bool Vulkan::Buffers::UploadContext::collect() {
+    std::erase_if(inFlight, [this](const Batch& batch) { return vkGetFenceStatus(+virtualGpu, +*batch.done) == VK_SUCCESS; });
+    return inFlight.empty();
+}
+
+
+
+void Vulkan::Buffers::UploadContext::wait() {
+    for (const auto& batch : inFlight) {
+        if (VkResult result = vkWaitForFences(+virtualGpu, 1, &+*batch.done, VK_TRUE, UINT64_MAX); result != VK_SUCCESS) {
+            throw VulkanException{ "Failed to wait for the uploads", result };
+        }
+    }
+    inFlight.clear();
+}
@@ -0,0 +1,220 @@
+#ifndef VULKAN_UPLOADCONTEXT
+#define VULKAN_UPLOADCONTEXT
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "VulkanException.h"
+#include "Buffer.h"
+#include "StagingBuffer.h"
+
+
+namespace Vulkan {
+    class CommandBuffer; class CommandBufferPool; class Image;
+    namespace SynchronizationPrimitives { class Fence; class Semaphore; }
+    namespace Buffers { class UploadContext; }
+}
+
+/**
+ * @brief Collects the data to copy into device local buffers and images, and copies all of it with a single submission, without waiting for it.
+ * @details The data is written into staging buffers which are mapped for their whole lifetime and shared by many uploads (a new one is created only when the current one is full), so staging some data is a memcpy, without calling the driver.
+ *          Nothing reaches the destinations before submit, which records all the copies and the layout transitions of the images in one command buffer, and submits it to the transfer queue.
+ *          If the transfer queue belongs to its own family (a copy engine, which works while the graphics queue renders), the ownership of the destinations is released by the transfer queue and acquired by the graphics queue, in a second command buffer which waits for the copies on a semaphore.
+ *          Either way the uploads are complete for any command submitted to the graphics queue after submit, so the resources can be drawn right away.
+ *          A fence tells when the GPU is done with a submission: its staging buffers are released by the first collect (or wait) after that.
+ */
+class Vulkan::Buffers::UploadContext {
+public:
+
+    /**
+     * @param stagingBufferSize The size of each staging buffer. Larger uploads get a staging buffer of their own size.
+     */
+    UploadContext(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t stagingBufferSize = 4 << 20);
+
+    UploadContext(const UploadContext&) = delete;
+    UploadContext& operator=(const UploadContext&) = delete;
+
+    /**
+     * @brief Waits for the submissions which are still running.
+     */
+    ~UploadContext();
+
+
+    /**
+     * @brief Reserves size bytes of staging memory, which the next submit copies into destination, at offset.
+     *
+     * @return The staging memory, where the caller writes the data. It is valid till the next submit.
+     */
+    std::span<std::byte> stage(const Buffer& destination, size_t size, size_t offset = 0) {
+        if (offset + size > destination.getSize()) {
+            throw VulkanException{ "Failed to stage the upload", "The data goes past the end of the destination buffer" };
+        }
+        if (size == 0) {
+            return {};
+        }
+
+        auto [source, sourceOffset, memory] = reserve(size);
+        bufferCopies.push_back(BufferCopy{ source, +destination, VkBufferCopy{ sourceOffset, offset, size } });
+        if (std::find(buffers.begin(), buffers.end(), +destination) == buffers.end()) {
+            buffers.push_back(+destination);
+        }
+        return memory;
+    }
+
+
+    /**
+     * @brief Stages a copy of size bytes of data, which the next submit copies into destination, at offset.
+     */
+    void upload(const Buffer& destination, const void* data, size_t size, size_t offset = 0) {
+        auto memory = stage(destination, size, offset);
+        if (!memory.empty()) {
+            memcpy(memory.data(), data, size);
+        }
+    }
+
+
+    /**
+     * @brief Reserves size bytes of staging memory, which the next submit copies into a subresource (e.g. a mip level) of destination, tightly packed.
+     * @details The first time an image is staged, its previous content is discarded; after the copies the whole image is moved to finalLayout.
+     *
+     * @return The staging memory, where the caller writes the texels. It is valid till the next submit.
+     */
+    std::span<std::byte> stage(const Image& destination, VkImageSubresourceLayers subresource, VkExtent3D extent, size_t size, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+
+    /**
+     * @brief Records all the staged copies in one command buffer and submits it, without waiting for the GPU.
+     * @details The staging buffers are kept alive till the GPU is done with them (see collect).
+     */
+    void submit();
+
+
+    /**
+     * @brief Releases the staging buffers of the submissions the GPU has finished. It doesn't wait.
+     *
+     * @return Whether all the submissions have finished.
+     */
+    bool collect();
+
+
+    /**
+     * @brief Waits for all the submissions, then releases their staging buffers.
+     */
+    void wait();
+
+
+    /**
+     * @brief Returns whether the transfers run on a queue family of their own, rather than on the graphics one.
+     */
+    bool hasDedicatedTransferQueue() const {
+        return transferFamily != graphicsFamily;
+    }
+
+
+    /**
+     * @brief Returns how many copies the next submit will record.
+     */
+    size_t getPendingCopies() const {
+        return bufferCopies.size() + imageCopies.size();
+    }
+
+
+    /**
+     * @brief Returns how many bytes have been staged since the creation of the context.
+     */
+    size_t getStagedBytes() const {
+        return stagedBytes;
+    }
+
+
+    /**
+     * @brief Returns how many submissions have been made since the creation of the context.
+     */
+    unsigned int getSubmissions() const {
+        return submissions;
+    }
+
+
+private:
+
+    struct BufferCopy {
+        VkBuffer source;
+        VkBuffer destination;
+        VkBufferCopy region;
+    };
+
+    struct ImageCopy {
+        VkBuffer source;
+        VkImage destination;
+        VkBufferImageCopy region;
+    };
+
+    struct StagedImage {
+        VkImage image;
+        VkImageAspectFlags aspect;
+        VkImageLayout finalLayout;
+    };
+
+    struct Reservation {
+        VkBuffer source;
+        VkDeviceSize offset;
+        std::span<std::byte> memory;
+    };
+
+    //a submission the GPU may still be running, with everything it uses
+    struct Batch {
+        std::vector<std::unique_ptr<StagingBuffer>> stagingBuffers;
+        std::unique_ptr<CommandBuffer> transfer;
+        std::unique_ptr<CommandBuffer> acquire; //only if the transfer queue has its own family
+        std::unique_ptr<SynchronizationPrimitives::Semaphore> transferDone; //only if the transfer queue has its own family
+        std::unique_ptr<SynchronizationPrimitives::Fence> done;
+    };
+
+
+    //reserves size bytes in the current staging buffer, or in a new one if it is full
+    Reservation reserve(size_t size) {
+        if (stagingBuffers.empty() || used + size > stagingBuffers.back()->getSize()) {
+            stagingBuffers.push_back(std::make_unique<StagingBuffer>(virtualGpu, realGpu, std::max(size, stagingBufferSize)));
+            used = 0;
+        }
+        auto& stagingBuffer = *stagingBuffers.back();
+
+        Reservation reservation{ +stagingBuffer, used, stagingBuffer.getMappedMemory().subspan(used, size) };
+        used = (used + size + COPY_ALIGNMENT - 1) / COPY_ALIGNMENT * COPY_ALIGNMENT;
+        stagedBytes += size;
+        return reservation;
+    }
+
+
+    static constexpr size_t COPY_ALIGNMENT = 16; //each upload starts at an offset aligned to this, which suits any vertex, index or texel block
+
+    const LogicalDevice& virtualGpu;
+    const PhysicalDevice& realGpu;
+    const size_t stagingBufferSize;
+    const uint32_t transferFamily;
+    const uint32_t graphicsFamily;
+    std::unique_ptr<CommandBufferPool> transferPool;
+    std::unique_ptr<CommandBufferPool> graphicsPool; //only if the transfer queue has its own family
+
+    std::vector<std::unique_ptr<StagingBuffer>> stagingBuffers; //the last one is the one uploads are staged in
+    size_t used = 0; //bytes of the last staging buffer already staged
+    std::vector<BufferCopy> bufferCopies;
+    std::vector<ImageCopy> imageCopies;
+    std::vector<VkBuffer> buffers; //the destinations of bufferCopies, once each
+    std::vector<StagedImage> images; //the destinations of imageCopies, once each
+
+    std::vector<Batch> inFlight;
+
+    size_t stagedBytes = 0;
+    unsigned int submissions = 0;
+};
+
+
+#endif
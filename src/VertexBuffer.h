@@ -2,13 +2,17 @@
 #define VULKAN_VERTEXBUFFER
 
 #include <vulkan/vulkan.h>
+#include <algorithm>
+#include <string>
 
 #include "LogicalDevice.h"
 #include "PhysicalDevice.h"
 #include "VulkanException.h"
 #include "VertexInput.h"
 #include "Buffer.h"
+#include "UploadContext.h"
 #include "Model.h"
+#include "Tracer.h"
 
 
 namespace Vulkan::Buffers { class VertexBuffer; }
@@ -16,25 +20,51 @@ namespace Vulkan::Buffers { class VertexBuffer; }
 class Vulkan::Buffers::VertexBuffer : public Buffer{
 public:
 
-    VertexBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
-        
-	}
+    /**
+     * @brief Creates a streaming vertex buffer, in host visible memory mapped for the whole lifetime of the buffer, for vertices which change every frame.
+     * @details fillBuffer writes the vertices straight into the memory the GPU reads. As in a FrameRingBuffer, the buffer has a region for each frame in flight, so that the CPU fills the region of a frame while the GPU still reads the regions of the previous frames (see setFrame).
+     *
+     * @param regionSize The size of a region, i.e. of the vertices of a frame.
+     * @param framesInFlight The number of regions, as the frames in flight of the Drawer.
+     */
+    VertexBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t regionSize, unsigned int framesInFlight = 1) : Buffer(virtualGpu, realGpu, regionSize * framesInFlight, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT }, VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_COHERENT_BIT }), regionSize{ regionSize }, framesInFlight{ framesInFlight } {
+        mapPersistently();
+    }
+
+
+    /**
+     * @brief Creates a vertex buffer in device local memory, for static geometry.
+     * @details fillBuffer stages the vertices in uploadContext, so they reach the buffer when the context is submitted.
+     */
+    VertexBuffer(const LogicalDevice& virtualGpu, const PhysicalDevice& realGpu, size_t size, UploadContext& uploadContext) : Buffer(virtualGpu, realGpu, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT), uploadContext{ &uploadContext }, regionSize{ size } {
+
+    }
 
 
         template<typename... C, typename... S, template<typename, typename...> class... M> requires (std::same_as<M<PipelineOptions::Vertex<C...>, S...>, Objects::Model<PipelineOptions::Vertex<C...>, S...>> && ...)
     void fillBuffer(const M<PipelineOptions::Vertex<C...>, S...>&... models) {
-        std::vector<PipelineOptions::Vertex<C...>> data{};
-        (data.insert(data.end(), models.getVertices().begin(), models.getVertices().end()), ...); //copy all the vertices to one vector
-      
-        verticesCount = data.size();
+        using V = PipelineOptions::Vertex<C...>;
+        upload<V>((models.getVertices().size() + ...), [&models...](V* destination) {
+            ((destination = std::copy(models.getVertices().begin(), models.getVertices().end(), destination)), ...); //copy the vertices of each model after the ones of the previous model
+            });
+    }
 
-        //TODO staging buffer
 
-        //copy data to vertex buffer
-        void* rawData;
-        vkMapMemory(+virtualGpu, bufferMemory, 0, data.size() * sizeof(data[0]), 0, &rawData);
-        memcpy(rawData, data.data(), data.size() * sizeof(data[0]));
-        vkUnmapMemory(+virtualGpu, bufferMemory);
+    /**
+     * @brief Fills the buffer with the vertices of models whose number is known only at run-time (e.g. the models of a table file).
+     */
+    template<typename V, typename... S>
+    void fillBuffer(const std::vector<Objects::Model<V, S...>*>& models) {
+        size_t count = 0;
+        for (auto model : models) {
+            count += model->getVertices().size();
+        }
+
+        upload<V>(count, [&models](V* destination) {
+            for (auto model : models) {
+                destination = std::copy(model->getVertices().begin(), model->getVertices().end(), destination); //copy the vertices of each model after the ones of the previous model
+            }
+            });
     }
 
 
@@ -43,9 +73,55 @@ public:
     }
 
 
+    /**
+     * @brief Selects the region of a frame in flight: the next fillBuffer writes to it, and the Drawer binds it (see getRegionOffset).
+     * @details To be called when the GPU has finished the last frame which used the region, i.e. after Drawer::waitForFrame.
+     */
+    void setFrame(unsigned int frame) {
+        if (frame >= framesInFlight) {
+            throw VulkanException{ "Failed to select the region of the frame", "The buffer has " + std::to_string(framesInFlight) + " regions" };
+        }
+        regionOffset = frame * regionSize;
+    }
+
+
+    /**
+     * @brief Returns the offset of the region written by fillBuffer and read by the GPU in the current frame: always 0, unless the buffer has a region for each frame in flight.
+     */
+    VkDeviceSize getRegionOffset() const {
+        return regionOffset;
+    }
+
+
 private:
 
+    //lets write copy count vertices straight into the memory the GPU reads (streaming buffer) or into the staging memory (device local buffer), so that no intermediate vector is needed, since the point displayers are uploaded every frame
+    template<typename V, typename F>
+    void upload(size_t count, F&& write) {
+        VULKAN_TRACE_ZONE("VertexBuffer::fillBuffer");
+        verticesCount = count;
+
+        if (uploadContext != nullptr) {
+            write(reinterpret_cast<V*>(uploadContext->stage(*this, count * sizeof(V)).data()));
+            return;
+        }
+
+        if (count * sizeof(V) > regionSize) {
+            throw VulkanException{ "Failed to fill the vertex buffer", "The vertices don't fit in the buffer" };
+        }
+        write(reinterpret_cast<V*>(mapped + regionOffset));
+        if (!isCoherent()) {
+            dirtyRanges.add(regionOffset, count * sizeof(V));
+            flush();
+        }
+    }
+
+
+    UploadContext* uploadContext = nullptr; //if the buffer is device local
     unsigned int verticesCount;
+    size_t regionSize;
+    unsigned int framesInFlight = 1;
+    VkDeviceSize regionOffset = 0;
 };
 
 #endif
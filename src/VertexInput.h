@@ -282,6 +282,15 @@ namespace Vulkan::PipelineOptions {
 			}
 
 
+			/**
+			 * @brief Returns the I-th component of this vertex.
+			 */
+			template<size_t I>
+			const auto& get() const {
+				return std::get<I>(vertexComponents);
+			}
+
+
 			/**
 			 * @brief Returns the descriptors for this type of vertex, namely VkVertexInputBindingDescription and VkVertexInputAttributeDescription.
 			 *
@@ -1,9 +1,17 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 
 #include <vulkan/vulkan.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <span>
 #include <vector>
+#include <atomic>
 #include <chrono>
+#include <thread>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -11,34 +19,58 @@
 #include "Pinball.h"
 #include "Animations.h"
 #include "GameStatus.h"
+#include "Table.h"
+#include "TableModels.h"
+#include "PhysicsStats.h"
+#include "JobSystem.h"
+#include "Tracer.h"
+#include "FrameAllocator.h"
+#include "AllocationCounter.h"
+#include "Timeline.h"
+#include "TextureStreamer.h"
 
 
 
+const float FIELD_OF_VIEW_Y = 120.0f; //degrees
+
+//the constant_id of the specialization constants of the main fragment shader, which choose its lighting models (see FragmentShader.frag)
+const uint32_t DIFFUSE_MODEL_ID = 0; //constant_id of DIFFUSE_MODEL, whose values are 0: Lambert, 1: Toon
+const uint32_t SPECULAR_MODEL_ID = 1; //constant_id of SPECULAR_MODEL, whose values are 0: Blinn, 1: Toon, 2: Phong
+
+
 template<typename... Models>
-void calculateGraphics(Vulkan::Objects::Camera& camera, Vulkan::Buffers::UniformBuffer& mainPerObjectBuffer, const Vulkan::DynamicSet& mainPerObjectSet, Vulkan::Buffers::UniformBuffer& mainGlobalBuffer, const Vulkan::StaticSet& mainGlobalSet, Vulkan::Buffers::UniformBuffer& backgroundBuffer, const Vulkan::DynamicSet& backgroundSet, Vulkan::Buffers::VertexBuffer& backgroundVertexBuffer, const std::tuple<Models*...>& models, Lights& lights, Vulkan::Physics::Universe& universe, Vulkan::Physics::Universe& pullerUniverse, Vulkan::Utilities::KeyboardListener& keyboardController, float aspectRatio, int points);
+void calculateGraphics(Vulkan::Objects::Camera& camera, Vulkan::Buffers::UniformBuffer& mainPerObjectBuffer, const Vulkan::DynamicSet& mainPerObjectSet, Vulkan::Buffers::UniformBuffer& mainGlobalBuffer, const Vulkan::StaticSet& mainGlobalSet, Vulkan::Buffers::UniformBuffer& backgroundBuffer, const Vulkan::DynamicSet& backgroundSet, Vulkan::Buffers::VertexBuffer& backgroundVertexBuffer, const std::vector<Vulkan::Objects::Model<MyVertex>*>& tableModels, const std::tuple<Models*...>& backgroundModels, Lights& lights, const Vulkan::Physics::Table& table, Vulkan::Utilities::KeyboardListener& keyboardController, Vulkan::Utilities::JobSystem& jobs, Vulkan::Utilities::FrameAllocator& frameAllocator, float aspectRatio, int points);
+
+
+void calculatePhysics(const std::vector<Vulkan::Physics::Universe*>& universes, Vulkan::Utilities::KeyboardListener& kc, Vulkan::Physics::Hitbox& leftFlipper, Vulkan::Physics::Hitbox& rightFlipper, std::chrono::nanoseconds elapsedNanoseconds);
+
 
+float getTextureDensity(const Vulkan::Objects::Model<MyVertex>& model);
 
-void calculatePhysics(std::vector<Vulkan::Physics::Universe*> universes, Vulkan::Utilities::KeyboardListener& kc, Vulkan::Physics::Hitbox& leftFlipper, Vulkan::Physics::Hitbox& rightFlipper, std::chrono::nanoseconds elapsedNanoseconds);
 
+float estimateTextureSize(const Vulkan::Objects::Camera& camera, const std::vector<Vulkan::Objects::Model<MyVertex>*>& models, const std::vector<float>& textureDensities, float screenHeight);
 
-std::vector<MyVertex> buildPointDisplayerVertices(int digit) {
+
+//an array, since the vertices of the point displayers are rebuilt every frame
+std::array<MyVertex, 4> buildPointDisplayerVertices(int digit) {
 	const float xOffset = 0.001f; const float yOffset = 0.0f;
 	const float width = 0.07f; const float height = 1.0f/10.0f;
 
-	std::vector<MyVertex> pointDisplayerVertices{
+	std::array<MyVertex, 4> pointDisplayerVertices{ {
 	{{-0.5f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {xOffset 		, yOffset + height * digit + height }},
 	{{-0.5f,  1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {xOffset 		, yOffset + height * digit			}},
 	{{ 0.5f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {xOffset + width , yOffset + height * digit + height }},
 	{{ 0.5f,  1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {xOffset + width , yOffset + height * digit 			}}
-	};
+	} };
 
 	return pointDisplayerVertices;
 }
 
 
 
-int main() {
+int main(int argc, char* argv[]) {
 	try {
+		const std::string tablePath = argc > 1 ? argv[1] : "tables/reference.tbl"; //e.g. a stress table made by TableGenerator
 
 		// ================ GPU AND SWAPCHAIN SETUP ================
 		//GPU setup
@@ -83,23 +115,23 @@ int main() {
 			alignas(16) glm::mat4 normals;
 		};
 
-		//fill global set 
+		//fill global set (the positions of the point lights of the table are set by the table)
 		Lights lights{
 			//point (color, pos)
 			glm::vec3{0.0f, 0.0f, 0.0f}, //bumper1
-			glm::vec3{0.0f, 2.0f, 0.4f},
+			glm::vec3{0.0f, 0.0f, 0.0f},
 
 			glm::vec3{0.0f, 0.0f, 0.0f}, //bumper2
-			glm::vec3{1.0f, 1.0f, 0.4f},
+			glm::vec3{0.0f, 0.0f, 0.0f},
 
 			glm::vec3{0.0f, 0.0f, 0.0f}, //bumper3
-			glm::vec3{-1.0f, 1.0f, 0.4f},
+			glm::vec3{0.0f, 0.0f, 0.0f},
 
 			glm::vec3{0.0f, 0.0f, 0.0f}, //bumper4
-			glm::vec3{0.7f, 3.0f, 0.4f},
+			glm::vec3{0.0f, 0.0f, 0.0f},
 
 			glm::vec3{0.0f, 0.0f, 0.0f}, //bumper5
-			glm::vec3{-0.7f, 3.0f, 0.4f},
+			glm::vec3{0.0f, 0.0f, 0.0f},
 
 			glm::vec3{0.0f, 0.0f, 0.0f}, //ball1
 			glm::vec3{0.0f, 0.0f, 0.4f},
@@ -128,78 +160,53 @@ int main() {
 			glm::vec3{0.0f, 1.0f, 0.0f},
 
 			//eye
-			glm::vec3{0.0f, 0.0f, 2.0f},
-
-			//shaders to use
-			glm::vec2{0, 0}
-		};
-
-		//create models
-		Vulkan::Objects::Model ball1{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.162f, RESTING_BALLS_POSITION, 0.8f, 2.0f),
-			{ 0.0_deg, 180.0_deg, 0.0_deg }, MyVertex{}, "models/ball.obj"
-		};
-
-		Vulkan::Objects::Model ball2{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.162f, RESTING_BALLS_POSITION, 0.8f, 2.0f),
-			{ 0.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/ball.obj"
+			glm::vec3{0.0f, 0.0f, 2.0f}
 		};
 
-		Vulkan::Objects::Model ball3{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.162f, RESTING_BALLS_POSITION, 0.8f, 2.0f),
-			{ 0.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/ball.obj"
-		};
-
-		Vulkan::Objects::Model bumper1{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.376f, Vulkan::Physics::Position{lights.position0.x, lights.position0.y, 0.0f}, 0.8f),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/bumper.obj"
-		};
-
-		Vulkan::Objects::Model bumper2{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.376f, Vulkan::Physics::Position{lights.position1.x, lights.position1.y, 0.0f}, 0.8f),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/bumper.obj"
-		};
-
-		Vulkan::Objects::Model bumper3{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.376f, Vulkan::Physics::Position{lights.position2.x, lights.position2.y, 0.0f}, 0.8f),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/bumper.obj"
-		};
-
-		Vulkan::Objects::Model bumper4{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.376f, Vulkan::Physics::Position{lights.position3.x, lights.position3.y, 0.0f}, 0.8f),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/bumper.obj"
-		};
-
-		Vulkan::Objects::Model bumper5{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.376f, Vulkan::Physics::Position{lights.position4.x, lights.position4.y, 0.0f}, 0.8f),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/bumper.obj"
-		};
-
-
-		Vulkan::Objects::Model rightFlipper{ std::make_unique<Vulkan::Physics::FrameHitbox>(Vulkan::Physics::Position{1.35f, -4.7f, 0.0f}, 0.9f, Vulkan::Physics::Position{0.5f, 0.15f, 0.0f}, Vulkan::Physics::Position{-0.8f, 0.05f, 0.0f}),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/flipper.obj" 
-		};
-		rightFlipper.setKeyPressResponse(Vulkan::Animations::rightPadUp<MyVertex>);
-
-		Vulkan::Objects::Model leftFlipper{ std::make_unique<Vulkan::Physics::FrameHitbox>(Vulkan::Physics::Position{-0.8f, -4.7f, 0.0f}, 0.9f, Vulkan::Physics::Position{0.5f, -0.15f, 0.0f}, Vulkan::Physics::Position{-0.8f, -0.05f, 0.0f}),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/flipper.obj"
+		//jobs of the main thread (the physics has its own thread, so it gets its own core)
+		Vulkan::Utilities::JobSystem jobs{ std::max(3u, std::thread::hardware_concurrency()) - 2 };
+#ifdef VULKAN_TRACING
+		Vulkan::Utilities::Tracer::get().setThreadName("main");
+		jobs.setObserver(&Vulkan::Utilities::Tracer::get()); //each job is a zone
+#endif
+
+		//the phases of the startup, printed once the uploads are done
+		Vulkan::Utilities::Timeline startupTimeline;
+
+		//the low levels of the textures are loaded by the jobs, straight into the staging memory, while the models are loaded and the pipelines are created; they are submitted as soon as they are all loaded
+		//the high levels are streamed in by the frame loop, as far as they are seen and fit the budget (which is less than both textures at full resolution, so under pressure the skybox, with the lowest priority, gives up its finest level)
+		//the atlas needs the quality of BC7, the skybox is opaque and smooth, so BC1 (half the size) is enough
+		const VkDeviceSize TEXTURE_BUDGET = 7 << 20;
+		Vulkan::TextureStreamer textureStreamer{ virtualGpu, realGpu, jobs, TEXTURE_BUDGET };
+		Vulkan::Buffers::UploadContext textureUploads{ virtualGpu, realGpu };
+		Vulkan::Utilities::JobCounter textureLoads;
+		auto& mainTexture = textureStreamer.add(textureUploads, std::pair(2048, 2048), "textures/Mario_sat_eaeg.png", Vulkan::TextureFormat::Encoding::BC7, 1, textureLoads, &startupTimeline);
+		auto& backgroundTexture = textureStreamer.add(textureUploads, std::pair(2048, 2048), "textures/skybox.png", Vulkan::TextureFormat::Encoding::BC1, 0, textureLoads, &startupTimeline);
+
+		auto texturesSubmitted = Vulkan::Utilities::Timeline::Clock::time_point{};
+		auto submitDecodedTextures = [&](bool block) {
+			if (texturesSubmitted != Vulkan::Utilities::Timeline::Clock::time_point{} || !(block || textureLoads.isDone())) {
+				return;
+			}
+			jobs.wait(textureLoads); //rethrows the errors of the loads
+			const auto pendingCopies = textureUploads.getPendingCopies();
+			textureUploads.submit();
+			texturesSubmitted = Vulkan::Utilities::Timeline::Clock::now();
+			std::cout << "\nTexture uploads submitted: " << textureUploads.getStagedBytes() << " bytes, " << pendingCopies << " copies" << (textureUploads.hasDedicatedTransferQueue() ? " to a dedicated transfer queue" : "");
 		};
-		(+leftFlipper).rotate(180.0_deg, { 0.0f, 0.0f, 1.0f });
-		leftFlipper.setKeyPressResponse(Vulkan::Animations::leftPadUp<MyVertex>);
 
-
-		Vulkan::Objects::Model puller{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.05f, PULLER_RESTING_POSITION, 1.0f, 1.0f),
-			{ 180.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/puller.obj"
-		};
-		puller.setKeyPressResponse(Vulkan::Animations::pullerDown<MyVertex>);
-
-
-		Vulkan::Objects::Model body{ std::make_unique<Vulkan::Physics::FrameHitbox>(Vulkan::Physics::Position{0.0f, 0.0f, 0.0f}, 1.0f, 
-			Vulkan::Physics::Position{-0.949f, -5.950f, 0.0f}, 
-			Vulkan::Physics::Position{-0.949f, -4.127f, 0.0f}, 
-			Vulkan::Physics::Position{-2.386f, -3.277f, 0.0f},
-			Vulkan::Physics::Position{-2.386f,  4.076f, 0.0f}, 
-			Vulkan::Physics::Position{-0.640f,  5.447f, 0.0f}, 
-			Vulkan::Physics::Position{ 0.877f,  5.447f, 0.0f}, 
-			Vulkan::Physics::Position{ 2.700f,  4.076f, 0.0f}, 
-			Vulkan::Physics::Position{ 2.700f, -3.325f, 0.0f}, 
-			Vulkan::Physics::Position{ 1.525f, -4.127f, 0.0f}, 
-			Vulkan::Physics::Position{ 1.525f, -5.950f, 0.0f}, 
-			Vulkan::Physics::Position{-0.949f, -5.95f, 0.0f}),
-			{ 90.0_deg, 0.0_deg, 0.0_deg }, MyVertex{}, "models/body.obj"
-		};
+		//load the table and create its models (each model takes its hitbox from the table)
+		std::optional<Vulkan::Utilities::Timeline::Scope> loadingModels{ std::in_place, startupTimeline, "load models" };
+		Vulkan::Physics::TableFile tableFile{ tablePath };
+		Vulkan::Physics::Table table{ tableFile };
+		auto tableModelsOwner = Vulkan::Objects::loadTableModels<MyVertex>(table, jobs);
+		std::vector<Vulkan::Objects::Model<MyVertex>*> tableModels;
+		std::vector<float> tableTextureDensities; //how much of the atlas covers a unit of each model, to estimate the level of the atlas they are drawn with
+		for (auto& model : tableModelsOwner) {
+			tableModels.push_back(model.get());
+			tableTextureDensities.push_back(getTextureDensity(*model));
+		}
+		table.updateLights(lights);
 
 
 		Vulkan::Objects::Model skybox{ std::make_unique<Vulkan::Physics::CircleHitbox>(0.5f, Vulkan::Physics::Position{0.0f, -4.2f, 5.5f}, 1000.0f),
@@ -207,39 +214,33 @@ int main() {
 		};
 
 
-		Vulkan::Objects::Model point1{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {2.0f, 5.89f, 4.0f}, buildPointDisplayerVertices(0), std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
-		Vulkan::Objects::Model point10{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {0.6f, 5.89f, 4.0f}, buildPointDisplayerVertices(0), std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
-		Vulkan::Objects::Model point100{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {-0.6f, 5.89f, 4.0f}, buildPointDisplayerVertices(0), std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
-		Vulkan::Objects::Model point1000{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {-2.0f, 5.89f, 4.0f}, buildPointDisplayerVertices(0), std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
+		const auto digitVertices = buildPointDisplayerVertices(0);
+		const std::vector<MyVertex> pointDisplayerVertices{ digitVertices.begin(), digitVertices.end() };
+		Vulkan::Objects::Model point1{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {2.0f, 5.89f, 4.0f}, pointDisplayerVertices, std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
+		Vulkan::Objects::Model point10{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {0.6f, 5.89f, 4.0f}, pointDisplayerVertices, std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
+		Vulkan::Objects::Model point100{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {-0.6f, 5.89f, 4.0f}, pointDisplayerVertices, std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
+		Vulkan::Objects::Model point1000{ {95.0_deg, 0.0_deg, 0.0_deg}, 0.7f, {-2.0f, 5.89f, 4.0f}, pointDisplayerVertices, std::vector<uint32_t>{0, 2, 1, 2, 3, 1} };
+		loadingModels.reset();
+		submitDecodedTextures(false);
 
 
 
 		Vulkan::Objects::Camera camera{ DEFAULT_CAMERA_POSITION, DEFAULT_CAMERA_ANGLE };
 
 
-		Vulkan::Physics::FrameHitbox ballKiller{ Vulkan::Physics::Position{0.0f, -5.6f, 0.0f}, 1.0f, Vulkan::Physics::Position{-2.0f, 0.0f,0.0f}, Vulkan::Physics::Position{2.0f, 0.0f,0.0f} };
-		Vulkan::Physics::FrameHitbox gameStarter{ Vulkan::Physics::Position{2.5f, -5.95f, 0.0f}, 1.0f, Vulkan::Physics::Position{-2.0f, 0.0f,0.0f}, Vulkan::Physics::Position{2.0f, 0.0f,0.0f} };
-
-
-		Vulkan::Physics::Field gravity{ Vulkan::Physics::Position{1.0f, 0.0f, -2.0f}, Vulkan::Physics::FieldFunctions::gravity<20> };
-		Vulkan::Physics::Field friction{ Vulkan::Physics::Position{0.0f, 0.0f, -2.0f}, Vulkan::Physics::FieldFunctions::friction<2.0> };
-		Vulkan::Physics::Field pullerForce{ Vulkan::Physics::Position{PULLER_RESTING_POSITION}, Vulkan::Physics::FieldFunctions::centralField<PULLER_PULLUP_FORCE> };
-
-
-		
-		//add models to universe
-		Vulkan::Physics::Universe physicsUniverse{ std::vector<Vulkan::Physics::Field*>{&gravity, &friction}, +bumper1, +bumper2, +bumper3, +bumper4, +bumper5, +rightFlipper, +leftFlipper, +body, ballKiller};
-		Vulkan::Physics::Universe pullerUniverse{ std::vector<Vulkan::Physics::Field*>{&pullerForce}, gameStarter, +puller };
-
-
 		//add game status object
-		std::vector<Vulkan::Physics::Hitbox*> balls{ &(+ball1), &(+ball2), &(+ball3) };
-		std::vector<Vulkan::Physics::Hitbox*> bumpers{ &(+bumper1), &(+bumper2), &(+bumper3), &(+bumper4), &(+bumper5)};
-		GameStatus gameStatus{ balls, bumpers, lights, physicsUniverse };
+		GameStatus gameStatus{ table.getBalls(), table.getBumpers(), lights, table.getGameUniverse() };
+
 
+		//table controls
+		Vulkan::Utilities::ConcreteKeyboardObserver tableKeyboardObserver{ [&table](int keyPressed) {
+			Vulkan::Animations::controlTable(keyPressed, table.getLeftPad(), table.getRightPad(), table.getPuller(), table.getPullerRestingPosition());
+			} };
 
 		//additional keyboard observer (for actions not realted to a specific object)
-		Vulkan::Utilities::ConcreteKeyboardObserver additionalKeyboardObserver{ [&gameStatus, &camera, &lights](int keyPressed) {
+		std::atomic<bool> traceRequested{ false }; //the observers are called by the physics thread, the trace is exported by the draw cycle
+		std::atomic<bool> toonShading{ false }; //the pipeline is swapped by the draw cycle
+		Vulkan::Utilities::ConcreteKeyboardObserver additionalKeyboardObserver{ [&gameStatus, &camera, &traceRequested, &toonShading](int keyPressed) {
 			if (keyPressed == GLFW_KEY_M) {
 				gameStatus.activateMultiball();
 				}
@@ -256,86 +257,82 @@ int main() {
 			}
 
 			if (keyPressed == GLFW_KEY_K) {
-				lights.shadersToUse = glm::vec2{ 0, 0 };
+				toonShading = false;
 			}
 			else if (keyPressed == GLFW_KEY_L) {
-				lights.shadersToUse = glm::vec2{ 1, 1 };
+				toonShading = true;
+			}
+
+			if (keyPressed == GLFW_KEY_T) {
+				traceRequested = true;
 			}
 			} };
 
 		//add keyboard press controller
-		Vulkan::Utilities::KeyboardListener keyboardController{ window, rightFlipper, leftFlipper, puller, additionalKeyboardObserver };
+		Vulkan::Utilities::KeyboardListener keyboardController{ window };
+		keyboardController.addObserver(tableKeyboardObserver, { GLFW_KEY_RIGHT, GLFW_KEY_D, GLFW_KEY_LEFT, GLFW_KEY_A, GLFW_KEY_DOWN, GLFW_KEY_SPACE });
+		keyboardController.addObserver(additionalKeyboardObserver, { GLFW_KEY_M, GLFW_KEY_R, GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_K, GLFW_KEY_L, GLFW_KEY_T });
 
 
 		//collision actions
-		(+bumper1).setCollisionAction([&gameStatus, &bumper1](Vulkan::Physics::Hitbox&) {
-			gameStatus.invertBumper(&+bumper1);
-			});
-
-		(+bumper2).setCollisionAction([&gameStatus, &bumper2](Vulkan::Physics::Hitbox&) {
-			gameStatus.invertBumper(&+bumper2);
-			});
-
-		(+bumper3).setCollisionAction([&gameStatus, &bumper3](Vulkan::Physics::Hitbox&) {
-			gameStatus.invertBumper(&+bumper3);
-			});
-
-		(+bumper4).setCollisionAction([&gameStatus, &bumper4](Vulkan::Physics::Hitbox&) {
-			gameStatus.invertBumper(&+bumper4);
-			});
-
-		(+bumper5).setCollisionAction([&gameStatus, &bumper5](Vulkan::Physics::Hitbox&) {
-			gameStatus.invertBumper(&+bumper5);
-			});
-
-		
-		ballKiller.setCollisionAction([&gameStatus](Vulkan::Physics::Hitbox& collidingBall) {
-			gameStatus.killBall(&collidingBall);
-			});
-
-		gameStarter.setCollisionAction([&gameStatus, &puller](Vulkan::Physics::Hitbox&) {
-			gameStatus.startNewGame((+puller).getSpeed());
-			(+puller).reset(PULLER_RESTING_POSITION);
-			});
+		table.bindCollisionActions(gameStatus);
 
 
 
 		// ================ VERTEX/INDEX BUFFERS SETUP ================
 
+		const unsigned int FRAMES_IN_FLIGHT = 2; //the buffers filled every frame have a region per frame in flight, so the CPU doesn't overwrite what the GPU is still reading
+
 		//vertex buffers
-		Vulkan::Buffers::VertexBuffer mainVertexBuffer{ virtualGpu, realGpu, (ball1.getVertices().size() + ball2.getVertices().size() + ball3.getVertices().size() + bumper1.getVertices().size() + bumper2.getVertices().size() + bumper3.getVertices().size() + bumper4.getVertices().size() + bumper5.getVertices().size() + rightFlipper.getVertices().size() + leftFlipper.getVertices().size() + body.getVertices().size() + puller.getVertices().size()) * sizeof(MyVertex)};
-		Vulkan::Buffers::VertexBuffer backgroundVertexBuffer{ virtualGpu, realGpu, (skybox.getVertices().size() + point1.getVertices().size() + point10.getVertices().size() + point100.getVertices().size() + point1000.getVertices().size()) * sizeof(MyVertex) };
-		mainVertexBuffer.fillBuffer(ball1, ball2, ball3, bumper1, bumper2, bumper3, bumper4, bumper5, rightFlipper, leftFlipper, body, puller);
+		size_t tableVerticesCount = 0, tableIndexesCount = 0;
+		for (auto model : tableModels) {
+			tableVerticesCount += model->getVertices().size();
+			tableIndexesCount += model->getIndexes().size();
+		}
+		//static geometry and textures live in device local memory and are uploaded once; the geometry with a single submission, the textures with another one once they are loaded; the background vertices change every frame (the points), so they are streamed
+		Vulkan::Buffers::UploadContext geometryUploads{ virtualGpu, realGpu };
+		Vulkan::Buffers::VertexBuffer mainVertexBuffer{ virtualGpu, realGpu, tableVerticesCount * sizeof(MyVertex), geometryUploads };
+		Vulkan::Buffers::VertexBuffer backgroundVertexBuffer{ virtualGpu, realGpu, (skybox.getVertices().size() + point1.getVertices().size() + point10.getVertices().size() + point100.getVertices().size() + point1000.getVertices().size()) * sizeof(MyVertex), FRAMES_IN_FLIGHT };
+		mainVertexBuffer.fillBuffer(tableModels);
 		backgroundVertexBuffer.fillBuffer(skybox, point1, point10, point100, point1000);
 
 		//index buffers
-		Vulkan::Buffers::IndexBuffer mainIndexBuffer{ virtualGpu, realGpu, (ball1.getIndexes().size() + ball2.getIndexes().size() + ball3.getIndexes().size() + bumper1.getIndexes().size() + bumper2.getIndexes().size() + bumper3.getIndexes().size() + bumper4.getIndexes().size() + bumper5.getIndexes().size() + rightFlipper.getIndexes().size() + leftFlipper.getIndexes().size() + body.getIndexes().size() + body.getIndexes().size()) * sizeof(uint32_t)};
-		Vulkan::Buffers::IndexBuffer backgroundIndexBuffer{ virtualGpu, realGpu, (skybox.getIndexes().size() + point1.getIndexes().size() + point10.getIndexes().size() + point100.getIndexes().size() + point1000.getIndexes().size()) * sizeof(uint32_t) };
-		mainIndexBuffer.fillBuffer(ball1, ball2, ball3, bumper1, bumper2, bumper3, bumper4, bumper5, rightFlipper, leftFlipper, body, puller);
+		Vulkan::Buffers::IndexBuffer mainIndexBuffer{ virtualGpu, realGpu, tableIndexesCount * sizeof(uint32_t), geometryUploads };
+		Vulkan::Buffers::IndexBuffer backgroundIndexBuffer{ virtualGpu, realGpu, (skybox.getIndexes().size() + point1.getIndexes().size() + point10.getIndexes().size() + point100.getIndexes().size() + point1000.getIndexes().size()) * sizeof(uint32_t), geometryUploads };
+		mainIndexBuffer.fillBuffer(tableModels);
 		backgroundIndexBuffer.fillBuffer(skybox, point1, point10, point100, point1000);
 
+		//the copies run while the pipelines are created; the staging memory is released by the frame loop once they are done
+		const auto pendingCopies = geometryUploads.getPendingCopies();
+		geometryUploads.submit();
+		const auto geometrySubmitted = Vulkan::Utilities::Timeline::Clock::now();
+		std::cout << "\nGeometry uploads submitted: " << geometryUploads.getStagedBytes() << " bytes, " << pendingCopies << " copies" << (geometryUploads.hasDedicatedTransferQueue() ? " to a dedicated transfer queue" : "");
 
 
 
 
 
-		// ================ UNIFORMS/TEXTURES SETUP ================
 
-		//texture image
-		Vulkan::TextureImage mainTexture{ virtualGpu, realGpu, commandBufferPool, std::pair(2048, 2048), "textures/Mario_sat_eaeg.png" };
-		Vulkan::TextureImage backgroundTexture{ virtualGpu, realGpu, commandBufferPool, std::pair(2048, 2048), "textures/skybox.png" };
+		// ================ UNIFORMS/TEXTURES SETUP ================
 
-		//uniform buffers
-		Vulkan::Buffers::UniformBuffer mainGlobalUniformBuffer{ virtualGpu, realGpu, 2048 * sizeof(float) };
-		Vulkan::Buffers::UniformBuffer mainPerObjectUniformBuffer{ virtualGpu, realGpu, 1024 * sizeof(float) };
+		//uniform buffers (the ones filled every frame have a region per frame in flight)
+		Vulkan::Buffers::FrameRingBuffer mainGlobalUniformBuffer{ virtualGpu, realGpu, 2048 * sizeof(float), FRAMES_IN_FLIGHT };
+		const size_t alignment = realGpu.getProperties().limits.minUniformBufferOffsetAlignment;
+		const size_t matricesSize = (sizeof(Matrices) + alignment - 1) / alignment * alignment; //each model has its matrices aligned in the buffer
+		Vulkan::Buffers::FrameRingBuffer mainPerObjectUniformBuffer{ virtualGpu, realGpu, std::max(1024 * sizeof(float), tableModels.size() * matricesSize), FRAMES_IN_FLIGHT };
 		Vulkan::Buffers::UniformBuffer backgroundGlobalUniformBuffer{ virtualGpu, realGpu, 2048 * sizeof(float) };
-		Vulkan::Buffers::UniformBuffer backgroundPerObjectUniformBuffer{ virtualGpu, realGpu, 1024 * sizeof(float) };
+		Vulkan::Buffers::FrameRingBuffer backgroundPerObjectUniformBuffer{ virtualGpu, realGpu, 1024 * sizeof(float), FRAMES_IN_FLIGHT };
+
+		const auto memoryStats = virtualGpu.getMemoryAllocator().getStats();
+		std::cout << "\nDevice memory: " << memoryStats.allocations << " allocations in " << memoryStats.blocks << " blocks (" << memoryStats.usedBytes << "/" << memoryStats.blockBytes << " bytes used), " << memoryStats.dedicatedAllocations << " dedicated allocations (" << memoryStats.dedicatedBytes << " bytes), " << memoryStats.deviceAllocations << " vkAllocateMemory allocations";
 
 		//descriptor sets
-		Vulkan::StaticSet mainGlobalSet{ virtualGpu, std::tuple{ VK_SHADER_STAGE_ALL, &mainTexture}, std::tuple{ VK_SHADER_STAGE_ALL, Lights{}, &mainGlobalUniformBuffer, 0 } };
+		Vulkan::StaticSet mainGlobalSet{ virtualGpu, std::tuple{ VK_SHADER_STAGE_ALL, &mainTexture.getImage()}, std::tuple{ VK_SHADER_STAGE_ALL, Lights{}, &mainGlobalUniformBuffer, 0 } };
 		Vulkan::DynamicSet mainPerObjectSet{ realGpu, virtualGpu, mainPerObjectUniformBuffer, std::pair{VK_SHADER_STAGE_ALL, Matrices{}} };
-		Vulkan::StaticSet backgroundGlobalSet{ virtualGpu, std::tuple{VK_SHADER_STAGE_ALL, &backgroundTexture} };
+		Vulkan::StaticSet backgroundGlobalSet{ virtualGpu, std::tuple{VK_SHADER_STAGE_ALL, &backgroundTexture.getImage()} };
 		Vulkan::DynamicSet backgroundPerObjectSet{ realGpu, virtualGpu, backgroundPerObjectUniformBuffer, std::pair{VK_SHADER_STAGE_ALL, Matrices{}} };
+		mainTexture.bind(mainGlobalSet, 0); //the sets follow the levels the streamer swaps in
+		backgroundTexture.bind(backgroundGlobalSet, 0);
 
 
 
@@ -356,16 +353,24 @@ int main() {
 		//main pipeline
 		Vulkan::PipelineOptions::PipelineLayout mainPipelineLayout{ virtualGpu, mainGlobalSet, mainPerObjectSet };
 		Vulkan::PipelineOptions::Shader mainVertexShader{ virtualGpu, "shaders/VertexShaderVert.spv", VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT };
-		Vulkan::PipelineOptions::Shader mainFragmentShader{ virtualGpu, "shaders/FragmentShaderFrag.spv", VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT };
+		Vulkan::PipelineOptions::Shader mainFragmentShader{ virtualGpu, "shaders/FragmentShaderFrag.spv", VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT, "main", Vulkan::PipelineOptions::SpecializationConstants{}.set(DIFFUSE_MODEL_ID, 0).set(SPECULAR_MODEL_ID, 0) }; //Lambert diffuse, Blinn specular
+		Vulkan::PipelineOptions::Shader toonFragmentShader{ mainFragmentShader, Vulkan::PipelineOptions::SpecializationConstants{}.set(DIFFUSE_MODEL_ID, 1).set(SPECULAR_MODEL_ID, 1) }; //Toon diffuse, Toon specular
 
-		Vulkan::Pipeline mainPipeline{ virtualGpu, renderPass, 0, std::vector{&mainVertexShader, &mainFragmentShader},vertexTypesDescriptor, mainPipelineLayout, rasterizer, inputAssembly, multisampler, depthStencil, dynamicState, viewport };
+		//the pipelines are compiled by the jobs, while the textures are loaded and the first frames are drawn; a group isn't drawn till its pipeline is ready
+		Vulkan::Pipeline mainPipeline{ virtualGpu, renderPass, 0, std::vector{&mainVertexShader, &mainFragmentShader},vertexTypesDescriptor, mainPipelineLayout, rasterizer, inputAssembly, multisampler, depthStencil, dynamicState, viewport, jobs, "main pipeline", &startupTimeline };
 
 		//background pipeline
 		Vulkan::PipelineOptions::PipelineLayout backgroundPipelineLayout{ virtualGpu, backgroundGlobalSet, backgroundPerObjectSet };
 		Vulkan::PipelineOptions::Shader backgroundVertexShader{ virtualGpu, "shaders/BackgroundBoxShaderVert.spv", VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT };
 		Vulkan::PipelineOptions::Shader backgroundFragmentShader{ virtualGpu, "shaders/BackgroundBoxShaderFrag.spv", VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT };
 
-		Vulkan::Pipeline backgroundPipeline{ virtualGpu, renderPass, 0, std::vector{&backgroundVertexShader, &backgroundFragmentShader},vertexTypesDescriptor, backgroundPipelineLayout, rasterizer, inputAssembly, multisampler, depthStencil, dynamicState, viewport };
+		Vulkan::Pipeline backgroundPipeline{ virtualGpu, renderPass, 0, std::vector{&backgroundVertexShader, &backgroundFragmentShader},vertexTypesDescriptor, backgroundPipelineLayout, rasterizer, inputAssembly, multisampler, depthStencil, dynamicState, viewport, jobs, "background pipeline", &startupTimeline };
+
+		//the table with the other lighting models (L and K keys), which isn't needed at startup
+		Vulkan::Pipeline toonPipeline{ virtualGpu, renderPass, 0, std::vector{&mainVertexShader, &toonFragmentShader},vertexTypesDescriptor, mainPipelineLayout, rasterizer, inputAssembly, multisampler, depthStencil, dynamicState, viewport, jobs, "toon pipeline" };
+
+		//the textures are needed from the first frame
+		submitDecodedTextures(true);
 
 
 
@@ -376,40 +381,113 @@ int main() {
 		Vulkan::Drawer drawer{ virtualGpu, realGpu, window, windowSurface, swapchain, depthBuffer, commandBufferPool, renderPass,
 			{&mainPipeline, &backgroundPipeline},
 			{mainGlobalSet, backgroundGlobalSet},
-			{mainPerObjectSet, backgroundPerObjectSet} };
+			{mainPerObjectSet, backgroundPerObjectSet},
+			FRAMES_IN_FLIGHT };
+
+		//physics instrumentation, read by the draw cycle
+		Vulkan::Physics::PhysicsStats physicsStats;
+		Vulkan::Physics::TickHistory physicsHistory;
+		table.getGameUniverse().setStats(&physicsStats);
 
 		std::cout << "\n";
 		//physics cycle in new thread (so that it isn't dependant on FPS)
-		std::thread physicsThread{ [&physicsUniverse, &pullerUniverse, &keyboardController, &leftFlipper, &rightFlipper, &window] () {
+		std::thread physicsThread{ [&table, universes = table.getUniverses(), &keyboardController, &window] () {
+#ifdef VULKAN_TRACING
+			Vulkan::Utilities::Tracer::get().setThreadName("physics");
+#endif
 			auto lastFrameTime = std::chrono::high_resolution_clock::now();
 			while (!glfwWindowShouldClose(+window)) {
 				auto elapsedNano = std::chrono::high_resolution_clock::now() - lastFrameTime;
 				//1/100000 is the maximum physics "framerate". If we higher it then it won't work properly in release mode, because debug mode cannot do better than 1/100000
 				if (elapsedNano.count() > 100000) {
 					lastFrameTime = std::chrono::high_resolution_clock::now();
-					calculatePhysics(std::vector{ &physicsUniverse, &pullerUniverse }, keyboardController, +leftFlipper, +rightFlipper, std::chrono::nanoseconds{ elapsedNano });
+					calculatePhysics(universes, keyboardController, table.getLeftPad(), table.getRightPad(), std::chrono::nanoseconds{ elapsedNano });
 				}
 			}
 		} };
 
 		//draw cycle
+		//after the warm-up (once the frame allocator and the queues of the jobs have grown enough) a frame doesn't allocate, which is checked in Debug (see AllocationCounter)
+		const uint64_t WARM_UP_FRAMES = 60;
+		Vulkan::Utilities::FrameAllocator frameAllocator; //scratch memory of the frame
+		uint64_t frames = 0;
 		auto lastFrameTime = std::chrono::high_resolution_clock::now();
+		auto lastTraceExport = std::chrono::steady_clock::time_point{};
+		bool startupReported = false;
 		while (!glfwWindowShouldClose(+window)) {
+			VULKAN_TRACE_ZONE("frame");
+			const auto allocationsBefore = Vulkan::Utilities::AllocationCounter::getThreadAllocations();
+			const auto recreationsBefore = drawer.getSwapchainRecreations();
+			bool traceExported = false, startupPrinted = false;
+			frameAllocator.reset();
 			glfwPollEvents();
-			calculateGraphics(camera, mainPerObjectUniformBuffer, mainPerObjectSet, mainGlobalUniformBuffer, mainGlobalSet, backgroundPerObjectUniformBuffer, backgroundPerObjectSet, backgroundVertexBuffer, std::tuple{ &ball1, &ball2, &ball3, &bumper1, &bumper2, &bumper3, &bumper4, &bumper5, &rightFlipper, &leftFlipper, &body, &puller, &point1, &point10, &point100, &point1000, &skybox }, lights, physicsUniverse, pullerUniverse, keyboardController, (float)swapchain.getResolution().first/swapchain.getResolution().second, gameStatus.getPoints());
+
+			//T is held for many physics ticks, so the requests of the same press are merged
+			if (traceRequested.exchange(false) && std::chrono::steady_clock::now() - lastTraceExport > std::chrono::seconds{ 1 }) {
+				std::cout << "\nTrace: " << Vulkan::Utilities::Tracer::get().exportChromeTrace("trace.json") << " zones written to trace.json\n";
+				lastTraceExport = std::chrono::steady_clock::now();
+				traceExported = true;
+			}
+
+			//the uniforms and the background vertices are written to the regions of the next frame, once the GPU has finished the frame which read them last
+			const unsigned int frame = drawer.waitForFrame();
+			for (auto buffer : { &mainGlobalUniformBuffer, &mainPerObjectUniformBuffer, &backgroundPerObjectUniformBuffer }) {
+				buffer->setFrame(frame);
+			}
+			backgroundVertexBuffer.setFrame(frame);
+
+			//releases the staging memory of the uploads the GPU has finished; the first time they are all finished and the pipelines are ready, the startup is over
+			const bool geometryUploaded = geometryUploads.collect();
+			const bool texturesUploaded = textureUploads.collect();
+			if (!startupReported && geometryUploaded && texturesUploaded && mainPipeline.isReady() && backgroundPipeline.isReady()) {
+				const auto uploadsDone = Vulkan::Utilities::Timeline::Clock::now(); //the uploads are seen finished at the first check after their end
+				startupTimeline.add("GPU geometry upload", geometrySubmitted, uploadsDone);
+				startupTimeline.add("GPU texture upload", texturesSubmitted, uploadsDone);
+				std::cout << "\nStartup (" << (virtualGpu.getPipelineCache().isWarm() ? "warm" : "cold") << " pipeline cache):"; //the pipelines take much longer with a cold cache, when the driver compiles their shaders
+				startupTimeline.print(std::cout);
+				std::cout << "\n";
+				startupReported = startupPrinted = true;
+			}
+
+			//the levels of the textures follow their size on screen; the skybox surrounds the camera, so each face of the cube fills 90 degrees of the view, and takes a quarter of the width of the texture
+			//the streamer starts once the uploads of the startup are finished, since it destroys the images it swaps out
+			const float screenHeight = static_cast<float>(swapchain.getResolution().second);
+			mainTexture.request(estimateTextureSize(camera, tableModels, tableTextureDensities, screenHeight));
+			backgroundTexture.request(4 * screenHeight / glm::tan(glm::radians(FIELD_OF_VIEW_Y / 2)));
+			const bool texturesStreamed = startupReported && textureStreamer.update(frame, drawer);
+
+			//the table keeps the old lighting models till the pipeline with the new ones is ready
+			drawer.setPipeline(0, toonShading ? toonPipeline : mainPipeline);
+
+			physicsHistory.update(physicsStats);
+			calculateGraphics(camera, mainPerObjectUniformBuffer, mainPerObjectSet, mainGlobalUniformBuffer, mainGlobalSet, backgroundPerObjectUniformBuffer, backgroundPerObjectSet, backgroundVertexBuffer, tableModels, std::tuple{ &point1, &point10, &point100, &point1000, &skybox }, lights, table, keyboardController, jobs, frameAllocator, (float)swapchain.getResolution().first/swapchain.getResolution().second, gameStatus.getPoints());
 			lastFrameTime = std::chrono::high_resolution_clock::now();
-			drawer.draw(
+			drawer.draw(frameAllocator,
 				std::pair< std::reference_wrapper<Vulkan::Buffers::VertexBuffer>, std::reference_wrapper<Vulkan::Buffers::IndexBuffer>>{ mainVertexBuffer, mainIndexBuffer },
 				std::pair< std::reference_wrapper<Vulkan::Buffers::VertexBuffer>, std::reference_wrapper<Vulkan::Buffers::IndexBuffer>>{ backgroundVertexBuffer, backgroundIndexBuffer }
 			);
+
+			//exporting a trace, printing the startup, streaming textures and recreating the swapchain are not part of the steady state
+			frames++;
+			assert(frames <= WARM_UP_FRAMES || traceExported || startupPrinted || texturesStreamed || drawer.getSwapchainRecreations() != recreationsBefore || Vulkan::Utilities::AllocationCounter::getThreadAllocations() == allocationsBefore);
 		}
 		vkDeviceWaitIdle(+virtualGpu);
 
 		physicsThread.join();
+		table.getGameUniverse().setStats(nullptr);
+
+		physicsHistory.update(physicsStats);
+		auto physicsSummary = physicsHistory.summarize(std::chrono::microseconds{ 100 }); //the physics is meant to run at least every 100us (see the physics cycle)
+		std::cout << "\nPhysics (last " << physicsSummary.ticks << " ticks): p50 " << physicsSummary.p50.count() << "ns, p99 " << physicsSummary.p99.count() << "ns, max " << physicsSummary.max.count() << "ns, " << physicsSummary.deadlineMisses << " deadline misses, " << physicsStats.getDropped() << " records dropped";
+		std::cout << "\nInput: max latency " << keyboardController.getMaxLatency().count() << "ns, " << keyboardController.getDropped() << " key events dropped";
+		const auto streamingStats = textureStreamer.getStats();
+		std::cout << "\nTexture streaming: " << streamingStats.loads << " loads, " << streamingStats.evictions << " evictions, " << streamingStats.residentBytes << " bytes resident (peak " << streamingStats.peakResidentBytes << ") of a budget of " << TEXTURE_BUDGET << " bytes";
 
 		std::cout << "\n";
 	} catch (const Vulkan::VulkanException& ve) {
 		std::cout << ve.what();
+	} catch (const std::runtime_error& e) {
+		std::cout << e.what(); //e.g. the table file is missing or corrupted
 	}
 	std::cout << "\n\n";
 
@@ -418,8 +496,9 @@ int main() {
 
 
 template<typename... Models>
-void calculateGraphics(Vulkan::Objects::Camera& camera, Vulkan::Buffers::UniformBuffer& mainPerObjectBuffer, const Vulkan::DynamicSet& mainPerObjectSet, Vulkan::Buffers::UniformBuffer& mainGlobalBuffer, const Vulkan::StaticSet& mainGlobalSet, Vulkan::Buffers::UniformBuffer& backgroundBuffer, const Vulkan::DynamicSet& backgroundSet, Vulkan::Buffers::VertexBuffer& backgroundVertexBuffer, const std::tuple<Models*...>& models, Lights& lights, Vulkan::Physics::Universe& universe, Vulkan::Physics::Universe& pullerUniverse, Vulkan::Utilities::KeyboardListener& keyboardController, float aspectRatio, int points) {
-	float n = 0.1f, f = 10000.0f, fovY = 120.0f, a = aspectRatio, w = 1.0f;
+void calculateGraphics(Vulkan::Objects::Camera& camera, Vulkan::Buffers::UniformBuffer& mainPerObjectBuffer, const Vulkan::DynamicSet& mainPerObjectSet, Vulkan::Buffers::UniformBuffer& mainGlobalBuffer, const Vulkan::StaticSet& mainGlobalSet, Vulkan::Buffers::UniformBuffer& backgroundBuffer, const Vulkan::DynamicSet& backgroundSet, Vulkan::Buffers::VertexBuffer& backgroundVertexBuffer, const std::vector<Vulkan::Objects::Model<MyVertex>*>& tableModels, const std::tuple<Models*...>& backgroundModels, Lights& lights, const Vulkan::Physics::Table& table, Vulkan::Utilities::KeyboardListener& keyboardController, Vulkan::Utilities::JobSystem& jobs, Vulkan::Utilities::FrameAllocator& frameAllocator, float aspectRatio, int points) {
+	VULKAN_TRACE_ZONE("calculateGraphics");
+	float n = 0.1f, f = 10000.0f, fovY = FIELD_OF_VIEW_Y, a = aspectRatio, w = 1.0f;
 	glm::mat4 perspective{
 			1 / (a * glm::tan(glm::radians(fovY / 2))), 0, 0, 0,
 			0, -1 / glm::tan(glm::radians(fovY / 2)), 0, 0,
@@ -435,45 +514,24 @@ void calculateGraphics(Vulkan::Objects::Camera& camera, Vulkan::Buffers::Uniform
 	};
 
 
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& ball1 = *std::get<0>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& ball2 = *std::get<1>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& ball3 = *std::get<2>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& bumper1 = *std::get<3>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& bumper2 = *std::get<4>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& bumper3 = *std::get<5>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& bumper4 = *std::get<6>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& bumper5 = *std::get<7>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& rightFlipper = *std::get<8>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& leftFlipper = *std::get<9>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& body = *std::get<10>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& puller = *std::get<11>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point1 = *std::get<12>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point10 = *std::get<13>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point100 = *std::get<14>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point1000 = *std::get<15>(models);
-	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& skybox = *std::get<16>(models);
-
-
-	lights.position5 = (+ball1).getPosition(); lights.position5.z = 0.16f;
-	lights.position6 = (+ball2).getPosition(); lights.position6.z = 0.16f;
-	lights.position7 = (+ball3).getPosition(); lights.position7.z = 0.16f;
+	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point1 = *std::get<0>(backgroundModels);
+	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point10 = *std::get<1>(backgroundModels);
+	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point100 = *std::get<2>(backgroundModels);
+	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& point1000 = *std::get<3>(backgroundModels);
+	Vulkan::Objects::Model<Vulkan::PipelineOptions::Vertex<glm::vec3, glm::vec3, glm::vec2>>& skybox = *std::get<4>(backgroundModels);
+
+
+	table.updateLights(lights);
 
 	glm::mat4 projection = perspective;
 
-	mainPerObjectSet.fillBuffer(mainPerObjectBuffer,
-		ball1.getUniforms(camera.getViewMatrix(), projection),
-		ball2.getUniforms(camera.getViewMatrix(), projection),
-		ball3.getUniforms(camera.getViewMatrix(), projection),
-		bumper1.getUniforms(camera.getViewMatrix(), projection),
-		bumper2.getUniforms(camera.getViewMatrix(), projection),
-		bumper3.getUniforms(camera.getViewMatrix(), projection),
-		bumper4.getUniforms(camera.getViewMatrix(), projection),
-		bumper5.getUniforms(camera.getViewMatrix(), projection),
-		rightFlipper.getUniforms(camera.getViewMatrix(), projection),
-		leftFlipper.getUniforms(camera.getViewMatrix(), projection),
-		body.getUniforms(camera.getViewMatrix(), projection),
-		puller.getUniforms(camera.getViewMatrix(), projection)
-	);
+	//the matrices of each model are independent, so they are computed in parallel (a job computes many models, since a model takes less than a microsecond)
+	const glm::mat4 view = camera.getViewMatrix();
+	auto tableUniforms = frameAllocator.allocate<std::remove_cvref_t<decltype(tableModels[0]->getUniforms(view, projection))>>(tableModels.size());
+	jobs.parallelFor(0, tableModels.size(), 256, [&tableModels, &tableUniforms, &view, &projection](size_t i) {
+		tableUniforms[i] = tableModels[i]->getUniforms(view, projection);
+		}, "tableUniforms");
+	mainPerObjectSet.fillBuffer(mainPerObjectBuffer, std::span<const typename decltype(tableUniforms)::value_type>{ tableUniforms });
 
 	point1.setVertices(buildPointDisplayerVertices(points / 1 % 10));
 	point10.setVertices(buildPointDisplayerVertices(points / 10 % 10));
@@ -495,18 +553,11 @@ void calculateGraphics(Vulkan::Objects::Camera& camera, Vulkan::Buffers::Uniform
 
 
 
-void calculatePhysics(std::vector<Vulkan::Physics::Universe*> universes, Vulkan::Utilities::KeyboardListener& kc, Vulkan::Physics::Hitbox& leftFlipper, Vulkan::Physics::Hitbox& rightFlipper, std::chrono::nanoseconds elapsedNanoseconds) {
+void calculatePhysics(const std::vector<Vulkan::Physics::Universe*>& universes, Vulkan::Utilities::KeyboardListener& kc, Vulkan::Physics::Hitbox& leftFlipper, Vulkan::Physics::Hitbox& rightFlipper, std::chrono::nanoseconds elapsedNanoseconds) {
+	VULKAN_TRACE_ZONE("calculatePhysics");
 	float elapsedSeconds = elapsedNanoseconds.count() / 1000000000.0f;
 
-	rightFlipper.setAngularSpeed(0.0f);
-	if (Vulkan::Animations::checkRightPadArea(static_cast<Vulkan::Physics::FrameHitbox&>(rightFlipper), 0.1f)) {
-		rightFlipper.setAngularSpeed(FLIPPER_ANGULAR_SPEED);
-	}
-
-	leftFlipper.setAngularSpeed(0.0f);
-	if (Vulkan::Animations::checkLeftPadArea(static_cast<Vulkan::Physics::FrameHitbox&>(leftFlipper), 0.1f)) {
-		leftFlipper.setAngularSpeed(-FLIPPER_ANGULAR_SPEED);
-	}
+	Vulkan::Animations::lowerPads(leftFlipper, rightFlipper);
 
 	kc.checkKeyPressed();
 
@@ -515,3 +566,40 @@ void calculatePhysics(std::vector<Vulkan::Physics::Universe*> universes, Vulkan:
 	}
 };
 
+
+
+
+
+
+float getTextureDensity(const Vulkan::Objects::Model<MyVertex>& model) {
+	//the texture coordinates the model spans per unit of its own space, on average over its surface
+	const auto& vertices = model.getVertices();
+	const auto& indexes = model.getIndexes();
+	float area = 0.0f, textureArea = 0.0f;
+	for (size_t i = 0; i + 2 < indexes.size(); i += 3) {
+		const auto& v1 = vertices[indexes[i]];
+		const auto& v2 = vertices[indexes[i + 1]];
+		const auto& v3 = vertices[indexes[i + 2]];
+		area += glm::length(glm::cross(v2.get<0>() - v1.get<0>(), v3.get<0>() - v1.get<0>())) / 2;
+		const glm::vec2 t1 = v2.get<2>() - v1.get<2>(), t2 = v3.get<2>() - v1.get<2>();
+		textureArea += glm::abs(t1.x * t2.y - t1.y * t2.x) / 2;
+	}
+	return area > 0.0f ? glm::sqrt(textureArea / area) : 0.0f;
+};
+
+
+
+float estimateTextureSize(const Vulkan::Objects::Camera& camera, const std::vector<Vulkan::Objects::Model<MyVertex>*>& models, const std::vector<float>& textureDensities, float screenHeight) {
+	//the size on screen of the whole texture as each model shows it, from its distance from the camera (a unit at distance 1 covers pixelsPerUnit pixels); the largest one counts
+	const float pixelsPerUnit = screenHeight / (2 * glm::tan(glm::radians(FIELD_OF_VIEW_Y / 2)));
+	const glm::vec3 eye{ camera.getPosition() };
+	float size = 0.0f;
+	for (size_t i = 0; i < models.size(); ++i) {
+		if (textureDensities[i] > 0.0f) {
+			const auto& hitbox = +*models[i];
+			const float distance = std::max(glm::distance(eye, glm::vec3(hitbox.getPosition())), 0.1f);
+			size = std::max(size, pixelsPerUnit * hitbox.getScaleFactor() / (distance * textureDensities[i]));
+		}
+	}
+	return size;
+};
@@ -0,0 +1,393 @@
+#ifndef COLLISIONCOOKER_COLLISIONCOOKER
+#define COLLISIONCOOKER_COLLISIONCOOKER
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include "CollisionFormat.h"
+#include "TableCompiler.h"
+
+
+/**
+ * @brief Cooks the collision geometry of a table from the meshes of its models: a mesh is sliced at the height of the playfield, and the outline of the slice is simplified and written as a collision asset (.col).
+ * @details The mesh is first brought in the reference system of its hitbox, with the same rotation (degrees, as in the model directive of a readable table) and scale the game applies to the model, so that the outlines can be used as they are as the vertices of the hitbox.
+ *			The simplification (Douglas-Peucker) keeps every point of the slice closer than the tolerance to the simplified outline: a larger tolerance means less segments to test for each collision, a smaller one a closer match with what is drawn.
+ */
+namespace CollisionCooker {
+
+	using Vulkan::Physics::TableFormat::Vec3;
+
+
+	struct CookSettings {
+		float height = 0.0f; //z of the slicing plane, in the reference system of the hitbox
+		float tolerance = 0.01f;
+		glm::vec3 rotation{ 0.0f }; //degrees, the rotation of the model relative to its hitbox
+		float scale = 1.0f; //the scale of the hitbox
+		bool largestOnly = false; //keep only the outline with the largest area
+	};
+
+
+	/**
+	 * @brief An outline of the slice: a closed loop or, if the mesh has holes, an open chain.
+	 */
+	struct Outline {
+		std::vector<glm::vec2> vertices; //a closed outline doesn't repeat its first vertex
+		bool closed = false;
+		size_t slicedVertices = 0; //vertices before the simplification
+	};
+
+
+	/**
+	 * @brief A triangle mesh, with the vertices already in the reference system of the hitbox.
+	 */
+	struct Mesh {
+		std::vector<glm::vec3> vertices;
+		std::vector<uint32_t> triangles; //3 indices per triangle
+	};
+
+
+
+	namespace Detail {
+
+		//index of an OBJ face vertex (v, v/t, v//n or v/t/n), 1 based or negative (relative to the end)
+		inline uint32_t parseIndex(const std::string& token, size_t verticesCount, const std::string& where) {
+			int index = 0;
+			try {
+				index = std::stoi(token.substr(0, token.find('/')));
+			}
+			catch (const std::exception&) {
+				throw std::runtime_error{ where + ": bad face vertex " + token };
+			}
+			long long res = index > 0 ? index - 1LL : static_cast<long long>(verticesCount) + index;
+			if (index == 0 || res < 0 || res >= static_cast<long long>(verticesCount)) {
+				throw std::runtime_error{ where + ": face vertex out of range " + token };
+			}
+			return static_cast<uint32_t>(res);
+		}
+
+
+		//squared distance of p from the segment a-b
+		inline float squaredDistance(glm::vec2 p, glm::vec2 a, glm::vec2 b) {
+			glm::vec2 ab = b - a;
+			float squaredLength = glm::dot(ab, ab);
+			float t = squaredLength > 0.0f ? std::clamp(glm::dot(p - a, ab) / squaredLength, 0.0f, 1.0f) : 0.0f;
+			glm::vec2 d = p - (a + ab * t);
+			return glm::dot(d, d);
+		}
+
+
+		//Douglas-Peucker between first and last (both kept), appends the kept vertices after first, last excluded
+		inline void simplify(const std::vector<glm::vec2>& points, size_t first, size_t last, float squaredTolerance, std::vector<glm::vec2>& out) {
+			out.push_back(points[first]);
+			std::vector<std::pair<size_t, size_t>> stack{ { first, last } };
+			std::vector<bool> kept(points.size(), false);
+			while (!stack.empty()) {
+				auto [a, b] = stack.back();
+				stack.pop_back();
+				float farthest = 0.0f;
+				size_t index = a;
+				for (size_t i = a + 1; i < b; ++i) {
+					float d = squaredDistance(points[i], points[a], points[b]);
+					if (d > farthest) {
+						farthest = d;
+						index = i;
+					}
+				}
+				if (farthest > squaredTolerance) {
+					kept[index] = true;
+					stack.push_back({ a, index });
+					stack.push_back({ index, b });
+				}
+			}
+			for (size_t i = first + 1; i < last; ++i) {
+				if (kept[i]) {
+					out.push_back(points[i]);
+				}
+			}
+		}
+
+
+		inline float area(const std::vector<glm::vec2>& loop) {
+			float doubleArea = 0.0f;
+			for (size_t i = 0; i < loop.size(); ++i) {
+				const auto& a = loop[i];
+				const auto& b = loop[(i + 1) % loop.size()];
+				doubleArea += a.x * b.y - b.x * a.y;
+			}
+			return doubleArea / 2.0f;
+		}
+
+
+		inline std::vector<Vec3> toVec3(const std::vector<glm::vec2>& points) {
+			std::vector<Vec3> res;
+			for (const auto& p : points) {
+				res.push_back(Vec3{ p.x, p.y, 0.0f });
+			}
+			return res;
+		}
+
+	}
+
+
+
+	/**
+	 * @brief Reads the triangles of an OBJ file (polygons are split in fans, everything but vertices and faces is ignored) and brings them in the reference system of the hitbox. Throws std::runtime_error if the file cannot be read or it is malformed.
+	 */
+	inline Mesh readObj(const std::string& path, glm::vec3 rotation, float scale) {
+		std::ifstream in{ path };
+		if (!in) {
+			throw std::runtime_error{ "Cannot open " + path };
+		}
+
+		const glm::quat modelRotation{ glm::radians(rotation) }; //the same rotation Model builds from the euler angles
+		Mesh mesh{};
+		std::map<std::tuple<float, float, float>, uint32_t> welded; //exporters often duplicate the vertices on the seams of the texture
+		std::vector<uint32_t> objToMesh;
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(in, line)) {
+			lineNumber++;
+			std::istringstream tokens{ line };
+			std::string type;
+			tokens >> type;
+			const std::string where = path + ":" + std::to_string(lineNumber);
+
+			if (type == "v") {
+				glm::vec3 v{};
+				if (!(tokens >> v.x >> v.y >> v.z)) {
+					throw std::runtime_error{ where + ": bad vertex" };
+				}
+				auto [found, inserted] = welded.emplace(std::make_tuple(v.x, v.y, v.z), static_cast<uint32_t>(mesh.vertices.size()));
+				if (inserted) {
+					mesh.vertices.push_back(modelRotation * v * scale);
+				}
+				objToMesh.push_back(found->second);
+			}
+			else if (type == "f") {
+				std::vector<uint32_t> face;
+				for (std::string token; tokens >> token; ) {
+					face.push_back(objToMesh[Detail::parseIndex(token, objToMesh.size(), where)]);
+				}
+				if (face.size() < 3) {
+					throw std::runtime_error{ where + ": a face needs at least 3 vertices" };
+				}
+				for (size_t i = 1; i + 1 < face.size(); ++i) {
+					mesh.triangles.insert(mesh.triangles.end(), { face[0], face[i], face[i + 1] });
+				}
+			}
+		}
+
+		if (mesh.triangles.empty()) {
+			throw std::runtime_error{ path + " has no faces" };
+		}
+		return mesh;
+	}
+
+
+
+	/**
+	 * @brief Slices a mesh with the plane z = height and chains the pieces of the slice into outlines.
+	 * @details A vertex exactly on the plane counts as above it, so that the plane never cuts a triangle in a single point. Each point of the slice lies on an edge of the mesh, and it is identified by that edge: the pieces of adjacent triangles share their ends exactly, without any welding tolerance.
+	 */
+	inline std::vector<Outline> slice(const Mesh& mesh, float height) {
+		using Edge = std::pair<uint32_t, uint32_t>; //the lower index first
+		auto makeEdge = [](uint32_t a, uint32_t b) { return a < b ? Edge{ a, b } : Edge{ b, a }; };
+
+		//the pieces of the slice, one per crossed triangle
+		std::vector<std::pair<Edge, Edge>> pieces;
+		std::map<Edge, glm::vec2> points;
+		auto crossing = [&](Edge edge) {
+			if (!points.contains(edge)) {
+				const auto& a = mesh.vertices[edge.first];
+				const auto& b = mesh.vertices[edge.second];
+				float t = (height - a.z) / (b.z - a.z);
+				points.emplace(edge, glm::vec2{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t });
+			}
+			return edge;
+		};
+		for (size_t i = 0; i < mesh.triangles.size(); i += 3) {
+			uint32_t v[3] = { mesh.triangles[i], mesh.triangles[i + 1], mesh.triangles[i + 2] };
+			bool above[3];
+			for (int k = 0; k < 3; ++k) {
+				above[k] = mesh.vertices[v[k]].z >= height;
+			}
+			if (above[0] == above[1] && above[1] == above[2]) {
+				continue;
+			}
+			//the lonely vertex is on the other side of the plane from the other 2
+			int lonely = above[0] != above[1] && above[0] != above[2] ? 0 : (above[1] != above[0] ? 1 : 2);
+			uint32_t a = v[lonely], b = v[(lonely + 1) % 3], c = v[(lonely + 2) % 3];
+			pieces.emplace_back(crossing(makeEdge(a, b)), crossing(makeEdge(a, c)));
+		}
+
+		//chain the pieces: open chains start from a point touched by a single piece, what remains are loops
+		std::map<Edge, std::vector<size_t>> touching;
+		for (size_t i = 0; i < pieces.size(); ++i) {
+			touching[pieces[i].first].push_back(i);
+			touching[pieces[i].second].push_back(i);
+		}
+		std::vector<bool> used(pieces.size(), false);
+		std::vector<Outline> outlines;
+
+		auto walk = [&](Edge start, size_t piece) {
+			Outline outline{};
+			outline.vertices.push_back(points[start]);
+			Edge current = start;
+			while (true) {
+				used[piece] = true;
+				current = pieces[piece].first == current ? pieces[piece].second : pieces[piece].first;
+				if (current == start) {
+					outline.closed = true;
+					break;
+				}
+				outline.vertices.push_back(points[current]);
+				auto next = std::find_if(touching[current].begin(), touching[current].end(), [&used](size_t p) { return !used[p]; });
+				if (next == touching[current].end()) {
+					break;
+				}
+				piece = *next;
+			}
+			return outline;
+		};
+
+		for (const auto& [point, list] : touching) {
+			if (list.size() == 1 && !used[list[0]]) {
+				outlines.push_back(walk(point, list[0]));
+			}
+		}
+		for (size_t i = 0; i < pieces.size(); ++i) {
+			if (!used[i]) {
+				outlines.push_back(walk(pieces[i].first, i));
+			}
+		}
+		return outlines;
+	}
+
+
+
+	/**
+	 * @brief Simplifies an outline, so that no vertex of the original outline is farther than the tolerance from the simplified one. Closed outlines become counterclockwise.
+	 * @details A closed outline is split in 2 open chains at the vertex farthest from its first vertex, so that both ends of both chains are kept.
+	 */
+	inline Outline simplify(const Outline& outline, float tolerance) {
+		Outline res{};
+		res.closed = outline.closed;
+		res.slicedVertices = outline.vertices.size();
+		const float squaredTolerance = tolerance * tolerance;
+		const auto& points = outline.vertices;
+
+		if (!outline.closed) {
+			Detail::simplify(points, 0, points.size() - 1, squaredTolerance, res.vertices);
+			res.vertices.push_back(points.back());
+			return res;
+		}
+
+		std::vector<glm::vec2> loop{ points.begin(), points.end() };
+		if (Detail::area(loop) < 0.0f) {
+			std::reverse(loop.begin(), loop.end());
+		}
+		size_t farthest = 0;
+		for (size_t i = 1; i < loop.size(); ++i) {
+			if (glm::dot(loop[i] - loop[0], loop[i] - loop[0]) > glm::dot(loop[farthest] - loop[0], loop[farthest] - loop[0])) {
+				farthest = i;
+			}
+		}
+		loop.push_back(loop[0]);
+		Detail::simplify(loop, 0, farthest, squaredTolerance, res.vertices);
+		Detail::simplify(loop, farthest, loop.size() - 1, squaredTolerance, res.vertices);
+		return res;
+	}
+
+
+
+	/**
+	 * @brief Slices and simplifies a mesh. The outlines are sorted by area, largest first, and degenerate ones (less than 3 vertices for a loop, or less than 2 for a chain) are dropped.
+	 */
+	inline std::vector<Outline> cook(const Mesh& mesh, const CookSettings& settings) {
+		std::vector<Outline> res;
+		for (const auto& outline : slice(mesh, settings.height)) {
+			auto simplified = simplify(outline, settings.tolerance);
+			if (simplified.vertices.size() >= (simplified.closed ? 3u : 2u)) {
+				res.push_back(std::move(simplified));
+			}
+		}
+
+		std::stable_sort(res.begin(), res.end(), [](const Outline& a, const Outline& b) {
+			return (a.closed ? std::abs(Detail::area(a.vertices)) : 0.0f) > (b.closed ? std::abs(Detail::area(b.vertices)) : 0.0f);
+		});
+		if (settings.largestOnly && res.size() > 1) {
+			res.resize(1);
+		}
+		return res;
+	}
+
+
+
+	inline bool isConvex(const Outline& outline) {
+		return outline.closed && TableCompiler::Detail::isConvex(Detail::toVec3(outline.vertices));
+	}
+
+
+	/**
+	 * @brief Writes the outlines as a collision asset.
+	 */
+	inline std::vector<char> compile(const std::vector<Outline>& outlines, float tolerance) {
+		using namespace Vulkan::Physics;
+
+		std::vector<CollisionFormat::OutlineRecord> records;
+		std::vector<Vec3> vertices;
+		for (const auto& outline : outlines) {
+			CollisionFormat::OutlineRecord record{};
+			record.flags = (outline.closed ? CollisionFormat::CLOSED : 0u) | (isConvex(outline) ? CollisionFormat::CONVEX : 0u);
+			record.area = outline.closed ? Detail::area(outline.vertices) : 0.0f;
+			record.vertices = TableFormat::Range{ static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(outline.vertices.size()) };
+			auto outlineVertices = Detail::toVec3(outline.vertices);
+			vertices.insert(vertices.end(), outlineVertices.begin(), outlineVertices.end());
+			records.push_back(record);
+		}
+
+		CollisionFormat::Header header{};
+		std::memcpy(header.magic, CollisionFormat::MAGIC, sizeof(CollisionFormat::MAGIC));
+		header.version = CollisionFormat::VERSION;
+		header.tolerance = tolerance;
+
+		std::vector<char> file(sizeof(header));
+		auto append = [&file](const auto& items) {
+			TableFormat::Section section{ static_cast<uint32_t>(file.size()), static_cast<uint32_t>(items.size()) };
+			const char* bytes = reinterpret_cast<const char*>(items.data());
+			file.insert(file.end(), bytes, bytes + items.size() * sizeof(items[0]));
+			return section;
+		};
+		header.outlines = append(records);
+		header.vertices = append(vertices);
+
+		header.fileSize = static_cast<uint32_t>(file.size());
+		std::memcpy(file.data(), &header, sizeof(header));
+		return file;
+	}
+
+
+	inline void writeFile(const std::string& path, const std::vector<Outline>& outlines, float tolerance) {
+		auto binary = compile(outlines, tolerance);
+		std::ofstream out{ path, std::ios::binary };
+		if (!out.write(binary.data(), binary.size())) {
+			throw std::runtime_error{ "Cannot write " + path };
+		}
+	}
+
+}
+
+
+#endif
@@ -0,0 +1,80 @@
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "CollisionCooker.h"
+#include "CollisionFile.h"
+
+
+const char* USAGE = R"(Usage: CollisionCooker <input.obj> <output.col> [options]
+  --height <z>             height of the slicing plane, in the reference system of the hitbox (default 0)
+  --tolerance <distance>   maximum distance of the simplified outlines from the slice (default 0.01)
+  --rotation <x> <y> <z>   rotation of the model relative to its hitbox, in degrees, as in the model directive of the table (default 0 0 0)
+  --scale <s>              scale of the hitbox (default 1)
+  --largest                keep only the outline with the largest area
+  Slices a mesh at the height of the playfield and writes the simplified outlines as a collision asset, then loads it back to check it.
+)";
+
+
+
+int main(int argc, char* argv[]) {
+	if (argc < 3 || std::string{ argv[1] } == "--help") {
+		std::cout << USAGE;
+		return 1;
+	}
+
+	try {
+		const std::string inputPath = argv[1];
+		const std::string outputPath = argv[2];
+		CollisionCooker::CookSettings settings{};
+
+		//parse command line
+		for (int i = 3; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (option == "--largest") {
+				settings.largestOnly = true;
+				continue;
+			}
+			const int values = option == "--rotation" ? 3 : 1;
+			if (i + values >= argc) {
+				throw std::invalid_argument{ "Missing value for " + option };
+			}
+
+			if (option == "--height") settings.height = std::stof(argv[++i]);
+			else if (option == "--tolerance") settings.tolerance = std::stof(argv[++i]);
+			else if (option == "--scale") settings.scale = std::stof(argv[++i]);
+			else if (option == "--rotation") {
+				settings.rotation.x = std::stof(argv[++i]);
+				settings.rotation.y = std::stof(argv[++i]);
+				settings.rotation.z = std::stof(argv[++i]);
+			}
+			else throw std::invalid_argument{ "Unknown option " + option + "\n" + USAGE };
+		}
+		if (settings.tolerance < 0.0f) {
+			throw std::invalid_argument{ "The tolerance cannot be negative" };
+		}
+
+		auto mesh = CollisionCooker::readObj(inputPath, settings.rotation, settings.scale);
+		auto outlines = CollisionCooker::cook(mesh, settings);
+		if (outlines.empty()) {
+			throw std::runtime_error{ "The plane z = " + std::to_string(settings.height) + " doesn't cut " + inputPath };
+		}
+		CollisionCooker::writeFile(outputPath, outlines, settings.tolerance);
+
+		//the same checks done when the asset is loaded
+		Vulkan::Physics::CollisionFile cooked{ outputPath };
+		std::cout << outputPath << ": " << cooked.getOutlinesCount() << " outlines from " << mesh.triangles.size() / 3 << " triangles, tolerance " << settings.tolerance << "\n";
+		for (size_t i = 0; i < outlines.size(); ++i) {
+			std::cout << "  " << i << ": " << (cooked.isClosed(i) ? (cooked.isConvex(i) ? "convex loop" : "loop") : "chain") << ", " << outlines[i].slicedVertices << " -> " << outlines[i].vertices.size() << " vertices";
+			if (cooked.isClosed(i)) {
+				std::cout << ", area " << std::setprecision(4) << cooked.getOutline(i).area;
+			}
+			std::cout << "\n";
+		}
+
+	} catch (const std::exception& e) {
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}
@@ -0,0 +1,110 @@
+#ifndef HEADLESS_BATCHRUNNER
+#define HEADLESS_BATCHRUNNER
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.h"
+#include "HeadlessTable.h"
+#include "InputPolicies.h"
+
+
+namespace Headless {
+
+	/**
+	 * @brief The outcome of a single simulated game.
+	 */
+	struct GameResult {
+		uint64_t game;
+		uint64_t seed;
+		int points;
+		double ballLifetime;
+		TableCounters counters;
+		double simulatedSeconds;
+		bool timedOut; //the game was stopped before all the balls were lost
+	};
+
+
+	struct BatchSettings {
+		uint64_t games = 1000;
+		unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+		uint64_t seed = 1;
+		float timeStep = 1.0f / 10000.0f; //the same order of magnitude of the physics step of the game
+		double maxGameSeconds = 600.0;
+		TableSettings table{};
+	};
+
+
+
+	/**
+	 * @brief Runs many independent games on all the cores.
+	 * @details Each game is a job of a JobSystem and gets its own HeadlessTable and InputPolicy, so jobs share nothing but the (read only) table file. Results are stored by game index, therefore they don't depend on the number of threads.
+	 *			Each thread builds its tables in its own PhysicsArena, which is reset after every game, so games after the first one don't allocate the bodies of the table again.
+	 */
+	class BatchRunner {
+	public:
+
+		using PolicyFactory = std::function<std::unique_ptr<InputPolicy>(uint64_t seed)>;
+
+
+		BatchRunner(const Vulkan::Physics::TableFile& tableFile, const BatchSettings& settings, PolicyFactory makePolicy) : tableFile{ tableFile }, settings{ settings }, makePolicy{ std::move(makePolicy) } {}
+
+
+		std::vector<GameResult> run() const {
+			std::vector<GameResult> results(settings.games);
+
+			//the calling thread plays too, while it waits for the workers
+			Vulkan::Utilities::JobSystem jobs{ std::max(1u, settings.threads) - 1 };
+			std::vector<Vulkan::Physics::PhysicsArena> arenas(jobs.getWorkersCount() + 1); //one per thread index
+			jobs.parallelFor(0, settings.games, 1, [this, &results, &arenas, &jobs](size_t game) {
+				auto& arena = arenas[jobs.getThreadIndex()];
+				results[game] = play(game, &arena);
+				arena.reset();
+				}, "game");
+
+			return results;
+		}
+
+
+		/**
+		 * @brief Plays a single game, from the launch of the ball to the loss of the last one (or to maxGameSeconds).
+		 *
+		 * @param game The index of the game, which determines its seed.
+		 * @param arena If not null, the arena the table is built in. The caller resets it after the game.
+		 */
+		GameResult play(uint64_t game, Vulkan::Physics::PhysicsArena* arena = nullptr) const {
+			const uint64_t seed = splitMix(settings.seed + game);
+			auto policy = makePolicy(seed);
+			HeadlessTable table{ tableFile, settings.table, arena };
+
+			while (!table.isEnded() && table.getSimulatedTime() < settings.maxGameSeconds) {
+				table.advance(settings.timeStep, policy->nextInput(table));
+			}
+
+			return GameResult{ game, seed, table.getPoints(), table.getBallLifetime(), table.getCounters(), table.getSimulatedTime(), !table.isEnded() };
+		}
+
+
+	private:
+
+		//spreads consecutive seeds over the whole 64 bits space
+		static uint64_t splitMix(uint64_t x) {
+			x += 0x9E3779B97F4A7C15ull;
+			x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+			x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+			return x ^ (x >> 31);
+		}
+
+
+		const Vulkan::Physics::TableFile& tableFile;
+		BatchSettings settings;
+		PolicyFactory makePolicy;
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef HEADLESS_CSVREPORT
+#define HEADLESS_CSVREPORT
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BatchRunner.h"
+
+
+namespace Headless::CsvReport {
+
+	/**
+	 * @brief A quantity measured on each game, which gets its own distribution in the report.
+	 */
+	struct Metric {
+		std::string name;
+		double(*extract)(const GameResult&);
+	};
+
+	inline const std::vector<Metric> METRICS{
+		{ "points", [](const GameResult& r) { return double(r.points); } },
+		{ "ball_lifetime", [](const GameResult& r) { return r.ballLifetime; } },
+		{ "bumper_hits", [](const GameResult& r) { return double(r.counters.bumperHits); } },
+		{ "flipper_hits", [](const GameResult& r) { return double(r.counters.flipperHits); } },
+		{ "wall_hits", [](const GameResult& r) { return double(r.counters.wallHits); } }
+	};
+
+
+
+	inline std::ofstream openFile(const std::string& path) {
+		std::ofstream file{ path };
+		if (!file) {
+			throw std::runtime_error{ "Cannot write " + path };
+		}
+		return file;
+	}
+
+
+
+	/**
+	 * @brief Writes one row per game.
+	 */
+	inline void writeGames(const std::string& path, const std::vector<GameResult>& results) {
+		auto file = openFile(path);
+		file << "game,seed,points,ball_lifetime,bumper_hits,flipper_hits,wall_hits,balls_lost,simulated_seconds,timed_out\n";
+		for (const auto& r : results) {
+			file << r.game << "," << r.seed << "," << r.points << "," << r.ballLifetime << "," << r.counters.bumperHits << "," << r.counters.flipperHits << "," << r.counters.wallHits << "," << r.counters.ballsLost << "," << r.simulatedSeconds << "," << r.timedOut << "\n";
+		}
+	}
+
+
+
+	/**
+	 * @brief Writes, for each metric, an histogram with equally wide bins between the minimum and the maximum value.
+	 */
+	inline void writeDistributions(const std::string& path, const std::vector<GameResult>& results, int bins) {
+		auto file = openFile(path);
+		file << "metric,bin,lower,upper,count\n";
+		if (results.empty()) {
+			return;
+		}
+
+		for (const auto& metric : METRICS) {
+			auto [minIt, maxIt] = std::minmax_element(results.begin(), results.end(), [&metric](const GameResult& r1, const GameResult& r2) { return metric.extract(r1) < metric.extract(r2); });
+			const double min = metric.extract(*minIt);
+			const double width = std::max((metric.extract(*maxIt) - min) / bins, 1e-9);
+
+			std::vector<uint64_t> counts(bins, 0);
+			for (const auto& r : results) {
+				counts[std::min(bins - 1, int((metric.extract(r) - min) / width))]++;
+			}
+
+			for (int i = 0; i < bins; ++i) {
+				file << metric.name << "," << i << "," << min + width * i << "," << min + width * (i + 1) << "," << counts[i] << "\n";
+			}
+		}
+	}
+
+
+
+	/**
+	 * @brief Prints mean and percentiles of each metric, and the throughput of the simulation.
+	 */
+	inline void printSummary(std::ostream& out, const std::vector<GameResult>& results, double wallSeconds) {
+		double simulatedSeconds = 0.0;
+		uint64_t timedOut = 0;
+		for (const auto& r : results) {
+			simulatedSeconds += r.simulatedSeconds;
+			timedOut += r.timedOut;
+		}
+
+		out << std::fixed << std::setprecision(2);
+		out << results.size() << " games (" << timedOut << " timed out) in " << wallSeconds << " s\n";
+		out << "Throughput: " << (simulatedSeconds / 3600.0) / (wallSeconds / 60.0) << " simulated hours per wall-clock minute\n\n";
+
+		if (results.empty()) {
+			return;
+		}
+
+		out << std::left << std::setw(16) << "metric" << std::right << std::setw(12) << "mean" << std::setw(12) << "p10" << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+		for (const auto& metric : METRICS) {
+			std::vector<double> values;
+			values.reserve(results.size());
+			for (const auto& r : results) {
+				values.push_back(metric.extract(r));
+			}
+			std::sort(values.begin(), values.end());
+
+			double mean = 0.0;
+			for (auto v : values) {
+				mean += v / values.size();
+			}
+			auto percentile = [&values](double p) { return values[std::min(values.size() - 1, size_t(p * values.size()))]; };
+
+			out << std::left << std::setw(16) << metric.name << std::right << std::setw(12) << mean << std::setw(12) << percentile(0.1) << std::setw(12) << percentile(0.5) << std::setw(12) << percentile(0.9) << std::setw(12) << percentile(0.99) << std::setw(12) << values.back() << "\n";
+		}
+	}
+
+}
+
+
+#endif
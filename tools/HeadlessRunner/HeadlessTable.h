@@ -0,0 +1,229 @@
+#ifndef HEADLESS_HEADLESSTABLE
+#define HEADLESS_HEADLESSTABLE
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Table.h"
+#include "TableFile.h"
+#include "GameStatus.h"
+#include "TableControls.h"
+
+
+namespace Headless {
+
+	/**
+	 * @brief The "keys" held down during a physics step.
+	 */
+	struct TableInput {
+		bool leftPad = false;
+		bool rightPad = false;
+		bool puller = false;
+	};
+
+
+	/**
+	 * @brief The parameters of the table which can be tuned without recompiling.
+	 */
+	struct TableSettings {
+		std::optional<float> friction; //if empty, the friction of the table file
+		float flipperAngularSpeed = FLIPPER_ANGULAR_SPEED;
+	};
+
+
+	/**
+	 * @brief How many times the balls touched each kind of object. A contact which lasts more than one step counts as a single hit.
+	 */
+	struct TableCounters {
+		int bumperHits = 0;
+		int flipperHits = 0;
+		int wallHits = 0;
+		int ballsLost = 0;
+	};
+
+
+
+	/**
+	 * @brief A table without any graphics: the same Table and GameStatus the game builds, driven by a TableInput instead of the keyboard.
+	 * @details A HeadlessTable is not thread safe, but different instances only share the (read only) TableFile, so each thread can simulate its own game.
+	 */
+	class HeadlessTable {
+	public:
+
+		/**
+		 * @param file The table to play.
+		 * @param settings The parameters of the table which are not taken from the file.
+		 * @param arena If not null, the arena the table is built in (see Vulkan::Physics::Table).
+		 */
+		HeadlessTable(const Vulkan::Physics::TableFile& file, const TableSettings& settings = {}, Vulkan::Physics::PhysicsArena* arena = nullptr) :
+			settings{ settings },
+			lights{},
+			table{ file, arena },
+			gameStatus{ table.getBalls(), table.getBumpers(), lights, table.getGameUniverse() },
+			counters{}, step{ 0 }, simulatedTime{ 0.0 }, launchTime{ -1.0 }, endTime{ -1.0 } {
+
+			if (settings.friction) {
+				table.setFieldIntensity(Vulkan::Physics::TableFormat::FieldType::FRICTION, *settings.friction);
+			}
+
+			//what each hitbox counts as when a ball touches it
+			hitKinds.resize(table.getHitboxesCount(), HitKind::NONE);
+			for (uint32_t i = 0; i < table.getHitboxesCount(); ++i) {
+				auto& hitbox = table.getHitbox(i);
+				auto action = table.getCollisionAction(i);
+				if (&hitbox == &table.getLeftPad() || &hitbox == &table.getRightPad()) {
+					hitKinds[i] = HitKind::FLIPPER;
+				}
+				else if (std::find(table.getBumpers().begin(), table.getBumpers().end(), &hitbox) != table.getBumpers().end()) {
+					hitKinds[i] = HitKind::BUMPER;
+				}
+				else if (action == Vulkan::Physics::TableFormat::CollisionAction::KILL_BALL) {
+					hitKinds[i] = HitKind::KILLER;
+				}
+				else if (action == Vulkan::Physics::TableFormat::CollisionAction::START_GAME) {
+					hitKinds[i] = HitKind::STARTER;
+				}
+				else if (action == Vulkan::Physics::TableFormat::CollisionAction::NONE && dynamic_cast<Vulkan::Physics::CircleHitbox*>(&hitbox) == nullptr) {
+					hitKinds[i] = HitKind::WALL;
+				}
+			}
+
+			//collision actions (the same of the game, plus the counters)
+			table.bindCollisionActions(gameStatus, [this](uint32_t i, Vulkan::Physics::Hitbox&) {
+				switch (hitKinds[i]) {
+				case HitKind::BUMPER: countHit(counters.bumperHits, lastBumperContact); break;
+				case HitKind::FLIPPER: countHit(counters.flipperHits, lastFlipperContact); break;
+				case HitKind::WALL: countHit(counters.wallHits, lastWallContact); break;
+				case HitKind::KILLER: counters.ballsLost++; break;
+				case HitKind::STARTER:
+					if (gameStatus.isGameOver() && launchTime < 0.0) {
+						launchTime = simulatedTime;
+					}
+					break;
+				default: break;
+				}
+				});
+
+			universes = table.getUniverses();
+		}
+
+		HeadlessTable(const HeadlessTable&) = delete;
+		HeadlessTable& operator=(const HeadlessTable&) = delete;
+
+
+
+		/**
+		 * @brief Advances the simulation by a fixed time step, in the same order the game does: pads fall, input is applied, universes are calculated.
+		 *
+		 * @param elapsedSeconds The time step. Using always the same time step makes the simulation deterministic.
+		 * @param input The keys held down during this step.
+		 */
+		void advance(float elapsedSeconds, const TableInput& input) {
+			Vulkan::Animations::lowerPads(table.getLeftPad(), table.getRightPad(), settings.flipperAngularSpeed);
+
+			if (input.rightPad) {
+				Vulkan::Animations::raiseRightPad(table.getRightPad(), settings.flipperAngularSpeed);
+			}
+			if (input.leftPad) {
+				Vulkan::Animations::raiseLeftPad(table.getLeftPad(), settings.flipperAngularSpeed);
+			}
+			if (input.puller) {
+				Vulkan::Animations::pullPuller(table.getPuller(), table.getPullerRestingPosition());
+			}
+
+			for (auto universe : universes) {
+				universe->calculate(elapsedSeconds);
+			}
+
+			step++;
+			simulatedTime += elapsedSeconds;
+
+			if (isLaunched() && !isEnded() && gameStatus.isGameOver()) {
+				endTime = simulatedTime;
+			}
+		}
+
+
+
+		bool isLaunched() const {
+			return launchTime >= 0.0;
+		}
+
+		bool isEnded() const {
+			return endTime >= 0.0;
+		}
+
+		double getSimulatedTime() const {
+			return simulatedTime;
+		}
+
+		/**
+		 * @brief Returns for how long the balls have been in play, from the launch to the end of the game (or to now, if the game is still going on).
+		 */
+		double getBallLifetime() const {
+			if (!isLaunched()) {
+				return 0.0;
+			}
+			return (isEnded() ? endTime : simulatedTime) - launchTime;
+		}
+
+		int getPoints() const {
+			return gameStatus.getPoints();
+		}
+
+		const TableCounters& getCounters() const {
+			return counters;
+		}
+
+		const std::vector<Vulkan::Physics::Hitbox*>& getBalls() const {
+			return table.getBalls();
+		}
+
+		const Vulkan::Physics::Hitbox& getLeftFlipper() const {
+			return table.getLeftPad();
+		}
+
+		const Vulkan::Physics::Hitbox& getRightFlipper() const {
+			return table.getRightPad();
+		}
+
+
+	private:
+
+		//counts a hit only if the contact didn't already happen during the previous step
+		void countHit(int& counter, long long& lastContact) {
+			if (lastContact != step && lastContact != step - 1) {
+				counter++;
+			}
+			lastContact = step;
+		}
+
+
+		enum class HitKind { NONE, BUMPER, FLIPPER, WALL, KILLER, STARTER };
+
+
+		TableSettings settings;
+		Lights lights; //GameStatus switches lights on and off, nobody looks at them here
+
+		Vulkan::Physics::Table table;
+		std::vector<Vulkan::Physics::Universe*> universes;
+		GameStatus gameStatus;
+		std::vector<HitKind> hitKinds; //by hitbox index
+
+		TableCounters counters;
+		long long lastBumperContact = -2;
+		long long lastFlipperContact = -2;
+		long long lastWallContact = -2;
+
+		long long step;
+		double simulatedTime; //double, because adding small time steps to a float stops working after a few minutes of simulated time
+		double launchTime;
+		double endTime;
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef HEADLESS_INPUTPOLICIES
+#define HEADLESS_INPUTPOLICIES
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "HeadlessTable.h"
+
+
+namespace Headless {
+
+	/**
+	 * @brief An InputPolicy plays the role of the player: at each step it decides which keys are held down.
+	 */
+	class InputPolicy {
+	public:
+		virtual ~InputPolicy() = default;
+
+		virtual TableInput nextInput(const HeadlessTable& table) = 0;
+	};
+
+
+
+	/**
+	 * @brief A player who mashes the keys at random: the puller is held for a random time, then each pad is pressed and released after random intervals.
+	 */
+	class RandomPolicy : public InputPolicy {
+	public:
+		RandomPolicy(uint64_t seed) : random{ seed }, pullTime{ std::uniform_real_distribution<double>{ 0.2, 1.5 }(random) }, leftPad{}, rightPad{} {
+			leftPad.nextToggle = nextRelease();
+			rightPad.nextToggle = nextRelease();
+		}
+
+
+		TableInput nextInput(const HeadlessTable& table) override {
+			const double time = table.getSimulatedTime();
+			return TableInput{ update(leftPad, time), update(rightPad, time), !table.isLaunched() && time < pullTime };
+		}
+
+
+	private:
+		struct Pad {
+			bool pressed = false;
+			double nextToggle = 0.0;
+		};
+
+		bool update(Pad& pad, double time) {
+			if (time >= pad.nextToggle) {
+				pad.pressed = !pad.pressed;
+				pad.nextToggle = time + (pad.pressed ? std::uniform_real_distribution<double>{ 0.05, 0.3 }(random) : nextRelease());
+			}
+			return pad.pressed;
+		}
+
+		//time between two presses of the same pad
+		double nextRelease() {
+			return std::exponential_distribution<double>{ 1.0 / 0.8 }(random);
+		}
+
+		std::mt19937_64 random;
+		double pullTime;
+		Pad leftPad;
+		Pad rightPad;
+	};
+
+
+
+	/**
+	 * @brief A simple bot: it launches the ball with a random strength, and flips the pad on the side of any ball which is falling close to the pads.
+	 */
+	class BotPolicy : public InputPolicy {
+	public:
+		BotPolicy(uint64_t seed) : random{ seed }, pullTime{ std::uniform_real_distribution<double>{ 0.6, 1.5 }(random) }, holdTime{ std::uniform_real_distribution<double>{ 0.08, 0.2 }(random) }, leftReleaseTime{ -1.0 }, rightReleaseTime{ -1.0 } {}
+
+
+		TableInput nextInput(const HeadlessTable& table) override {
+			const double time = table.getSimulatedTime();
+			const float middle = (table.getLeftFlipper().getPosition().x() + table.getRightFlipper().getPosition().x()) / 2.0f;
+			const float padsY = table.getRightFlipper().getPosition().y();
+
+			for (auto ball : table.getBalls()) {
+				const auto position = ball->getPosition();
+				const bool isInPadsArea = position.y() < padsY + 1.0f && position.y() > padsY - 0.5f && std::abs(position.x()) < 10.0f; //resting balls are far away
+				if (isInPadsArea && ball->getSpeed().y() < 0.0f) {
+					if (position.x() < middle) {
+						leftReleaseTime = time + holdTime;
+					}
+					else {
+						rightReleaseTime = time + holdTime;
+					}
+				}
+			}
+
+			return TableInput{ time < leftReleaseTime, time < rightReleaseTime, !table.isLaunched() && time < pullTime };
+		}
+
+
+	private:
+		std::mt19937_64 random;
+		double pullTime;
+		double holdTime;
+		double leftReleaseTime;
+		double rightReleaseTime;
+	};
+
+
+
+	/**
+	 * @brief The keys pressed and released during a game, read from a text file.
+	 * @details Each line of the file is "<seconds> <left|right|puller> <press|release>". Empty lines and lines starting with # are ignored.
+	 */
+	class InputScript {
+	public:
+
+		struct Event {
+			double time;
+			int key; //0 = left pad, 1 = right pad, 2 = puller
+			bool pressed;
+		};
+
+
+		InputScript(const std::string& path) {
+			std::ifstream file{ path };
+			if (!file) {
+				throw std::runtime_error{ "Cannot open script " + path };
+			}
+
+			std::string line;
+			for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+				if (line.empty() || line[0] == '#') {
+					continue;
+				}
+
+				std::istringstream tokens{ line };
+				Event event{};
+				std::string key, action;
+				if (!(tokens >> event.time >> key >> action)) {
+					throw std::runtime_error{ path + ":" + std::to_string(lineNumber) + ": expected <seconds> <key> <action>" };
+				}
+
+				if (key == "left") event.key = 0;
+				else if (key == "right") event.key = 1;
+				else if (key == "puller") event.key = 2;
+				else throw std::runtime_error{ path + ":" + std::to_string(lineNumber) + ": unknown key " + key };
+
+				if (action == "press") event.pressed = true;
+				else if (action == "release") event.pressed = false;
+				else throw std::runtime_error{ path + ":" + std::to_string(lineNumber) + ": unknown action " + action };
+
+				events.push_back(event);
+			}
+
+			std::stable_sort(events.begin(), events.end(), [](const Event& e1, const Event& e2) { return e1.time < e2.time; });
+		}
+
+
+		const std::vector<Event>& getEvents() const {
+			return events;
+		}
+
+
+	private:
+		std::vector<Event> events;
+	};
+
+
+
+	/**
+	 * @brief Plays an InputScript. Each event can be moved by a random amount of time, so that the same script produces different games.
+	 */
+	class ScriptPolicy : public InputPolicy {
+	public:
+		ScriptPolicy(const InputScript& script, double jitter, uint64_t seed) : events{ script.getEvents() }, nextEvent{ 0 }, input{} {
+			if (jitter > 0.0) {
+				std::mt19937_64 random{ seed };
+				std::uniform_real_distribution<double> offset{ -jitter, jitter };
+				for (auto& event : events) {
+					event.time = std::max(0.0, event.time + offset(random));
+				}
+				std::stable_sort(events.begin(), events.end(), [](const InputScript::Event& e1, const InputScript::Event& e2) { return e1.time < e2.time; });
+			}
+		}
+
+
+		TableInput nextInput(const HeadlessTable& table) override {
+			for (; nextEvent < events.size() && events[nextEvent].time <= table.getSimulatedTime(); ++nextEvent) {
+				const auto& event = events[nextEvent];
+				bool& key = event.key == 0 ? input.leftPad : event.key == 1 ? input.rightPad : input.puller;
+				key = event.pressed;
+			}
+			return input;
+		}
+
+
+	private:
+		std::vector<InputScript::Event> events;
+		size_t nextEvent;
+		TableInput input;
+	};
+
+}
+
+
+#endif
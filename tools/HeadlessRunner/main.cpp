@@ -0,0 +1,105 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "BatchRunner.h"
+#include "CsvReport.h"
+#include "InputPolicies.h"
+
+
+const char* USAGE = R"(Usage: PinballHeadless [options]
+  --table <path>           binary table to play (default tables/reference.tbl)
+  --games <n>              number of games to simulate (default 1000)
+  --threads <n>            worker threads (default: all the cores)
+  --seed <n>               base seed, game i uses a seed derived from seed + i (default 1)
+  --policy <name>          random | bot | script (default random)
+  --script <path>          input script, used by the script policy
+  --jitter <seconds>       random offset applied to each event of the script (default 0)
+  --time-step <seconds>    fixed physics step (default 0.0001)
+  --max-game-seconds <s>   games longer than this are stopped (default 600)
+  --friction <mu>          friction coefficient of the table (default: the one of the table file)
+  --flipper-speed <rad/s>  angular speed of the pads
+  --games-csv <path>       per game results (default games.csv)
+  --distributions-csv <p>  histograms of the results (default distributions.csv)
+  --bins <n>               bins of each histogram (default 20)
+)";
+
+
+
+int main(int argc, char* argv[]) {
+	try {
+		Headless::BatchSettings settings{};
+		std::string tablePath = "tables/reference.tbl";
+		std::string policyName = "random";
+		std::string scriptPath;
+		double jitter = 0.0;
+		std::string gamesCsv = "games.csv";
+		std::string distributionsCsv = "distributions.csv";
+		int bins = 20;
+
+		//parse command line
+		for (int i = 1; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (option == "--help") {
+				std::cout << USAGE;
+				return 0;
+			}
+			if (i + 1 >= argc) {
+				throw std::invalid_argument{ "Missing value for " + option };
+			}
+
+			const std::string value = argv[++i];
+			if (option == "--table") tablePath = value;
+			else if (option == "--games") settings.games = std::stoull(value);
+			else if (option == "--threads") settings.threads = std::max(1, std::stoi(value));
+			else if (option == "--seed") settings.seed = std::stoull(value);
+			else if (option == "--policy") policyName = value;
+			else if (option == "--script") scriptPath = value;
+			else if (option == "--jitter") jitter = std::stod(value);
+			else if (option == "--time-step") settings.timeStep = std::stof(value);
+			else if (option == "--max-game-seconds") settings.maxGameSeconds = std::stod(value);
+			else if (option == "--friction") settings.table.friction = std::stof(value);
+			else if (option == "--flipper-speed") settings.table.flipperAngularSpeed = std::stof(value);
+			else if (option == "--games-csv") gamesCsv = value;
+			else if (option == "--distributions-csv") distributionsCsv = value;
+			else if (option == "--bins") bins = std::max(1, std::stoi(value));
+			else throw std::invalid_argument{ "Unknown option " + option + "\n" + USAGE };
+		}
+
+		//choose the player
+		Headless::BatchRunner::PolicyFactory makePolicy;
+		if (policyName == "random") {
+			makePolicy = [](uint64_t seed) { return std::make_unique<Headless::RandomPolicy>(seed); };
+		}
+		else if (policyName == "bot") {
+			makePolicy = [](uint64_t seed) { return std::make_unique<Headless::BotPolicy>(seed); };
+		}
+		else if (policyName == "script") {
+			auto script = std::make_shared<Headless::InputScript>(scriptPath);
+			makePolicy = [script, jitter](uint64_t seed) { return std::make_unique<Headless::ScriptPolicy>(*script, jitter, seed); };
+		}
+		else {
+			throw std::invalid_argument{ "Unknown policy " + policyName };
+		}
+
+		//the table is mapped once and shared by all the games
+		Vulkan::Physics::TableFile tableFile{ tablePath };
+
+		//play
+		std::cout << "Simulating " << settings.games << " games with the " << policyName << " policy on " << settings.threads << " threads...\n";
+		auto start = std::chrono::steady_clock::now();
+		auto results = Headless::BatchRunner{ tableFile, settings, makePolicy }.run();
+		double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		//report
+		Headless::CsvReport::writeGames(gamesCsv, results);
+		Headless::CsvReport::writeDistributions(distributionsCsv, results, bins);
+		Headless::CsvReport::printSummary(std::cout, results, wallSeconds);
+
+	} catch (const std::exception& e) {
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}
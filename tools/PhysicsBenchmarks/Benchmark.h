@@ -0,0 +1,133 @@
+#ifndef BENCHMARKS_BENCHMARK
+#define BENCHMARKS_BENCHMARK
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace Benchmarks {
+
+	/**
+	 * @brief Prevents the compiler from optimizing away the computation of a value.
+	 */
+	template<typename T>
+	void doNotOptimize(const T& value) {
+		static volatile char sink;
+		const volatile char* bytes = reinterpret_cast<const volatile char*>(&value);
+		sink = bytes[0];
+		sink = bytes[sizeof(T) - 1];
+	}
+
+
+
+	/**
+	 * @brief A timed run of a benchmark: the benchmark must perform its operation getIterations() times.
+	 * @details The timer starts when the batch is created. A benchmark which needs an expensive setup (e.g. loading a table) does it first, then calls restartTimer.
+	 */
+	class Batch {
+	public:
+		Batch(uint64_t iterations) : iterations{ iterations }, start{ std::chrono::steady_clock::now() } {}
+
+		uint64_t getIterations() const {
+			return iterations;
+		}
+
+		void restartTimer() {
+			start = std::chrono::steady_clock::now();
+		}
+
+		double getElapsedSeconds() const {
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+	private:
+		uint64_t iterations;
+		std::chrono::steady_clock::time_point start;
+	};
+
+
+
+	struct BenchmarkSettings {
+		double minBatchSeconds = 0.1; //a batch is repeated with more iterations until it lasts this long
+		int repetitions = 5;
+		std::string filter; //only benchmarks whose name contains this string are run
+	};
+
+
+	struct Result {
+		std::string name;
+		uint64_t iterations; //per repetition
+		int repetitions;
+		double nsPerOp; //median among the repetitions
+		double minNsPerOp;
+		double maxNsPerOp;
+	};
+
+
+
+	/**
+	 * @brief A list of named benchmarks. Each one is calibrated (the iterations grow until a batch lasts long enough), then repeated and summarized by its median.
+	 */
+	class Suite {
+	public:
+
+		using Function = std::function<void(Batch&)>;
+
+
+		void add(std::string name, Function function) {
+			benchmarks.emplace_back(std::move(name), std::move(function));
+		}
+
+
+		std::vector<Result> run(const BenchmarkSettings& settings, std::ostream& log) const {
+			std::vector<Result> results;
+			for (const auto& [name, function] : benchmarks) {
+				if (name.find(settings.filter) == std::string::npos) {
+					continue;
+				}
+				log << name << "... " << std::flush;
+
+				//calibration
+				uint64_t iterations = 1;
+				double seconds = runBatch(function, iterations);
+				while (seconds < settings.minBatchSeconds) {
+					double growth = seconds > 0.0 ? std::clamp(1.4 * settings.minBatchSeconds / seconds, 1.5, 100.0) : 100.0;
+					iterations = static_cast<uint64_t>(iterations * growth) + 1;
+					seconds = runBatch(function, iterations);
+				}
+
+				//measure
+				std::vector<double> nsPerOp;
+				for (int i = 0; i < std::max(1, settings.repetitions); ++i) {
+					nsPerOp.push_back(runBatch(function, iterations) * 1e9 / iterations);
+				}
+				std::sort(nsPerOp.begin(), nsPerOp.end());
+
+				results.push_back(Result{ name, iterations, static_cast<int>(nsPerOp.size()), nsPerOp[nsPerOp.size() / 2], nsPerOp.front(), nsPerOp.back() });
+				log << results.back().nsPerOp << " ns/op\n";
+			}
+			return results;
+		}
+
+
+	private:
+
+		static double runBatch(const Function& function, uint64_t iterations) {
+			Batch batch{ iterations };
+			function(batch);
+			return batch.getElapsedSeconds();
+		}
+
+
+		std::vector<std::pair<std::string, Function>> benchmarks;
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef BENCHMARKS_JOBBENCHMARKS
+#define BENCHMARKS_JOBBENCHMARKS
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "JobSystem.h"
+
+
+/**
+ * @brief The benchmarks of the JobSystem: the cost of scheduling a job, measured with jobs which do (almost) nothing.
+ * @details An operation is a single job (or task), from its submission to the end of the wait, so the result is the overhead a job adds to its work. The job system is shared by the benchmarks and its workers are started before the first batch.
+ */
+namespace Benchmarks::Jobs {
+
+	using namespace Vulkan::Utilities;
+
+
+	inline void addJobSystemBenchmarks(Suite& suite, unsigned int workers) {
+		auto jobs = std::make_shared<JobSystem>(workers);
+		const std::string suffix = "/" + std::to_string(workers) + "workers";
+
+		//one job at a time: the latency of a round trip to a worker
+		suite.add("JobSystem/submit+wait" + suffix, [jobs](Batch& batch) {
+			JobCounter counter;
+			uint64_t done = 0;
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				jobs->submit(counter, [&done]() { done++; });
+				jobs->wait(counter);
+			}
+			doNotOptimize(done);
+			});
+
+		//many jobs at a time: the throughput of the queues
+		suite.add("JobSystem/submit-many+wait" + suffix, [jobs](Batch& batch) {
+			JobCounter counter;
+			std::atomic<uint64_t> done{ 0 };
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				jobs->submit(counter, [&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+			}
+			jobs->wait(counter);
+			doNotOptimize(done.load());
+			});
+
+		suite.add("JobSystem/parallelFor" + suffix, [jobs](Batch& batch) {
+			std::atomic<uint64_t> done{ 0 };
+			jobs->parallelFor(0, batch.getIterations(), 1, [&done](size_t) { done.fetch_add(1, std::memory_order_relaxed); });
+			doNotOptimize(done.load());
+			});
+
+		//a diamond (one task, 14 independent tasks, one task) run many times, as a frame would be
+		const int DIAMOND = 16;
+		auto done = std::make_shared<std::atomic<uint64_t>>(0);
+		auto graph = std::make_shared<TaskGraph>();
+		auto count = [done]() { done->fetch_add(1, std::memory_order_relaxed); };
+		auto first = graph->add(count);
+		std::vector<TaskGraph::TaskId> middle;
+		for (int i = 0; i < DIAMOND - 2; ++i) {
+			middle.push_back(graph->add(count, { first }));
+		}
+		graph->add(count, middle);
+		suite.add("JobSystem/graph" + suffix, [jobs, graph, done](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); i += DIAMOND) {
+				jobs->run(*graph);
+			}
+			doNotOptimize(done->load());
+			});
+	}
+
+}
+
+
+#endif
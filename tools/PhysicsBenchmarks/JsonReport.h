@@ -0,0 +1,128 @@
+#ifndef BENCHMARKS_JSONREPORT
+#define BENCHMARKS_JSONREPORT
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+
+namespace Benchmarks::JsonReport {
+
+	/**
+	 * @brief The result of a benchmark compared with the same benchmark of a previous run.
+	 */
+	struct Comparison {
+		std::string name;
+		double baselineNsPerOp;
+		double nsPerOp;
+
+		double getChange() const {
+			return nsPerOp / baselineNsPerOp - 1.0;
+		}
+	};
+
+
+
+	inline std::string escape(const std::string& text) {
+		std::string res;
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				res += '\\';
+			}
+			res += c;
+		}
+		return res;
+	}
+
+
+
+	/**
+	 * @brief Writes the results, and their comparison with the baseline if there is any.
+	 * @details The format is meant to be read back by readBaseline: one object per benchmark, each with a name and its median time.
+	 *
+	 * @param out Where the report is written.
+	 * @param context Pairs of strings describing the run (e.g. the settings of the benchmarks).
+	 * @param results The results of the run.
+	 * @param comparisons The comparisons with the baseline, if any.
+	 */
+	inline void write(std::ostream& out, const std::map<std::string, std::string>& context, const std::vector<Result>& results, const std::vector<Comparison>& comparisons = {}) {
+		out << "{\n\t\"context\": {";
+		for (auto it = context.begin(); it != context.end(); ++it) {
+			out << (it == context.begin() ? "\n" : ",\n") << "\t\t\"" << escape(it->first) << "\": \"" << escape(it->second) << "\"";
+		}
+		out << "\n\t},\n\t\"benchmarks\": [";
+
+		for (size_t i = 0; i < results.size(); ++i) {
+			const auto& r = results[i];
+			out << (i == 0 ? "\n" : ",\n") << "\t\t{ \"name\": \"" << escape(r.name) << "\", \"iterations\": " << r.iterations << ", \"repetitions\": " << r.repetitions
+				<< ", \"ns_per_op\": " << r.nsPerOp << ", \"min_ns_per_op\": " << r.minNsPerOp << ", \"max_ns_per_op\": " << r.maxNsPerOp;
+			for (const auto& c : comparisons) {
+				if (c.name == r.name) {
+					out << ", \"baseline_ns_per_op\": " << c.baselineNsPerOp << ", \"change\": " << c.getChange();
+				}
+			}
+			out << " }";
+		}
+		out << "\n\t]\n}\n";
+	}
+
+
+	inline void writeFile(const std::string& path, const std::map<std::string, std::string>& context, const std::vector<Result>& results, const std::vector<Comparison>& comparisons = {}) {
+		std::ofstream file{ path };
+		if (!file) {
+			throw std::runtime_error{ "Cannot write " + path };
+		}
+		write(file, context, results, comparisons);
+	}
+
+
+
+	/**
+	 * @brief Reads the median time of each benchmark from a report written by write. Throws std::runtime_error if the file cannot be read or contains no benchmarks.
+	 */
+	inline std::map<std::string, double> readBaseline(const std::string& path) {
+		std::ifstream file{ path };
+		if (!file) {
+			throw std::runtime_error{ "Cannot read " + path };
+		}
+		std::string text{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+
+		std::map<std::string, double> baseline;
+		static const std::regex entry{ R"re("name"\s*:\s*"((?:[^"\\]|\\.)*)"[^}]*?"ns_per_op"\s*:\s*([-+0-9.eE]+))re" };
+		for (auto it = std::sregex_iterator{ text.begin(), text.end(), entry }; it != std::sregex_iterator{}; ++it) {
+			std::string name = std::regex_replace((*it)[1].str(), std::regex{ R"(\\(.))" }, "$1");
+			baseline[name] = std::stod((*it)[2].str());
+		}
+		if (baseline.empty()) {
+			throw std::runtime_error{ path + " contains no benchmarks" };
+		}
+		return baseline;
+	}
+
+
+
+	/**
+	 * @brief Pairs each result with the same benchmark of the baseline. Benchmarks missing from the baseline are skipped.
+	 */
+	inline std::vector<Comparison> compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline) {
+		std::vector<Comparison> comparisons;
+		for (const auto& r : results) {
+			auto found = baseline.find(r.name);
+			if (found != baseline.end() && found->second > 0.0) {
+				comparisons.push_back(Comparison{ r.name, found->second, r.nsPerOp });
+			}
+		}
+		return comparisons;
+	}
+
+}
+
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef BENCHMARKS_MEMORYBENCHMARKS
+#define BENCHMARKS_MEMORYBENCHMARKS
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "BuddyAllocator.h"
+
+
+/**
+ * @brief The benchmarks of the sub-allocator of the device memory blocks (the BuddyAllocator of the MemoryAllocator): an operation is an allocation and its free.
+ * @details The block is a 64 MiB block, as MemoryAllocator::BLOCK_SIZE, with 256 bytes nodes at least. The sizes of the requests are those of buffers and small images, from 256 bytes to 64 KiB, so that the resources alive always fit in the block.
+ */
+namespace Benchmarks::Memory {
+
+	using namespace Vulkan::Utilities;
+
+	constexpr uint64_t BLOCK_SIZE = uint64_t{ 64 } << 20;
+	constexpr uint64_t MIN_NODE_SIZE = 256;
+
+
+	inline void addMemoryAllocatorBenchmarks(Suite& suite) {
+		//the best case: the node is split from the whole block and merged back each time
+		suite.add("Memory/buddy-allocate+free", [](Batch& batch) {
+			BuddyAllocator allocator{ BLOCK_SIZE, MIN_NODE_SIZE };
+			uint64_t offsets = 0;
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				auto node = allocator.allocate(4096, 256);
+				offsets += node->offset;
+				allocator.free(*node);
+			}
+			doNotOptimize(offsets);
+			});
+
+		//a fragmented block: a thousand resources alive, and each operation frees a random one and allocates a new one
+		{
+			const size_t alive = 1000;
+			auto sizes = std::make_shared<std::vector<uint64_t>>();
+			std::mt19937 random{ 42 };
+			for (int i = 0; i < 4096; ++i) {
+				sizes->push_back(uint64_t{ 256 } << std::uniform_int_distribution<int>{ 0, 8 }(random));
+			}
+
+			suite.add("Memory/buddy-churn/" + std::to_string(alive) + "alive", [sizes, alive](Batch& batch) {
+				BuddyAllocator allocator{ BLOCK_SIZE, MIN_NODE_SIZE };
+				std::vector<BuddyAllocator::Node> nodes;
+				for (size_t i = 0; i < alive; ++i) {
+					nodes.push_back(*allocator.allocate((*sizes)[i % sizes->size()]));
+				}
+
+				for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+					auto& node = nodes[(i * 7919) % alive];
+					allocator.free(node);
+					node = *allocator.allocate((*sizes)[i % sizes->size()]);
+				}
+				doNotOptimize(allocator.getUsed());
+				});
+		}
+	}
+
+}
+
+
+#endif
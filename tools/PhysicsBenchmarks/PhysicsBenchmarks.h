@@ -0,0 +1,224 @@
+#ifndef BENCHMARKS_PHYSICSBENCHMARKS
+#define BENCHMARKS_PHYSICSBENCHMARKS
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Foundations.h"
+#include "Segment.h"
+#include "Hitbox.h"
+#include "Universe.h"
+#include "PhysicsStats.h"
+#include "Table.h"
+#include "TableFile.h"
+#include "GameStatus.h"
+#include "TableCompiler.h"
+#include "TableGenerator.h"
+
+
+/**
+ * @brief The benchmarks of the physics: the arithmetic of Foundations, the geometry of Segment and of the hitboxes, Cinematicable::move and whole Universe steps on real tables.
+ * @details Micro benchmarks cycle over a fixed set of random inputs (always generated with the same seed), so that the compiler cannot fold the operation into a constant and every run measures the same work.
+ */
+namespace Benchmarks::Physics {
+
+	using namespace Vulkan::Physics;
+
+
+	const size_t INPUTS = 1024; //power of 2, so the next input is picked with a mask
+	const uint64_t INPUTS_SEED = 42;
+	const float TIME_STEP = 0.0001f; //the same order of magnitude of the steps of the game
+
+
+
+	/**
+	 * @brief The random inputs shared by the micro benchmarks.
+	 */
+	struct Inputs {
+		std::vector<Position> positions;
+		std::vector<DeltaSpace> deltas;
+		std::vector<Force> forces;
+		std::vector<float> scalars;
+
+		Inputs() {
+			std::mt19937_64 random{ INPUTS_SEED };
+			std::uniform_real_distribution<float> coordinate{ -5.0f, 5.0f };
+			std::uniform_real_distribution<float> scalar{ 0.1f, 5.0f };
+			for (size_t i = 0; i < INPUTS; ++i) {
+				positions.emplace_back(coordinate(random), coordinate(random), 0.0f);
+				deltas.emplace_back(coordinate(random), coordinate(random), 0.0f);
+				forces.emplace_back(coordinate(random), coordinate(random), 0.0f);
+				scalars.push_back(scalar(random));
+			}
+		}
+	};
+
+
+
+	inline void addFoundationsBenchmarks(Suite& suite, std::shared_ptr<const Inputs> in) {
+		suite.add("Foundations/Position+DeltaSpace", [in](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(in->positions[i & (INPUTS - 1)] + in->deltas[i & (INPUTS - 1)]);
+			}
+			});
+
+		suite.add("Foundations/Force*float", [in](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(in->forces[i & (INPUTS - 1)] * in->scalars[i & (INPUTS - 1)]);
+			}
+			});
+
+		suite.add("Foundations/dot", [in](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(in->forces[i & (INPUTS - 1)] * in->deltas[(i + 1) & (INPUTS - 1)]);
+			}
+			});
+
+		suite.add("Foundations/compare<=>float", [in](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(in->deltas[i & (INPUTS - 1)] <=> in->scalars[i & (INPUTS - 1)]);
+			}
+			});
+
+		suite.add("Foundations/compare<=>vector", [in](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(in->deltas[i & (INPUTS - 1)] <=> in->deltas[(i + 1) & (INPUTS - 1)]);
+			}
+			});
+	}
+
+
+
+	inline void addGeometryBenchmarks(Suite& suite, std::shared_ptr<const Inputs> in) {
+		auto segments = std::make_shared<std::vector<Segment>>();
+		for (size_t i = 0; i < INPUTS; ++i) {
+			segments->emplace_back(in->positions[i], in->positions[(i + 1) & (INPUTS - 1)]);
+		}
+
+		suite.add("Segment/distance", [in, segments](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize((*segments)[i & (INPUTS - 1)].distance(in->positions[(i + 7) & (INPUTS - 1)]));
+			}
+			});
+
+		suite.add("Segment/normal(point)", [in, segments](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize((*segments)[i & (INPUTS - 1)].normal(in->positions[(i + 7) & (INPUTS - 1)]));
+			}
+			});
+
+		suite.add("Segment/normal", [segments](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize((*segments)[i & (INPUTS - 1)].normal());
+			}
+			});
+
+		//a rotated box, like the walls of the generated tables
+		auto frame = std::make_shared<FrameHitbox>(Position{ 1.0f, 2.0f, 0.0f }, 1.0f, std::vector<Position>{ { -1.0f, -1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { -1.0f, 1.0f, 0.0f }, { -1.0f, -1.0f, 0.0f } });
+		frame->rotate(0.5f, { 0.0f, 0.0f, 1.0f });
+		suite.add("FrameHitbox/operator[]", [frame](Batch& batch) {
+			const int segmentsCount = frame->getNumberOfSegments();
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize((*frame)[static_cast<int>(i % segmentsCount)]);
+			}
+			});
+
+		//the same box as a ConvexPolygonHitbox: one separating axis test instead of a distance test per segment
+		auto polygon = std::make_shared<ConvexPolygonHitbox>(Position{ 1.0f, 2.0f, 0.0f }, 1.0f, std::vector<Position>{ { -1.0f, -1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { -1.0f, 1.0f, 0.0f } });
+		polygon->rotate(0.5f, { 0.0f, 0.0f, 1.0f });
+		suite.add("Collision/box-circle/frame", [in, frame](Batch& batch) {
+			const int segmentsCount = frame->getNumberOfSegments();
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				bool touches = false;
+				for (int s = 0; s < segmentsCount; ++s) {
+					touches |= (*frame)[s].distance(in->positions[i & (INPUTS - 1)]) <= 0.2f;
+				}
+				doNotOptimize(touches);
+			}
+			});
+
+		suite.add("Collision/box-circle/polygon", [in, polygon](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(polygon->contact(in->positions[i & (INPUTS - 1)], 0.2f).has_value());
+			}
+			});
+
+		auto capsule = std::make_shared<CapsuleHitbox>(Position{ 1.0f, 2.0f, 0.0f }, 1.0f, Position{ 0.5f, 0.1f, 0.0f }, Position{ -0.8f, 0.0f, 0.0f }, 0.1f);
+		capsule->rotate(0.5f, { 0.0f, 0.0f, 1.0f });
+		suite.add("Collision/capsule-circle", [in, capsule](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(capsule->contact(in->positions[i & (INPUTS - 1)], 0.2f).has_value());
+			}
+			});
+
+		suite.add("Cinematicable/move", [](Batch& batch) {
+			CircleHitbox ball{ 0.2f, Position{ 0.0f, 0.0f, 0.0f }, 1.0f, Mass{ 2.0f }, Speed{ 1.0f, 0.5f, 0.0f }, Acceleration{}, Force{ 0.0f, -9.8f, 0.0f } };
+			ball.setAngularSpeed(1.0f);
+			batch.restartTimer();
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				ball.move(TIME_STEP);
+			}
+			doNotOptimize(ball.getPosition());
+			});
+	}
+
+
+
+	/**
+	 * @brief Adds a benchmark of a whole physics step (Universe::calculate of every universe) on a table.
+	 * @details Each batch builds the table from scratch and starts a multiball game, so that every batch measures the same evolution of the table. Building the table is not measured.
+	 *			With instrumented, a PhysicsStats is attached to every universe (and drained every few steps, as a reader thread would do), to measure the cost of the instrumentation.
+	 */
+	inline void addUniverseBenchmark(Suite& suite, const std::string& name, std::shared_ptr<const TableFile> file, bool instrumented = false) {
+		suite.add("Universe/calculate/" + name + (instrumented ? "+stats" : ""), [file, instrumented](Batch& batch) {
+			Lights lights{};
+			Table table{ *file };
+			GameStatus gameStatus{ table.getBalls(), table.getBumpers(), lights, table.getGameUniverse() };
+			table.bindCollisionActions(gameStatus);
+			gameStatus.startNewGame(Speed{ 0.0f, 1.0f, 0.0f });
+			gameStatus.activateMultiball();
+			auto universes = table.getUniverses();
+			PhysicsStats stats{ INPUTS * universes.size() };
+			std::vector<TickRecord> records;
+			if (instrumented) {
+				for (auto universe : universes) {
+					universe->setStats(&stats);
+				}
+			}
+
+			batch.restartTimer();
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				for (auto universe : universes) {
+					universe->calculate(TIME_STEP);
+				}
+				if (instrumented && (i & (INPUTS - 1)) == 0) {
+					records.clear();
+					stats.drain(records);
+				}
+			}
+			});
+	}
+
+
+
+	/**
+	 * @brief Generates a stress table from a preset of TableGenerator and loads it.
+	 * @details The table is written in the temporary directory, since a TableFile maps a file on disk.
+	 */
+	inline std::shared_ptr<const TableFile> makeStressTable(const TableCompiler::TableSource& base, const std::string& preset) {
+		auto settings = TableGenerator::fromPreset(preset);
+		settings.models = false;
+		auto path = (std::filesystem::temp_directory_path() / ("pinball_benchmark_" + preset + ".tbl")).string();
+		TableCompiler::writeBinaryFile(path, TableGenerator::generate(base, settings));
+		return std::make_shared<const TableFile>(path);
+	}
+
+}
+
+
+#endif
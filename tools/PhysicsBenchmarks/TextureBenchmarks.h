@@ -0,0 +1,68 @@
+#ifndef BENCHMARKS_TEXTUREBENCHMARKS
+#define BENCHMARKS_TEXTUREBENCHMARKS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "TextureCompression.h"
+
+
+/**
+ * @brief The benchmarks of the cooking of the textures (see TextureCompression): an operation is the encoding of a 256x256 level, or the downsampling of a 1024x1024 level.
+ * @details The image is a smooth gradient with some noise, which is harder to encode than a flat image and easier than pure noise, as the textures of the table.
+ */
+namespace Benchmarks::Textures {
+
+	using namespace Vulkan;
+
+	constexpr uint32_t LEVEL_SIZE = 256;
+	constexpr uint32_t DOWNSAMPLE_SIZE = 1024;
+
+
+	inline std::shared_ptr<std::vector<uint8_t>> makeImage(uint32_t size) {
+		auto image = std::make_shared<std::vector<uint8_t>>(size_t{ size } * size * 4);
+		std::mt19937 random{ 42 };
+		std::uniform_int_distribution<int> noise{ -8, 8 };
+		for (uint32_t y = 0; y < size; ++y) {
+			for (uint32_t x = 0; x < size; ++x) {
+				uint8_t* texel = image->data() + (size_t{ y } * size + x) * 4;
+				texel[0] = static_cast<uint8_t>(std::clamp(static_cast<int>(x * 255 / size) + noise(random), 0, 255));
+				texel[1] = static_cast<uint8_t>(std::clamp(static_cast<int>(y * 255 / size) + noise(random), 0, 255));
+				texel[2] = static_cast<uint8_t>(std::clamp(128 + noise(random), 0, 255));
+				texel[3] = 255;
+			}
+		}
+		return image;
+	}
+
+
+	inline void addTextureCookingBenchmarks(Suite& suite) {
+		auto level = makeImage(LEVEL_SIZE);
+		for (auto [encoding, name] : { std::pair{ TextureFormat::Encoding::BC1, "bc1" }, std::pair{ TextureFormat::Encoding::BC7, "bc7" } }) {
+			suite.add("Texture/encode-" + std::string{ name } + "/" + std::to_string(LEVEL_SIZE) + "x" + std::to_string(LEVEL_SIZE), [level, encoding](Batch& batch) {
+				std::vector<std::byte> encoded(TextureFormat::getLevelSize(encoding, LEVEL_SIZE, LEVEL_SIZE));
+				for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+					TextureCompression::encode(encoding, level->data(), LEVEL_SIZE, LEVEL_SIZE, encoded.data());
+				}
+				doNotOptimize(encoded.front());
+				});
+		}
+
+		auto image = makeImage(DOWNSAMPLE_SIZE);
+		suite.add("Texture/downsample/" + std::to_string(DOWNSAMPLE_SIZE) + "x" + std::to_string(DOWNSAMPLE_SIZE), [image](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				auto next = TextureCompression::downsample(image->data(), DOWNSAMPLE_SIZE, DOWNSAMPLE_SIZE);
+				doNotOptimize(next.front());
+			}
+			});
+	}
+
+}
+
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef BENCHMARKS_TRACERBENCHMARKS
+#define BENCHMARKS_TRACERBENCHMARKS
+
+#include "Benchmark.h"
+#include "Tracer.h"
+
+
+/**
+ * @brief The benchmarks of the Tracer: the cost a zone adds to the code it measures when tracing is compiled in (when it is compiled out, VULKAN_TRACE_ZONE is empty).
+ */
+namespace Benchmarks::Tracing {
+
+	using namespace Vulkan::Utilities;
+
+
+	inline void addTracerBenchmarks(Suite& suite) {
+		suite.add("Tracer/zone", [](Batch& batch) {
+			Tracer::get().record("warm up", Tracer::Clock::now(), Tracer::Clock::now()); //the buffer of the thread is allocated by its first zone
+			batch.restartTimer();
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				const TraceZone zone{ "benchmark" };
+			}
+			});
+
+		suite.add("Tracer/clock", [](Batch& batch) {
+			for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+				doNotOptimize(Tracer::Clock::now());
+			}
+			});
+	}
+
+}
+
+
+#endif
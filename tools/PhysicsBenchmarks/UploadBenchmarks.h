@@ -0,0 +1,67 @@
+#ifndef BENCHMARKS_UPLOADBENCHMARKS
+#define BENCHMARKS_UPLOADBENCHMARKS
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "DirtyRanges.h"
+
+
+/**
+ * @brief The benchmarks of the upload of the per-object uniforms to a persistently mapped buffer: an operation is the upload of the matrices of every object, as a frame does.
+ * @details The mapped memory is simulated by host memory, so the results are the cost of the CPU side: the copies and, for a non-coherent memory, the merge of the written ranges (the driver then flushes them with a single call).
+ *			Each object has its matrices (3 mat4) in a block aligned to 256 bytes, the largest minUniformBufferOffsetAlignment.
+ */
+namespace Benchmarks::Uploads {
+
+	using namespace Vulkan::Buffers;
+
+
+	struct Matrices {
+		float mvp[16];
+		float model[16];
+		float normals[16];
+	};
+
+	constexpr size_t BLOCK = 256;
+	constexpr size_t ATOM = 64; //a common nonCoherentAtomSize
+	constexpr size_t MAX_GAP = 256; //as Buffer::flush
+
+
+	inline void addUniformUploadBenchmarks(Suite& suite) {
+		for (size_t objects : { 1000, 10000 }) {
+			const std::string suffix = "/" + std::to_string(objects) + "objects";
+			auto mapped = std::shared_ptr<std::byte[]>(new std::byte[objects * BLOCK]);
+			auto matrices = std::make_shared<std::vector<Matrices>>(objects, Matrices{ {1.0f}, {1.0f}, {1.0f} });
+
+			suite.add("Uniforms/upload-coherent" + suffix, [mapped, matrices, objects](Batch& batch) {
+				for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+					for (size_t object = 0; object < objects; ++object) {
+						memcpy(mapped.get() + object * BLOCK, &(*matrices)[object], sizeof(Matrices));
+					}
+					doNotOptimize(mapped[0]);
+				}
+				});
+
+			suite.add("Uniforms/upload-noncoherent" + suffix, [mapped, matrices, objects](Batch& batch) {
+				DirtyRanges dirty;
+				for (uint64_t i = 0; i < batch.getIterations(); ++i) {
+					for (size_t object = 0; object < objects; ++object) {
+						memcpy(mapped.get() + object * BLOCK, &(*matrices)[object], sizeof(Matrices));
+						dirty.add(object * BLOCK, sizeof(Matrices));
+					}
+					doNotOptimize(dirty.coalesce(ATOM, objects * BLOCK, MAX_GAP).size()); //a single range
+					dirty.clear();
+				}
+				});
+		}
+	}
+
+}
+
+
+#endif
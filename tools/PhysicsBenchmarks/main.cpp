@@ -0,0 +1,142 @@
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PhysicsBenchmarks.h"
+#include "JobBenchmarks.h"
+#include "TracerBenchmarks.h"
+#include "UploadBenchmarks.h"
+#include "MemoryBenchmarks.h"
+#include "TextureBenchmarks.h"
+#include "JsonReport.h"
+
+
+const char* USAGE = R"(Usage: PhysicsBenchmarks [options]
+  --filter <text>          run only the benchmarks whose name contains this text
+  --min-time <seconds>     minimum duration of a timed batch (default 0.1)
+  --repetitions <n>        timed batches of each benchmark, the median is reported (default 5)
+  --table <path>           binary table of the Universe/calculate/reference benchmark (default tables/reference.tbl)
+  --base <path>            readable table the stress tables are generated from (default tables/reference.table)
+  --stress <presets>       comma separated TableGenerator presets, or none (default tiny,small,medium)
+  --json <path>            write the results (default benchmarks.json)
+  --baseline <path>        compare with the results of a previous run
+  --threshold <ratio>      a benchmark slower than the baseline by more than this ratio is a regression (default 0.1)
+)";
+
+
+
+int main(int argc, char* argv[]) {
+	try {
+		Benchmarks::BenchmarkSettings settings{};
+		std::string tablePath = "tables/reference.tbl";
+		std::string basePath = "tables/reference.table";
+		std::string stress = "tiny,small,medium";
+		std::string jsonPath = "benchmarks.json";
+		std::string baselinePath;
+		double threshold = 0.1;
+
+		//parse command line
+		for (int i = 1; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (option == "--help") {
+				std::cout << USAGE;
+				return 0;
+			}
+			if (i + 1 >= argc) {
+				throw std::invalid_argument{ "Missing value for " + option };
+			}
+
+			const std::string value = argv[++i];
+			if (option == "--filter") settings.filter = value;
+			else if (option == "--min-time") settings.minBatchSeconds = std::stod(value);
+			else if (option == "--repetitions") settings.repetitions = std::max(1, std::stoi(value));
+			else if (option == "--table") tablePath = value;
+			else if (option == "--base") basePath = value;
+			else if (option == "--stress") stress = value;
+			else if (option == "--json") jsonPath = value;
+			else if (option == "--baseline") baselinePath = value;
+			else if (option == "--threshold") threshold = std::stod(value);
+			else throw std::invalid_argument{ "Unknown option " + option + "\n" + USAGE };
+		}
+
+		//register the benchmarks (stress tables are generated only if some of their benchmarks will run)
+		Benchmarks::Suite suite;
+		auto inputs = std::make_shared<const Benchmarks::Physics::Inputs>();
+		Benchmarks::Physics::addFoundationsBenchmarks(suite, inputs);
+		Benchmarks::Physics::addGeometryBenchmarks(suite, inputs);
+		auto runs = [&settings](const std::string& name) { return name.find(settings.filter) != std::string::npos; };
+
+		Benchmarks::Tracing::addTracerBenchmarks(suite);
+		Benchmarks::Uploads::addUniformUploadBenchmarks(suite);
+		Benchmarks::Memory::addMemoryAllocatorBenchmarks(suite);
+		Benchmarks::Textures::addTextureCookingBenchmarks(suite);
+		if (runs("JobSystem")) {
+			const unsigned int allWorkers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+			Benchmarks::Jobs::addJobSystemBenchmarks(suite, 1);
+			if (allWorkers > 1) {
+				Benchmarks::Jobs::addJobSystemBenchmarks(suite, allWorkers);
+			}
+		}
+
+		if (runs("Universe/calculate/reference")) {
+			auto reference = std::make_shared<const Vulkan::Physics::TableFile>(tablePath);
+			Benchmarks::Physics::addUniverseBenchmark(suite, "reference", reference);
+			Benchmarks::Physics::addUniverseBenchmark(suite, "reference", reference, true);
+		}
+
+		std::vector<std::string> presets;
+		std::stringstream presetList{ stress };
+		for (std::string preset; std::getline(presetList, preset, ',');) {
+			if (!preset.empty() && preset != "none" && runs("Universe/calculate/" + preset)) {
+				presets.push_back(preset);
+			}
+		}
+		if (!presets.empty()) {
+			auto base = TableCompiler::parseFile(basePath);
+			for (const auto& preset : presets) {
+				Benchmarks::Physics::addUniverseBenchmark(suite, preset, Benchmarks::Physics::makeStressTable(base, preset));
+			}
+		}
+
+		//run
+		auto results = suite.run(settings, std::cout);
+
+		std::vector<Benchmarks::JsonReport::Comparison> comparisons;
+		if (!baselinePath.empty()) {
+			comparisons = Benchmarks::JsonReport::compare(results, Benchmarks::JsonReport::readBaseline(baselinePath));
+		}
+
+		std::map<std::string, std::string> context{
+			{ "table", tablePath },
+			{ "stress", stress },
+			{ "min_time", std::to_string(settings.minBatchSeconds) },
+			{ "repetitions", std::to_string(settings.repetitions) },
+			{ "baseline", baselinePath }
+		};
+		Benchmarks::JsonReport::writeFile(jsonPath, context, results, comparisons);
+		std::cout << "Results written to " << jsonPath << "\n";
+
+		//regressions
+		int regressions = 0;
+		for (const auto& c : comparisons) {
+			if (c.getChange() > threshold) {
+				std::cout << "REGRESSION " << c.name << ": " << c.baselineNsPerOp << " -> " << c.nsPerOp << " ns/op (" << std::showpos << std::fixed << std::setprecision(1) << c.getChange() * 100.0 << std::noshowpos << std::defaultfloat << "%)\n";
+				regressions++;
+			}
+		}
+		if (!baselinePath.empty()) {
+			std::cout << comparisons.size() << " benchmarks compared with " << baselinePath << ", " << regressions << " regressions\n";
+		}
+		return regressions > 0 ? 2 : 0;
+
+	} catch (const std::exception& e) {
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}
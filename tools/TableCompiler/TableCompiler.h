@@ -0,0 +1,615 @@
+#ifndef TABLECOMPILER_TABLECOMPILER
+#define TABLECOMPILER_TABLECOMPILER
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <map>
+#include <numbers>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TableFormat.h"
+#include "CollisionFile.h"
+
+
+/**
+ * @brief Reads, writes and compiles readable table descriptions (.table) into binary table files (.tbl).
+ * @details A readable table is a list of directives, one per line. A line ending with \ continues on the next one, # starts a comment.
+ * @code
+ * version 1
+ * field <name> <gravity|friction|central> position <x> <y> <z> intensity <value>
+ * circle <name> position <x> <y> <z> radius <r> [scale <s>] [mass <m>] [action <a>] [light <slot> <height>]
+ * frame <name> position <x> <y> <z> [scale <s>] [mass <m>] [rotation <degrees>] [action <a>] [light <slot> <height>] vertices <x> <y> <x> <y> ...
+ * frame <name> position <x> <y> <z> [scale <s>] [mass <m>] [rotation <degrees>] [action <a>] [light <slot> <height>] outline <path.col> <index>
+ * capsule <name> position <x> <y> <z> radius <r> [scale <s>] [mass <m>] [rotation <degrees>] [action <a>] [light <slot> <height>] vertices <x> <y> <x> <y>
+ * polygon <name> position <x> <y> <z> [scale <s>] [mass <m>] [rotation <degrees>] [action <a>] [light <slot> <height>] vertices <x> <y> <x> <y> <x> <y> ...
+ * polygon <name> position <x> <y> <z> [scale <s>] [mass <m>] [rotation <degrees>] [action <a>] [light <slot> <height>] outline <path.col> <index>
+ * model <hitbox> <path to obj> [rotation <x degrees> <y degrees> <z degrees>]
+ * universe <name> fields <field>... bodies <hitbox>...
+ * balls <hitbox>...
+ * bumpers <hitbox>...
+ * role <gameUniverse|leftPad|rightPad|puller> <name>
+ * @endcode
+ * @details Actions are invertBumper, killBall and startGame. A mass of 0 (the default) means a static object.
+ *			A capsule is the segment between its 2 vertices, thickened by its radius. The vertices of a polygon describe a convex polygon, and the last one is connected to the first one.
+ *			Instead of typing the vertices, frames and polygons can take an outline of a collision asset cooked by CollisionCooker (the path is relative to the working directory of the compiler). The vertices are copied in the table, so the asset is not needed to load the table.
+ */
+namespace TableCompiler {
+
+	using namespace Vulkan::Physics::TableFormat;
+
+
+	struct LightSource {
+		uint32_t slot;
+		float height;
+	};
+
+	struct HitboxSource {
+		std::string name;
+		HitboxType type = HitboxType::CIRCLE;
+		Vec3 position{};
+		float scale = 1.0f;
+		float mass = 0.0f;
+		float radius = 0.0f;
+		float rotation = 0.0f; //degrees
+		std::vector<Vec3> vertices;
+		CollisionAction action = CollisionAction::NONE;
+		std::optional<LightSource> light;
+	};
+
+	struct FieldSource {
+		std::string name;
+		FieldType type = FieldType::GRAVITY;
+		Vec3 position{};
+		float intensity = 0.0f;
+	};
+
+	struct ModelSource {
+		std::string hitbox;
+		std::string path;
+		Vec3 rotation{}; //degrees
+	};
+
+	struct UniverseSource {
+		std::string name;
+		std::vector<std::string> fields;
+		std::vector<std::string> bodies;
+	};
+
+	/**
+	 * @brief The in memory version of a readable table.
+	 */
+	struct TableSource {
+		std::vector<FieldSource> fields;
+		std::vector<HitboxSource> hitboxes;
+		std::vector<ModelSource> models;
+		std::vector<UniverseSource> universes;
+		std::vector<std::string> balls;
+		std::vector<std::string> bumpers;
+		std::string gameUniverse;
+		std::string leftPad;
+		std::string rightPad;
+		std::string puller;
+	};
+
+
+
+	namespace Detail {
+
+		inline const std::map<std::string, HitboxType> HITBOX_TYPES{ { "circle", HitboxType::CIRCLE }, { "frame", HitboxType::FRAME }, { "capsule", HitboxType::CAPSULE }, { "polygon", HitboxType::POLYGON } };
+		inline const std::map<std::string, FieldType> FIELD_TYPES{ { "gravity", FieldType::GRAVITY }, { "friction", FieldType::FRICTION }, { "central", FieldType::CENTRAL } };
+		inline const std::map<std::string, CollisionAction> ACTIONS{ { "none", CollisionAction::NONE }, { "invertBumper", CollisionAction::INVERT_BUMPER }, { "killBall", CollisionAction::KILL_BALL }, { "startGame", CollisionAction::START_GAME } };
+
+
+		template<typename T>
+		std::string nameOf(const std::map<std::string, T>& names, T value) {
+			for (const auto& [name, v] : names) {
+				if (v == value) {
+					return name;
+				}
+			}
+			return "none";
+		}
+
+
+		//the tokens of a directive, with the position in the source for error messages
+		class Tokens {
+		public:
+			Tokens(std::vector<std::string> tokens, std::string where) : tokens{ std::move(tokens) }, where{ std::move(where) }, next{ 0 } {}
+
+			bool empty() const {
+				return next >= tokens.size();
+			}
+
+			const std::string& peek() const {
+				if (empty()) {
+					fail("unexpected end of line");
+				}
+				return tokens[next];
+			}
+
+			std::string word() {
+				std::string res = peek();
+				next++;
+				return res;
+			}
+
+			const std::string& previous() const {
+				return tokens[next - 1];
+			}
+
+			float number() {
+				std::string token = word();
+				try {
+					size_t parsed = 0;
+					float res = std::stof(token, &parsed);
+					if (parsed == token.size()) {
+						return res;
+					}
+				}
+				catch (const std::exception&) {}
+				fail("expected a number, found " + token);
+			}
+
+			Vec3 vec3() {
+				Vec3 res{};
+				res.x = number(); res.y = number(); res.z = number();
+				return res;
+			}
+
+			template<typename T>
+			T oneOf(const std::map<std::string, T>& names) {
+				std::string token = word();
+				if (auto found = names.find(token); found != names.end()) {
+					return found->second;
+				}
+				fail("unknown value " + token);
+			}
+
+			void expect(const std::string& keyword) {
+				if (word() != keyword) {
+					fail("expected " + keyword);
+				}
+			}
+
+			[[noreturn]] void fail(const std::string& message) const {
+				throw std::runtime_error{ where + ": " + message };
+			}
+
+		private:
+			std::vector<std::string> tokens;
+			std::string where;
+			size_t next;
+		};
+
+
+		inline bool isConvex(const std::vector<Vec3>& vertices) {
+			return Vulkan::Physics::TableFormat::isConvex(vertices);
+		}
+
+
+		inline void parseHitboxOption(Tokens& tokens, HitboxSource& hitbox, const std::string& option) {
+			if (option == "position") hitbox.position = tokens.vec3();
+			else if (option == "scale") hitbox.scale = tokens.number();
+			else if (option == "mass") hitbox.mass = tokens.number();
+			else if (option == "radius" && (hitbox.type == HitboxType::CIRCLE || hitbox.type == HitboxType::CAPSULE)) hitbox.radius = tokens.number();
+			else if (option == "rotation") hitbox.rotation = tokens.number();
+			else if (option == "action") hitbox.action = tokens.oneOf(ACTIONS);
+			else if (option == "light") {
+				float slot = tokens.number();
+				if (slot < 0.0f || slot >= POINT_LIGHTS) {
+					tokens.fail("a light slot goes from 0 to " + std::to_string(POINT_LIGHTS - 1));
+				}
+				hitbox.light = LightSource{ static_cast<uint32_t>(slot), tokens.number() };
+			}
+			else if (option == "vertices" && hitbox.type != HitboxType::CIRCLE) {
+				while (!tokens.empty()) {
+					Vec3 vertex{};
+					vertex.x = tokens.number(); vertex.y = tokens.number();
+					hitbox.vertices.push_back(vertex);
+				}
+			}
+			else if (option == "outline" && (hitbox.type == HitboxType::FRAME || hitbox.type == HitboxType::POLYGON)) {
+				std::string path = tokens.word();
+				float index = tokens.number();
+				std::optional<Vulkan::Physics::CollisionFile> file;
+				try {
+					file.emplace(path);
+				}
+				catch (const std::runtime_error& e) {
+					tokens.fail(e.what());
+				}
+				if (index < 0.0f || index != std::floor(index) || index >= file->getOutlinesCount()) {
+					tokens.fail(path + " has no outline " + tokens.previous());
+				}
+				size_t i = static_cast<size_t>(index);
+				if (hitbox.type == HitboxType::POLYGON) {
+					if (!file->isConvex(i)) {
+						tokens.fail("outline " + std::to_string(i) + " of " + path + " is not convex");
+					}
+					hitbox.vertices.assign(file->getVertices(i).begin(), file->getVertices(i).end());
+				}
+				else {
+					hitbox.vertices = file->getFrameVertices(i);
+				}
+			}
+			else tokens.fail("unknown option " + option);
+		}
+
+
+		inline void parseDirective(Tokens& tokens, TableSource& table) {
+			std::string directive = tokens.word();
+
+			if (directive == "version") {
+				if (tokens.number() != 1.0f) {
+					tokens.fail("unsupported version");
+				}
+			}
+			else if (directive == "field") {
+				FieldSource field{};
+				field.name = tokens.word();
+				field.type = tokens.oneOf(FIELD_TYPES);
+				tokens.expect("position");
+				field.position = tokens.vec3();
+				tokens.expect("intensity");
+				field.intensity = tokens.number();
+				table.fields.push_back(field);
+			}
+			else if (HITBOX_TYPES.contains(directive)) {
+				HitboxSource hitbox{};
+				hitbox.type = HITBOX_TYPES.at(directive);
+				hitbox.name = tokens.word();
+				while (!tokens.empty()) {
+					parseHitboxOption(tokens, hitbox, tokens.word());
+				}
+				if (hitbox.type == HitboxType::FRAME && hitbox.vertices.size() < 2) {
+					tokens.fail("a frame needs at least 2 vertices");
+				}
+				if (hitbox.type == HitboxType::CAPSULE && hitbox.vertices.size() != 2) {
+					tokens.fail("a capsule needs 2 vertices");
+				}
+				if (hitbox.type == HitboxType::POLYGON && (hitbox.vertices.size() < 3 || !isConvex(hitbox.vertices))) {
+					tokens.fail("a polygon needs at least 3 vertices describing a convex polygon");
+				}
+				if ((hitbox.type == HitboxType::CIRCLE || hitbox.type == HitboxType::CAPSULE) && hitbox.radius <= 0.0f) {
+					tokens.fail("a " + directive + " needs a positive radius");
+				}
+				table.hitboxes.push_back(hitbox);
+			}
+			else if (directive == "model") {
+				ModelSource model{};
+				model.hitbox = tokens.word();
+				model.path = tokens.word();
+				if (!tokens.empty()) {
+					tokens.expect("rotation");
+					model.rotation = tokens.vec3();
+				}
+				table.models.push_back(model);
+			}
+			else if (directive == "universe") {
+				UniverseSource universe{};
+				universe.name = tokens.word();
+				tokens.expect("fields");
+				while (!tokens.empty() && tokens.peek() != "bodies") {
+					universe.fields.push_back(tokens.word());
+				}
+				tokens.expect("bodies");
+				while (!tokens.empty()) {
+					universe.bodies.push_back(tokens.word());
+				}
+				table.universes.push_back(universe);
+			}
+			else if (directive == "balls" || directive == "bumpers") {
+				auto& list = directive == "balls" ? table.balls : table.bumpers;
+				while (!tokens.empty()) {
+					list.push_back(tokens.word());
+				}
+			}
+			else if (directive == "role") {
+				std::string role = tokens.word();
+				if (role == "gameUniverse") table.gameUniverse = tokens.word();
+				else if (role == "leftPad") table.leftPad = tokens.word();
+				else if (role == "rightPad") table.rightPad = tokens.word();
+				else if (role == "puller") table.puller = tokens.word();
+				else tokens.fail("unknown role " + role);
+			}
+			else {
+				tokens.fail("unknown directive " + directive);
+			}
+
+			if (!tokens.empty()) {
+				tokens.fail("unexpected " + tokens.peek());
+			}
+		}
+
+	}
+
+
+
+	/**
+	 * @brief Parses a readable table. Throws std::runtime_error, with the line of the error, if the table is malformed.
+	 */
+	inline TableSource parse(std::istream& in, const std::string& sourceName) {
+		TableSource table{};
+		std::string line, directive;
+		int lineNumber = 0, directiveLine = 0;
+
+		while (std::getline(in, line)) {
+			lineNumber++;
+			if (auto comment = line.find('#'); comment != std::string::npos) {
+				line.erase(comment);
+			}
+			while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+				line.pop_back();
+			}
+
+			if (directive.empty()) {
+				directiveLine = lineNumber;
+			}
+			bool continues = !line.empty() && line.back() == '\\';
+			if (continues) {
+				line.pop_back();
+			}
+			directive += " " + line;
+			if (continues) {
+				continue;
+			}
+
+			std::istringstream stream{ directive };
+			std::vector<std::string> words;
+			for (std::string word; stream >> word; ) {
+				words.push_back(word);
+			}
+			directive.clear();
+
+			if (!words.empty()) {
+				Detail::Tokens tokens{ std::move(words), sourceName + ":" + std::to_string(directiveLine) };
+				Detail::parseDirective(tokens, table);
+			}
+		}
+
+		return table;
+	}
+
+
+
+	/**
+	 * @brief Writes a table in the readable format, so that it can be parsed again.
+	 */
+	inline void writeText(std::ostream& out, const TableSource& table) {
+		auto vec3 = [&out](const Vec3& v) { out << v.x << " " << v.y << " " << v.z; };
+		out << std::setprecision(9);
+
+		out << "version 1\n\n";
+
+		for (const auto& field : table.fields) {
+			out << "field " << field.name << " " << Detail::nameOf(Detail::FIELD_TYPES, field.type) << " position ";
+			vec3(field.position);
+			out << " intensity " << field.intensity << "\n";
+		}
+		out << "\n";
+
+		for (const auto& hitbox : table.hitboxes) {
+			out << Detail::nameOf(Detail::HITBOX_TYPES, hitbox.type) << " " << hitbox.name << " position ";
+			vec3(hitbox.position);
+			out << " scale " << hitbox.scale;
+			if (hitbox.mass > 0.0f) out << " mass " << hitbox.mass;
+			if (hitbox.type == HitboxType::CIRCLE || hitbox.type == HitboxType::CAPSULE) out << " radius " << hitbox.radius;
+			if (hitbox.rotation != 0.0f) out << " rotation " << hitbox.rotation;
+			if (hitbox.action != CollisionAction::NONE) out << " action " << Detail::nameOf(Detail::ACTIONS, hitbox.action);
+			if (hitbox.light) out << " light " << hitbox.light->slot << " " << hitbox.light->height;
+			if (hitbox.type != HitboxType::CIRCLE) {
+				out << " vertices";
+				for (size_t i = 0; i < hitbox.vertices.size(); ++i) {
+					out << (i % 4 == 0 ? " \\\n\t" : "  ") << hitbox.vertices[i].x << " " << hitbox.vertices[i].y;
+				}
+			}
+			out << "\n";
+		}
+		out << "\n";
+
+		for (const auto& model : table.models) {
+			out << "model " << model.hitbox << " " << model.path << " rotation ";
+			vec3(model.rotation);
+			out << "\n";
+		}
+		out << "\n";
+
+		auto list = [&out](const std::vector<std::string>& names) {
+			for (size_t i = 0; i < names.size(); ++i) {
+				out << (i % 16 == 15 ? " \\\n\t" : " ") << names[i];
+			}
+		};
+
+		for (const auto& universe : table.universes) {
+			out << "universe " << universe.name << " fields";
+			list(universe.fields);
+			out << " bodies";
+			list(universe.bodies);
+			out << "\n";
+		}
+		out << "\n";
+
+		if (!table.balls.empty()) { out << "balls"; list(table.balls); out << "\n"; }
+		if (!table.bumpers.empty()) { out << "bumpers"; list(table.bumpers); out << "\n"; }
+		if (!table.gameUniverse.empty()) out << "role gameUniverse " << table.gameUniverse << "\n";
+		if (!table.leftPad.empty()) out << "role leftPad " << table.leftPad << "\n";
+		if (!table.rightPad.empty()) out << "role rightPad " << table.rightPad << "\n";
+		if (!table.puller.empty()) out << "role puller " << table.puller << "\n";
+	}
+
+
+
+	/**
+	 * @brief Compiles a table into the binary format. Throws std::runtime_error if a name is duplicated or doesn't exist.
+	 */
+	inline std::vector<char> compile(const TableSource& table) {
+		constexpr float DEGREES = std::numbers::pi_v<float> / 180.0f;
+
+		//names to indices
+		auto indexNames = [](const auto& items, const char* what) {
+			std::map<std::string, uint32_t> res;
+			for (uint32_t i = 0; i < items.size(); ++i) {
+				if (!res.emplace(items[i].name, i).second) {
+					throw std::runtime_error{ std::string{ "Duplicated " } + what + " " + items[i].name };
+				}
+			}
+			return res;
+		};
+		auto hitboxIndices = indexNames(table.hitboxes, "hitbox");
+		auto fieldIndices = indexNames(table.fields, "field");
+		auto universeIndices = indexNames(table.universes, "universe");
+
+		auto find = [](const std::map<std::string, uint32_t>& indices, const std::string& name, const char* what) {
+			if (auto found = indices.find(name); found != indices.end()) {
+				return found->second;
+			}
+			throw std::runtime_error{ std::string{ "Unknown " } + what + " " + name };
+		};
+		auto findOptional = [&find](const std::map<std::string, uint32_t>& indices, const std::string& name, const char* what) {
+			return name.empty() ? NONE : find(indices, name, what);
+		};
+
+		//strings are stored once
+		std::string strings;
+		std::map<std::string, uint32_t> stringOffsets;
+		auto intern = [&strings, &stringOffsets](const std::string& s) {
+			auto [found, inserted] = stringOffsets.emplace(s, static_cast<uint32_t>(strings.size()));
+			if (inserted) {
+				strings += s;
+				strings += '\0';
+			}
+			return found->second;
+		};
+
+		std::vector<uint32_t> indices;
+		auto addIndices = [&indices, &find](const std::vector<std::string>& names, const std::map<std::string, uint32_t>& namesIndices, const char* what) {
+			Range range{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(names.size()) };
+			for (const auto& name : names) {
+				indices.push_back(find(namesIndices, name, what));
+			}
+			return range;
+		};
+
+		//records
+		std::vector<HitboxRecord> hitboxes;
+		std::vector<Vec3> vertices;
+		std::vector<LightRecord> lights;
+		for (uint32_t i = 0; i < table.hitboxes.size(); ++i) {
+			const auto& hitbox = table.hitboxes[i];
+			HitboxRecord record{};
+			record.name = intern(hitbox.name);
+			record.type = hitbox.type;
+			record.position = hitbox.position;
+			record.scale = hitbox.scale;
+			record.mass = hitbox.mass;
+			record.radius = hitbox.radius;
+			record.rotation = hitbox.rotation * DEGREES;
+			record.vertices = Range{ static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(hitbox.vertices.size()) };
+			record.action = hitbox.action;
+			vertices.insert(vertices.end(), hitbox.vertices.begin(), hitbox.vertices.end());
+			hitboxes.push_back(record);
+
+			if (hitbox.light) {
+				lights.push_back(LightRecord{ i, hitbox.light->slot, hitbox.light->height });
+			}
+		}
+
+		std::vector<FieldRecord> fields;
+		for (const auto& field : table.fields) {
+			fields.push_back(FieldRecord{ intern(field.name), field.type, field.position, field.intensity });
+		}
+
+		std::vector<ModelRecord> models;
+		for (const auto& model : table.models) {
+			models.push_back(ModelRecord{ find(hitboxIndices, model.hitbox, "model hitbox"), intern(model.path), Vec3{ model.rotation.x * DEGREES, model.rotation.y * DEGREES, model.rotation.z * DEGREES } });
+		}
+
+		std::vector<UniverseRecord> universes;
+		for (const auto& universe : table.universes) {
+			UniverseRecord record{};
+			record.name = intern(universe.name);
+			record.fields = addIndices(universe.fields, fieldIndices, "field");
+			record.bodies = addIndices(universe.bodies, hitboxIndices, "hitbox");
+			universes.push_back(record);
+		}
+
+		Header header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.gameUniverse = findOptional(universeIndices, table.gameUniverse, "universe");
+		header.leftPad = findOptional(hitboxIndices, table.leftPad, "hitbox");
+		header.rightPad = findOptional(hitboxIndices, table.rightPad, "hitbox");
+		header.puller = findOptional(hitboxIndices, table.puller, "hitbox");
+		header.balls = addIndices(table.balls, hitboxIndices, "hitbox");
+		header.bumpers = addIndices(table.bumpers, hitboxIndices, "hitbox");
+		intern(""); //the strings section is never empty
+
+		//sections, one after the other
+		std::vector<char> file(sizeof(Header));
+		auto append = [&file](const auto& items) {
+			while (file.size() % 4 != 0) {
+				file.push_back(0);
+			}
+			Section section{ static_cast<uint32_t>(file.size()), static_cast<uint32_t>(items.size()) };
+			const char* bytes = reinterpret_cast<const char*>(items.data());
+			file.insert(file.end(), bytes, bytes + items.size() * sizeof(items[0]));
+			return section;
+		};
+		header.hitboxes = append(hitboxes);
+		header.vertices = append(vertices);
+		header.fields = append(fields);
+		header.models = append(models);
+		header.universes = append(universes);
+		header.indices = append(indices);
+		header.lights = append(lights);
+		header.strings = append(strings);
+		while (file.size() % 4 != 0) {
+			file.push_back(0);
+		}
+
+		header.fileSize = static_cast<uint32_t>(file.size());
+		std::memcpy(file.data(), &header, sizeof(Header));
+		return file;
+	}
+
+
+
+	inline TableSource parseFile(const std::string& path) {
+		std::ifstream in{ path };
+		if (!in) {
+			throw std::runtime_error{ "Cannot open " + path };
+		}
+		return parse(in, path);
+	}
+
+
+	inline void writeBinaryFile(const std::string& path, const TableSource& table) {
+		auto binary = compile(table);
+		std::ofstream out{ path, std::ios::binary };
+		if (!out.write(binary.data(), binary.size())) {
+			throw std::runtime_error{ "Cannot write " + path };
+		}
+	}
+
+
+	inline void writeTextFile(const std::string& path, const TableSource& table) {
+		std::ofstream out{ path };
+		writeText(out, table);
+		if (!out) {
+			throw std::runtime_error{ "Cannot write " + path };
+		}
+	}
+
+}
+
+
+#endif
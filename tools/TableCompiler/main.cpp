@@ -0,0 +1,33 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "TableCompiler.h"
+#include "TableFile.h"
+
+
+const char* USAGE = R"(Usage: TableCompiler <input.table> <output.tbl>
+  Compiles a readable table into a binary table file, then loads it back to check it.
+)";
+
+
+
+int main(int argc, char* argv[]) {
+	if (argc != 3) {
+		std::cout << USAGE;
+		return 1;
+	}
+
+	try {
+		auto table = TableCompiler::parseFile(argv[1]);
+		TableCompiler::writeBinaryFile(argv[2], table);
+
+		//the same checks done by the game when it loads the table
+		Vulkan::Physics::TableFile compiled{ argv[2] };
+		std::cout << argv[2] << ": " << compiled.getHitboxes().size() << " hitboxes, " << compiled.getFields().size() << " fields, " << compiled.getUniverses().size() << " universes, " << compiled.getModels().size() << " models\n";
+
+	} catch (const std::exception& e) {
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}
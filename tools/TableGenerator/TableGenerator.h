@@ -0,0 +1,187 @@
+#ifndef TABLEGENERATOR_TABLEGENERATOR
+#define TABLEGENERATOR_TABLEGENERATOR
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TableCompiler.h"
+
+
+/**
+ * @brief Generates stress tables: a playable base table plus an arena filled with a chosen number of balls, bumpers, wall segments and fields.
+ * @details The arena is a closed box next to the base table. Its bodies are laid out on a shuffled grid (one body per cell, so nothing overlaps at the beginning) and added to the game universe of the base table, so the generated table is loaded by the game and by PinballHeadless like any other table.
+ *			Balls in the arena have a mass and move from the first step, therefore every body weighs on the physics, whether the player launched the game or not.
+ */
+namespace TableGenerator {
+
+	struct GeneratorSettings {
+		uint64_t seed = 1;
+		int balls = 0;
+		int bumpers = 0;
+		int walls = 0;
+		int fields = 0;
+		bool models = true; //whether arena balls and bumpers are drawn
+	};
+
+
+	/**
+	 * @brief A point of the scaling curve: the number of bodies in the arena and how many fields act on them.
+	 */
+	struct Preset {
+		const char* name;
+		int bodies;
+		int fields;
+	};
+
+	inline const std::vector<Preset> PRESETS{
+		{ "tiny", 10, 1 },
+		{ "small", 100, 2 },
+		{ "medium", 1000, 4 },
+		{ "large", 10000, 8 },
+		{ "huge", 100000, 16 }
+	};
+
+
+	/**
+	 * @brief Returns the settings of a preset: 40% balls, 40% bumpers and 20% wall segments. Throws std::invalid_argument if there is no such preset.
+	 */
+	inline GeneratorSettings fromPreset(const std::string& name) {
+		for (const auto& preset : PRESETS) {
+			if (name == preset.name) {
+				GeneratorSettings settings{};
+				settings.balls = preset.bodies * 2 / 5;
+				settings.bumpers = preset.bodies * 2 / 5;
+				settings.walls = preset.bodies - settings.balls - settings.bumpers;
+				settings.fields = preset.fields;
+				return settings;
+			}
+		}
+		throw std::invalid_argument{ "Unknown preset " + name };
+	}
+
+
+
+	const float ARENA_X = 10.0f; //left side of the arena, right of the reference table
+	const float ARENA_Y = -6.0f; //bottom side of the arena
+	const float CELL_SIZE = 1.0f; //a bumper is 0.6 wide, a wall segment 0.8 long
+	const float CELL_JITTER = 0.15f; //maximum random offset from the center of the cell
+
+	const float BALL_RADIUS = 0.162f;
+	const float BALL_SCALE = 0.8f;
+	const float BALL_MASS = 2.0f;
+	const float BUMPER_RADIUS = 0.376f;
+	const float BUMPER_SCALE = 0.8f;
+	const float WALL_HALF_LENGTH = 0.4f;
+	const float FIELD_INTENSITY = 5.0f; //weak, compared to gravity, so balls don't pile up on the attractors
+
+
+
+	/**
+	 * @brief Adds the arena to a copy of the base table.
+	 *
+	 * @param base The table the arena is added to. It must have a game universe.
+	 * @param settings How many objects of each kind the arena contains.
+	 * @return The base table plus the arena.
+	 */
+	inline TableCompiler::TableSource generate(TableCompiler::TableSource base, const GeneratorSettings& settings) {
+		using TableCompiler::Vec3;
+
+		if (settings.balls < 0 || settings.bumpers < 0 || settings.walls < 0 || settings.fields < 0) {
+			throw std::invalid_argument{ "The number of objects cannot be negative" };
+		}
+		auto gameUniverse = std::find_if(base.universes.begin(), base.universes.end(), [&base](const auto& universe) { return universe.name == base.gameUniverse; });
+		if (gameUniverse == base.universes.end()) {
+			throw std::invalid_argument{ "The base table has no game universe" };
+		}
+
+		std::mt19937_64 random{ settings.seed };
+		std::uniform_real_distribution<float> jitter{ -CELL_JITTER, CELL_JITTER };
+		std::uniform_real_distribution<float> angle{ 0.0f, 180.0f };
+
+		//one cell per body, in random order
+		const int bodies = settings.balls + settings.bumpers + settings.walls;
+		const int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(bodies)))));
+		const float arenaSize = side * CELL_SIZE;
+		std::vector<int> cells(static_cast<size_t>(side) * side);
+		std::iota(cells.begin(), cells.end(), 0);
+		std::shuffle(cells.begin(), cells.end(), random);
+
+		int nextCell = 0;
+		auto cellCenter = [&](int cell) {
+			return Vec3{ ARENA_X + (cell % side + 0.5f) * CELL_SIZE + jitter(random), ARENA_Y + (cell / side + 0.5f) * CELL_SIZE + jitter(random), 0.0f };
+		};
+
+		auto addBody = [&](TableCompiler::HitboxSource hitbox, const char* model, const Vec3& modelRotation) {
+			gameUniverse->bodies.push_back(hitbox.name);
+			if (settings.models && model != nullptr) {
+				base.models.push_back(TableCompiler::ModelSource{ hitbox.name, model, modelRotation });
+			}
+			base.hitboxes.push_back(std::move(hitbox));
+		};
+
+		//the box around the arena
+		TableCompiler::HitboxSource box{};
+		box.name = "arena";
+		box.type = TableCompiler::HitboxType::FRAME;
+		box.position = Vec3{ ARENA_X, ARENA_Y, 0.0f };
+		box.vertices = { Vec3{ 0.0f, 0.0f, 0.0f }, Vec3{ arenaSize, 0.0f, 0.0f }, Vec3{ arenaSize, arenaSize, 0.0f }, Vec3{ 0.0f, arenaSize, 0.0f }, Vec3{ 0.0f, 0.0f, 0.0f } };
+		addBody(box, nullptr, {});
+
+		for (int i = 0; i < settings.balls; ++i) {
+			TableCompiler::HitboxSource ball{};
+			ball.name = "arenaBall" + std::to_string(i);
+			ball.type = TableCompiler::HitboxType::CIRCLE;
+			ball.position = cellCenter(cells[nextCell++]);
+			ball.radius = BALL_RADIUS;
+			ball.scale = BALL_SCALE;
+			ball.mass = BALL_MASS;
+			addBody(ball, "models/ball.obj", Vec3{ 0.0f, 0.0f, 0.0f });
+		}
+
+		for (int i = 0; i < settings.bumpers; ++i) {
+			TableCompiler::HitboxSource bumper{};
+			bumper.name = "arenaBumper" + std::to_string(i);
+			bumper.type = TableCompiler::HitboxType::CIRCLE;
+			bumper.position = cellCenter(cells[nextCell++]);
+			bumper.radius = BUMPER_RADIUS;
+			bumper.scale = BUMPER_SCALE;
+			bumper.action = TableCompiler::CollisionAction::INVERT_BUMPER;
+			base.bumpers.push_back(bumper.name);
+			addBody(bumper, "models/bumper.obj", Vec3{ 90.0f, 0.0f, 0.0f });
+		}
+
+		for (int i = 0; i < settings.walls; ++i) {
+			TableCompiler::HitboxSource wall{};
+			wall.name = "arenaWall" + std::to_string(i);
+			wall.type = TableCompiler::HitboxType::FRAME;
+			wall.position = cellCenter(cells[nextCell++]);
+			wall.rotation = angle(random);
+			wall.vertices = { Vec3{ -WALL_HALF_LENGTH, 0.0f, 0.0f }, Vec3{ WALL_HALF_LENGTH, 0.0f, 0.0f } };
+			addBody(wall, nullptr, {});
+		}
+
+		//attractors scattered over the arena
+		std::uniform_real_distribution<float> inArena{ 0.0f, arenaSize };
+		for (int i = 0; i < settings.fields; ++i) {
+			TableCompiler::FieldSource field{};
+			field.name = "arenaField" + std::to_string(i);
+			field.type = TableCompiler::FieldType::CENTRAL;
+			field.position = Vec3{ ARENA_X + inArena(random), ARENA_Y + inArena(random), 0.0f };
+			field.intensity = FIELD_INTENSITY;
+			gameUniverse->fields.push_back(field.name);
+			base.fields.push_back(field);
+		}
+
+		return base;
+	}
+
+}
+
+
+#endif
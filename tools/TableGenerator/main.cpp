@@ -0,0 +1,84 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "TableGenerator.h"
+
+
+const char* USAGE = R"(Usage: TableGenerator [options]
+  --preset <name>          tiny (10 bodies) | small (100) | medium (1k) | large (10k) | huge (100k) (default small)
+  --balls <n>              balls in the arena, overrides the preset
+  --bumpers <n>            bumpers in the arena, overrides the preset
+  --walls <n>              wall segments in the arena, overrides the preset
+  --fields <n>             central fields acting on the game universe, overrides the preset
+  --seed <n>               seed of the layout (default 1)
+  --no-models              don't draw the arena (physics only tables)
+  --base <path>            readable table the arena is added to (default tables/reference.table)
+  --output <path>          binary table (default tables/<preset>.tbl)
+  --text <path>            also write the readable table
+)";
+
+
+
+int main(int argc, char* argv[]) {
+	try {
+		std::string presetName = "small";
+		std::string basePath = "tables/reference.table";
+		std::string outputPath;
+		std::string textPath;
+		int balls = -1, bumpers = -1, walls = -1, fields = -1;
+		uint64_t seed = 1;
+		bool models = true;
+
+		//parse command line
+		for (int i = 1; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (option == "--help") {
+				std::cout << USAGE;
+				return 0;
+			}
+			if (option == "--no-models") {
+				models = false;
+				continue;
+			}
+			if (i + 1 >= argc) {
+				throw std::invalid_argument{ "Missing value for " + option };
+			}
+
+			const std::string value = argv[++i];
+			if (option == "--preset") presetName = value;
+			else if (option == "--balls") balls = std::stoi(value);
+			else if (option == "--bumpers") bumpers = std::stoi(value);
+			else if (option == "--walls") walls = std::stoi(value);
+			else if (option == "--fields") fields = std::stoi(value);
+			else if (option == "--seed") seed = std::stoull(value);
+			else if (option == "--base") basePath = value;
+			else if (option == "--output") outputPath = value;
+			else if (option == "--text") textPath = value;
+			else throw std::invalid_argument{ "Unknown option " + option + "\n" + USAGE };
+		}
+
+		auto settings = TableGenerator::fromPreset(presetName);
+		settings.seed = seed;
+		settings.models = models;
+		if (balls >= 0) settings.balls = balls;
+		if (bumpers >= 0) settings.bumpers = bumpers;
+		if (walls >= 0) settings.walls = walls;
+		if (fields >= 0) settings.fields = fields;
+		if (outputPath.empty()) {
+			outputPath = "tables/" + presetName + ".tbl";
+		}
+
+		auto table = TableGenerator::generate(TableCompiler::parseFile(basePath), settings);
+		TableCompiler::writeBinaryFile(outputPath, table);
+		if (!textPath.empty()) {
+			TableCompiler::writeTextFile(textPath, table);
+		}
+
+		std::cout << outputPath << ": " << settings.balls << " balls, " << settings.bumpers << " bumpers, " << settings.walls << " walls, " << settings.fields << " fields in the arena (" << table.hitboxes.size() << " hitboxes in total)\n";
+
+	} catch (const std::exception& e) {
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}
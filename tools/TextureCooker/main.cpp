@@ -0,0 +1,93 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TextureCompression.h"
+#include "TextureFile.h"
+#include "TextureFormat.h"
+
+
+const char* USAGE = R"(Usage: TextureCooker <input image>... [options]
+  --encoding <bc7|bc1|rgba8>   how the texels are stored on the GPU (default bc7); bc1 has no alpha and is half the size of bc7
+  --output <path>              where to write the cooked texture, if there is a single input (default: next to the input, e.g. textures/skybox.bc7.ktx2)
+  Builds the whole mip chain of each image, encodes it and writes it as a cooked texture (.ktx2), which TextureImage loads instead of the image, then loads it back to check it.
+)";
+
+
+
+int main(int argc, char* argv[]) {
+	if (argc < 2 || std::string{ argv[1] } == "--help") {
+		std::cout << USAGE;
+		return 1;
+	}
+
+	try {
+		std::vector<std::string> inputPaths;
+		std::string outputPath;
+		auto encoding = Vulkan::TextureFormat::Encoding::BC7;
+
+		//parse command line
+		for (int i = 1; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (option.rfind("--", 0) != 0) {
+				inputPaths.push_back(option);
+				continue;
+			}
+			if (i + 1 >= argc) {
+				throw std::invalid_argument{ "Missing value for " + option };
+			}
+
+			if (option == "--output") outputPath = argv[++i];
+			else if (option == "--encoding") {
+				const std::string value = argv[++i];
+				if (value == "bc7") encoding = Vulkan::TextureFormat::Encoding::BC7;
+				else if (value == "bc1") encoding = Vulkan::TextureFormat::Encoding::BC1;
+				else if (value == "rgba8") encoding = Vulkan::TextureFormat::Encoding::RGBA8;
+				else throw std::invalid_argument{ "Unknown encoding " + value };
+			}
+			else throw std::invalid_argument{ "Unknown option " + option + "\n" + USAGE };
+		}
+		if (inputPaths.empty()) {
+			throw std::invalid_argument{ "No input image\n" + std::string{ USAGE } };
+		}
+		if (!outputPath.empty() && inputPaths.size() > 1) {
+			throw std::invalid_argument{ "--output needs a single input image" };
+		}
+
+		for (const auto& inputPath : inputPaths) {
+			int width, height, channels;
+			stbi_uc* pixels = stbi_load(inputPath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+			if (!pixels) {
+				throw std::runtime_error{ "Failed to load image " + inputPath + ": " + stbi_failure_reason() };
+			}
+
+			const auto begin = std::chrono::steady_clock::now();
+			const auto levels = Vulkan::TextureCompression::cook(pixels, width, height, encoding);
+			const auto end = std::chrono::steady_clock::now();
+			stbi_image_free(pixels);
+
+			const auto path = outputPath.empty() ? std::filesystem::path{ inputPath }.replace_extension(Vulkan::TextureFormat::getExtension(encoding)).string() : outputPath;
+			Vulkan::TextureFile::write(path, encoding, width, height, levels);
+
+			//the same checks done when the texture is loaded
+			Vulkan::TextureFile cooked{ path };
+			uint64_t bytes = 0;
+			for (uint32_t level = 0; level < cooked.getLevelCount(); ++level) {
+				bytes += cooked.getLevelSize(level);
+			}
+			const uint64_t uncompressedBytes = uint64_t{ 4 } * width * height; //RGBA8 without mips, as the image used to be uploaded
+			std::cout << path << ": " << width << "x" << height << ", " << cooked.getLevelCount() << " levels, " << bytes << " bytes (" << std::setprecision(3) << static_cast<double>(uncompressedBytes) / bytes << "x smaller than RGBA8 without mips), cooked in "
+				<< std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms\n";
+		}
+
+	} catch (const std::exception& e) {
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}